@@ -0,0 +1,167 @@
+#pragma once
+
+#include "cinder/Cinder.h"
+
+#include "LockFreeQueue.h"
+
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+namespace MinimalUI {
+
+	class UIController;
+	class UIElement;
+
+	typedef std::shared_ptr<class AutomationRecorder> AutomationRecorderRef;
+	typedef std::shared_ptr<class AutomationPlayer> AutomationPlayerRef;
+
+	//! A single value change, timestamped in nanoseconds since the start of the recording
+	struct AutomationEvent {
+		int64_t mTime;
+		uint32_t mElementId;
+		uint8_t mChannel;
+		float mValue;
+	};
+
+	//! Records value changes to disk. record() only pushes onto a lock-free queue; encoding and file IO happen on a writer thread.
+	class AutomationRecorder {
+	public:
+		AutomationRecorder( const std::string &aPath, const size_t &aQueueSize );
+		~AutomationRecorder();
+		static AutomationRecorderRef create( const std::string &aPath, const size_t &aQueueSize = DEFAULT_QUEUE_SIZE );
+
+		//! called from the input path; never blocks or allocates. Events are dropped (and counted) if the writer falls behind.
+		void record( const uint32_t &aElementId, const uint8_t &aChannel, const float &aValue );
+
+		//! stops the writer thread and flushes everything recorded so far
+		void stop();
+
+		uint64_t getNumRecorded() const { return mNumRecorded; }
+		uint64_t getNumDropped() const { return mNumDropped; }
+
+		static size_t DEFAULT_QUEUE_SIZE;
+		static size_t DEFAULT_FLUSH_SIZE;
+
+	private:
+		// disable copy and operator=
+		AutomationRecorder( const AutomationRecorder& );
+		AutomationRecorder & operator=( const AutomationRecorder& );
+
+		void writerThread();
+		void encode( const AutomationEvent &aEvent );
+		void flush();
+
+		SpscQueue<AutomationEvent> mQueue;
+		std::chrono::steady_clock::time_point mStartTime;
+		uint64_t mNumRecorded;
+		std::atomic<uint64_t> mNumDropped;
+
+		// writer thread state
+		std::ofstream mFile;
+		std::vector<uint8_t> mBuffer;
+		std::map<uint64_t, uint32_t> mPreviousBits;
+		int64_t mPreviousTime;
+		std::thread mThread;
+		std::mutex mMutex;
+		std::condition_variable mWakeup;
+		std::atomic<bool> mRunning;
+	};
+
+	//! Streams a recording from disk and re-drives the same elements, at its own rate. Continuous values (sliders) are interpolated
+	//! on the playback thread into one slot per track, of which update() applies only the newest; discrete values (buttons) are
+	//! queued, so update() applies every one of them.
+	class AutomationPlayer {
+	public:
+		AutomationPlayer( UIController *aUIController, const std::string &aPath );
+		~AutomationPlayer();
+		static AutomationPlayerRef create( UIController *aUIController, const std::string &aPath );
+
+		void start( const double &aRate = DEFAULT_RATE );
+		void stop();
+		bool isPlaying() const { return mRunning; }
+
+		//! applies what the playback thread has produced on the calling thread, through setValue(), so handlers fire
+		void update();
+		//! the newest interpolated value of a continuous track, at the playback rate rather than the frame rate, e.g. for
+		//! SmoothingEngine::setTarget(); from any thread. Returns false if the track hasn't played yet.
+		bool getValue( const uint32_t &aElementId, const uint8_t &aChannel, float &aValue ) const;
+
+		static double DEFAULT_RATE;
+		//! the recorder only writes changes, so events further apart than this, in seconds, are a value held still and
+		//! then changed, and aren't ramped between
+		static double DEFAULT_MAX_RAMP_TIME;
+		static double DEFAULT_LOOKAHEAD;
+		static size_t DEFAULT_READ_SIZE;
+		//! continuous tracks with a slot; values of any beyond these are queued on every change, like discrete ones
+		static size_t DEFAULT_MAX_TRACKS;
+
+	private:
+		// disable copy and operator=
+		AutomationPlayer( const AutomationPlayer& );
+		AutomationPlayer & operator=( const AutomationPlayer& );
+
+		struct Track {
+			Track() : mHasLast( false ), mApplied( 0.0f ), mContinuous( false ), mElement( nullptr ), mSlot( -1 ) { }
+			std::deque<AutomationEvent> mPending;
+			AutomationEvent mLast;
+			bool mHasLast;
+			float mApplied;
+			bool mContinuous;
+			UIElement *mElement;
+			int mSlot;
+		};
+
+		//! the latest value of a continuous track, written by the playback thread and read by update() and getValue()
+		struct Slot {
+			Slot() : mElementId( 0 ), mChannel( 0 ), mBits( 0 ), mChanged( false ) { }
+			uint32_t mElementId;
+			uint8_t mChannel;
+			std::atomic<uint32_t> mBits;
+			std::atomic<bool> mChanged;
+		};
+
+		void playbackThread( const double &aRate );
+		void tick( const int64_t &aTime );
+		bool decodeNext( AutomationEvent &aEvent );
+		bool readByte( uint8_t &aByte );
+		bool readVarint( uint64_t &aValue );
+
+		UIController *mParent;
+		std::ifstream mFile;
+		std::vector<uint8_t> mReadBuffer;
+		size_t mReadPosition, mReadSize;
+		bool mEndOfFile;
+		int64_t mDecodedTime;
+		std::map<uint64_t, uint32_t> mPreviousBits;
+		std::map<uint64_t, Track> mTracks;
+
+		SpscQueue<AutomationEvent> mEvents;
+		//! allocated once and filled in order, so the playback thread never moves a slot another thread is reading
+		std::vector<Slot> mSlots;
+		std::atomic<size_t> mNumSlots;
+		std::thread mThread;
+		std::atomic<bool> mRunning;
+	};
+
+	//! Exception for automation files that can't be opened or aren't recordings
+	class AutomationExc : public ci::Exception {
+	public:
+		AutomationExc( const std::string &aPath ) { snprintf( mMessage, sizeof( mMessage ), "Can't open automation file: %s", aPath.c_str() ); }
+
+		virtual const char * what() const throw() { return mMessage; }
+
+		char mMessage[4096];
+	};
+
+}
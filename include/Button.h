@@ -7,18 +7,29 @@ namespace MinimalUI {
 	
 	class Button : public UIElement {
 	public:
-		Button( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, const std::string &aParamString );
-		static UIElementRef create( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, const std::string &aParamString );
+		Button( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, const Params &aParams );
 		
 		void draw();
 		void update();
+		ci::ColorA getFillColor() const;
 		void press();
 		void release();
 		void handleMouseUp( const ci::Vec2i &aMousePos );
+		//! a non-zero value clicks the button
+		void handleExternalValue( const int &aChannel, const float &aValue ) { if ( aValue != 0.0f ) handleMouseUp( ci::Vec2i::zero() ); }
 		void addEventHandler( const std::function<void( bool )>& aEventHandler );
 		void callEventHandlers();
 		
 		void setPressed( const bool &aPressed ) { mPressed = aPressed; }
+		bool isPressed() const { return mPressed; }
+		//! only while it's idle; a pressed or held button is drawn on every refresh
+		bool isStatic() const { return mStatic && !mPressed && !isActive(); }
+		
+		// a stateless button reports 0 and treats any non-zero value as a click
+		int getNumValues() const { return 1; }
+		float getValue( const int &aChannel ) const { return mPressed ? 1.0f : 0.0f; }
+		void setValue( const int &aChannel, const float &aValue );
 		
 	private:
 		std::vector< std::function<void( bool )> > mEventHandlers;
@@ -34,8 +45,8 @@ namespace MinimalUI {
 	
 	class LinkedButton : public Button {
 	public:
-		LinkedButton( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const std::string &aParamString );
-		static UIElementRef create( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const std::string &aParamString );
+		LinkedButton( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const Params &aParams );
 		
 		void update();
 	private:
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "LockFreeQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class ExternalInput> ExternalInputRef;
+	typedef std::shared_ptr<class VirtualInputDevice> VirtualInputDeviceRef;
+
+	//! A value from a hardware controller, for one channel of an element. Values are normalized: 0 to 1 across a
+	//! slider's range, and non-zero for a pressed button.
+	struct ExternalInputEvent {
+		uint32_t mElementId;
+		uint8_t mChannel;
+		float mValue;
+	};
+
+	//! Where device threads send values for a panel's elements. push() never blocks or allocates; the controller drains
+	//! the queue at the start of its update(), keeps only the latest value per slider channel, and applies them through
+	//! the elements like mouse input, so they're recorded, undoable and call the same handlers.
+	class ExternalInput {
+	public:
+		ExternalInput( const size_t &aCapacity );
+		static ExternalInputRef create( const size_t &aCapacity = DEFAULT_CAPACITY );
+
+		//! from any thread; the event is dropped (and counted) if the queue is full
+		void push( const uint32_t &aElementId, const uint8_t &aChannel, const float &aValue );
+		//! from the controller's thread only
+		bool pop( ExternalInputEvent &aEvent ) { return mQueue.pop( aEvent ); }
+
+		uint64_t getNumDropped() const { return mNumDropped; }
+
+		static size_t DEFAULT_CAPACITY;
+
+	private:
+		// disable copy and operator=
+		ExternalInput( const ExternalInput& );
+		ExternalInput & operator=( const ExternalInput& );
+
+		MpscQueue<ExternalInputEvent> mQueue;
+		std::atomic<uint64_t> mNumDropped;
+	};
+
+	//! An in-process stand-in for a hardware controller: set() pushes single values from the calling thread, and sweep()
+	//! moves a fader on a thread of its own, at a device-like rate.
+	class VirtualInputDevice {
+	public:
+		VirtualInputDevice( const ExternalInputRef &aInput );
+		~VirtualInputDevice();
+		static VirtualInputDeviceRef create( const ExternalInputRef &aInput );
+
+		void set( const uint32_t &aElementId, const uint8_t &aChannel, const float &aValue ) { mInput->push( aElementId, aChannel, aValue ); }
+		//! moves a channel from aFrom to aTo over aDuration seconds, aRate values per second; replaces any running sweep
+		void sweep( const uint32_t &aElementId, const uint8_t &aChannel, const float &aFrom, const float &aTo, const double &aDuration, const double &aRate = DEFAULT_RATE );
+		void stop();
+		bool isRunning() const { return mRunning; }
+
+		static double DEFAULT_RATE;
+
+	private:
+		// disable copy and operator=
+		VirtualInputDevice( const VirtualInputDevice& );
+		VirtualInputDevice & operator=( const VirtualInputDevice& );
+
+		ExternalInputRef mInput;
+		std::thread mThread;
+		std::atomic<bool> mRunning;
+	};
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Texture.h"
+#include "cinder/Text.h"
+
+#include <vector>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class GlyphAtlas> GlyphAtlasRef;
+
+	//! The printable ASCII characters of a font, rasterized once into a single texture, for text that changes every frame
+	//! (numeric readouts). Strings are queued as quads and drawn together in one call when the controller flushes the
+	//! atlas after its elements; nothing is allocated once the buffers have grown.
+	class GlyphAtlas {
+	public:
+		GlyphAtlas( const ci::Font &aFont );
+		static GlyphAtlasRef create( const ci::Font &aFont );
+
+		//! queues aText with its upper left corner at aPosition; aScale maps glyph pixels to screen pixels, and is 1 for
+		//! fonts from UIController::getFont(), which are already at the render scale
+		void add( const char *aText, const ci::Vec2f &aPosition, const float &aScale, const ci::ColorA &aColor );
+		//! draws everything queued since the last flush
+		void flush();
+		float measure( const char *aText, const float &aScale );
+		float getLineHeight( const float &aScale ) { build(); return mLineHeight * aScale; }
+
+		//! replaces the font, e.g. at a new render scale; the glyphs are rasterized again on next use
+		void setFont( const ci::Font &aFont ) { mFont = aFont; mBuilt = false; }
+
+	private:
+		struct Glyph {
+			ci::Rectf mTexCoords;
+			ci::Vec2f mSize;
+		};
+		const Glyph & getGlyph( const char &aChar ) const;
+		void build();
+
+		static const int FIRST_CHAR = 32;
+		static const int NUM_CHARS = 95;
+		ci::Font mFont;
+		bool mBuilt;
+		Glyph mGlyphs[NUM_CHARS];
+		float mLineHeight;
+		ci::Surface mSurface;
+		ci::gl::Texture mTexture;
+		std::vector<float> mVertices;
+		std::vector<float> mTexCoords;
+		std::vector<float> mColors;
+	};
+
+	//! writes aValue with aPrecision decimals and a terminating null into aBuffer (at least 32 bytes), without
+	//! allocating; returns the length
+	int formatFloat( char *aBuffer, const float &aValue, const int &aPrecision );
+
+	//! Text for up to four values at a fixed precision, with units, that is only re-formatted when the digits shown change.
+	class ValueReadout {
+	public:
+		ValueReadout() : mPrecision( 2 ), mNumValues( 0 ) { mUnits[0] = 0; mText[0] = 0; }
+
+		void setup( const int &aPrecision, const std::string &aUnits );
+		//! returns true if the text changed
+		bool update( const float *aValues, const int &aNumValues );
+		const char * getText() const { return mText; }
+
+		static const int MAX_VALUES = 4;
+
+	private:
+		int mPrecision;
+		float mScale;
+		char mUnits[16];
+		char mText[MAX_VALUES * 34 + 16];
+		int64_t mShown[MAX_VALUES];
+		int mNumValues;
+	};
+
+}
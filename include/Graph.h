@@ -8,19 +8,24 @@
 #include "UIElement.h"
 #include "UIController.h"
 
+#include <mutex>
+#include <atomic>
+#include <memory>
+
 namespace MinimalUI {
 
 	class MovingGraph : public UIElement {
 	public:
-		MovingGraph(UIController *aUIController, const std::string &aName, float *aValueToLink, const std::string &aParamString);
-		MovingGraph(UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const std::string &aParamString);
+		MovingGraph(UIController *aUIController, const std::string &aName, float *aValueToLink, const Params &aParams);
+		MovingGraph(UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const Params &aParams);
 
-		static UIElementRef create(UIController *aUIController, const std::string &aName, float *aValueToLink, const std::string &aParamString);
-		static UIElementRef create(UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const std::string &aParamString);
+		static UIElementRef create(UIController *aUIController, const std::string &aName, float *aValueToLink, const Params &aParams);
+		static UIElementRef create(UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const Params &aParams);
 
 		void init();
 		void draw();
 		void update();
+		ci::ColorA getFillColor() const;
 		void press();
 		void release();
 		void handleMouseUp(const ci::Vec2i &aMousePos);
@@ -28,8 +33,17 @@ namespace MinimalUI {
 		void callEventHandlers();
 
 		void setPressed(const bool &aPressed) { mPressed = aPressed; }
+		bool isPressed() const { return mPressed; }
+
+		uint64_t getSampleCount() const { return mSampleCount; }
+		void getSamples( std::vector<float> &aSamples ) const { aSamples = mBuffer; }
+		int getSampleCapacity() const { return mBufferSize - 1; }
+		//! replaces what the graph shows, e.g. with a replica's samples
+		void setSamples( const std::vector<float> &aSamples );
 
 	protected:
+		void boundsChanged();
+
 		float mMin;
 		float mMax;
 		int mScreenMin;
@@ -37,6 +51,7 @@ namespace MinimalUI {
 		float *mLinkedValue;
 		std::vector<float> mBuffer;
 		int mBufferSize;
+		uint64_t mSampleCount;
 		ci::Shape2d mShape;
 		float mScale, mInc;
 
@@ -51,4 +66,175 @@ namespace MinimalUI {
 		bool mContinuous;
 	};
 
-}
\ No newline at end of file
+
+	//! Many series in one plot. Each series keeps a ring of raw samples plus per-column min/max buckets that are updated as
+	//! samples arrive, so drawing and autoscaling never rescan the raw samples. All series share the same x-axis decimation.
+	class MultiGraph : public UIElement {
+	public:
+		MultiGraph( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
+
+		void draw();
+		void update();
+		ci::ColorA getFillColor() const { return getBackgroundColor(); }
+
+		//! returns the index of the new series
+		int addSeries( const ci::ColorA &aColor );
+		int getNumSeries() const { return mSeries.size(); }
+
+		//! appends samples to a series; safe to call from any thread
+		void push( const int &aSeries, const float *aValues, const size_t &aCount );
+		void push( const int &aSeries, const float &aValue ) { push( aSeries, &aValue, 1 ); }
+
+		//! current y range: min and max where given, otherwise the extent of everything on screen
+		float getMin() const { return mMin; }
+		float getMax() const { return mMax; }
+
+	protected:
+		void boundsChanged();
+
+	private:
+		//! min or max over the most recent buckets, maintained with a monotonic queue in a fixed ring
+		struct SlidingExtremum {
+			void reset( const size_t &aCapacity, const bool &aMax ) { mIndices.assign( aCapacity, 0 ); mValues.assign( aCapacity, 0.0f ); mHead = mTail = 0; mMax = aMax; }
+			void push( const uint64_t &aIndex, const float &aValue, const uint64_t &aWindow );
+			bool empty() const { return mHead == mTail; }
+			float front() const { return mValues[mHead % mValues.size()]; }
+
+			std::vector<uint64_t> mIndices;
+			std::vector<float> mValues;
+			uint64_t mHead, mTail;
+			bool mMax;
+		};
+
+		struct Series {
+			ci::ColorA mColor;
+			// raw samples
+			std::vector<float> mSamples;
+			uint64_t mNumSamples;
+			// completed buckets
+			std::vector<float> mBucketMin, mBucketMax;
+			uint64_t mNumBuckets;
+			// the bucket being filled
+			float mPartialMin, mPartialMax;
+			int mPartialCount;
+			SlidingExtremum mWindowMin, mWindowMax;
+		};
+
+		void resetBuckets( Series &aSeries );
+		void addToBucket( Series &aSeries, const float &aValue );
+
+		std::vector<Series> mSeries;
+		std::mutex mMutex;
+		size_t mCapacity;
+		int mColumns;
+		int mBucketSize;
+		bool mAutoscaleMin, mAutoscaleMax;
+		float mMin, mMax;
+
+		// geometry for every series, drawn with a single glMultiDrawArrays
+		std::vector<float> mVertices;
+		std::vector<float> mColors;
+		std::vector<GLint> mFirsts;
+		std::vector<GLsizei> mCounts;
+
+		static int DEFAULT_HEIGHT;
+		static int DEFAULT_WIDTH;
+		static int DEFAULT_CAPACITY;
+	};
+
+
+	//! Distribution of a high-rate stream. Samples are binned as they arrive (fixed or log-spaced bins) and only the bin
+	//! counts are kept: either accumulated with exponential decay ("decay") or summed over the last "window" updates.
+	class Histogram : public UIElement {
+	public:
+		Histogram( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
+
+		void draw();
+		void update();
+		ci::ColorA getFillColor() const { return getBackgroundColor(); }
+
+		//! bins a batch of samples; safe to call from any thread, and doesn't allocate
+		void push( const float *aValues, const size_t &aCount );
+		void push( const float &aValue ) { push( &aValue, 1 ); }
+
+		int getNumBins() const { return mNumBins; }
+		float getBin( const int &aBin ) const { return mBins[aBin]; }
+
+		//! fixed at compile time: push() bins into a buffer of this many bins on the stack
+		static const int MAX_BINS = 256;
+
+	private:
+		void binLinear( const float *aValues, const size_t &aCount, uint32_t *aCounts ) const;
+		void binLog( const float *aValues, const size_t &aCount, uint32_t *aCounts ) const;
+
+		int mNumBins;
+		float mMin, mMax;
+		bool mLog;
+		float mDecay;
+		int mWindow;
+
+		// counts pushed since the last update
+		std::unique_ptr<std::atomic<uint32_t>[]> mPending;
+		// accumulated counts, and for window mode the per-update counts that fall out of it
+		std::vector<float> mBins;
+		std::vector<uint32_t> mHistory;
+		int mHistoryIndex;
+		float mPeak;
+
+		std::vector<float> mVertices;
+
+		static int DEFAULT_HEIGHT;
+		static int DEFAULT_WIDTH;
+	};
+
+
+	//! Read-only XY view of a point set that stays owned by the caller. Up to one point per pixel is drawn as points;
+	//! beyond that, the points are binned into a per-pixel density image in parallel.
+	class ScatterPlot : public UIElement {
+	public:
+		ScatterPlot( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
+
+		void draw();
+		void update();
+		void upload();
+		ci::ColorA getFillColor() const { return getBackgroundColor(); }
+		void releaseResources();
+
+		//! aX and aY point at the first point's coordinates, and successive points are aStride bytes apart, so an array of
+		//! structs can be viewed in place. The data is read on every update, and must stay valid until it's replaced or cleared.
+		void setPoints( const float *aX, const float *aY, const size_t &aCount, const size_t &aStride );
+		//! interleaved x, y pairs
+		void setPoints( const ci::Vec2f *aPoints, const size_t &aCount ) { setPoints( &aPoints->x, &aPoints->y, aCount, sizeof( ci::Vec2f ) ); }
+		void clearPoints() { setPoints( nullptr, nullptr, 0, 0 ); }
+
+		//! true when the last update fell back to density binning
+		bool isBinned() const { return mBinned; }
+
+	private:
+		void updatePoints();
+		void updateDensity();
+
+		const float *mX, *mY;
+		size_t mCount;
+		size_t mStride;
+		float mMinX, mMaxX, mMinY, mMaxY;
+		float mPointSize;
+		bool mBinned;
+
+		// points mode
+		std::vector<float> mVertices;
+
+		// density mode: bins per worker, merged into the first
+		std::vector< std::vector<uint32_t> > mBins;
+		std::vector<uint32_t> mPixels;
+		ci::gl::Texture mDensityTexture;
+		int mBinsWidth, mBinsHeight;
+		bool mPixelsChanged;
+
+		static int DEFAULT_SIZE;
+	};
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Texture.h"
+
+#include "UIElement.h"
+#include "UIController.h"
+
+#include <mutex>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	//! Colormapped view of a 2D float grid. Grids larger than the element are box-filtered down to a preview that fits
+	//! its bounds, and only the 64x64 tiles of the preview that changed are re-colored and uploaded.
+	class Heatmap : public UIElement {
+	public:
+		Heatmap( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
+
+		void draw();
+		void update();
+		void upload();
+		ci::ColorA getFillColor() const { return getBackgroundColor(); }
+		void releaseResources();
+
+		//! replaces the whole grid (row-major, aWidth x aHeight); safe to call from any thread
+		void setData( const float *aData, const int &aWidth, const int &aHeight );
+		//! as above, but only the values inside aChanged differ from the previous call
+		void setData( const float *aData, const int &aWidth, const int &aHeight, const ci::Area &aChanged );
+
+		//! values outside the range are clamped to the ends of the colormap
+		void setRange( const float &aMin, const float &aMax );
+
+		static int TILE_SIZE;
+		static int MAX_GRID_SIZE;
+
+	private:
+		void buildColormap( const std::string &aName );
+		void colormapRow( const float *aValues, uint32_t *aPixels, const int &aCount ) const;
+
+		std::mutex mMutex;
+		// held by setData() while it filters, so mMutex is only held to swap the result in
+		std::mutex mDataMutex;
+		float mMin, mMax;
+		uint32_t mColormap[256];
+
+		// source grid and the preview it's filtered down to
+		int mGridWidth, mGridHeight;
+		int mPreviewWidth, mPreviewHeight;
+		std::vector<float> mPreview;
+		//! the changed texels, filtered by setData() before they're copied or swapped into mPreview
+		std::vector<float> mScratch;
+		std::vector<uint32_t> mPixels;
+
+		// tiles of the preview waiting to be colored in update(), then uploaded in upload()
+		enum { TILE_CLEAN, TILE_CHANGED, TILE_COLORED };
+		int mTilesX, mTilesY;
+		std::vector<uint8_t> mDirtyTiles;
+		bool mDirty;
+		bool mColored;
+		bool mResized;
+
+		ci::gl::Texture mTexture;
+
+		static int DEFAULT_SIZE;
+	};
+
+}
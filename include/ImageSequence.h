@@ -0,0 +1,74 @@
+#pragma once
+
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Texture.h"
+
+#include "UIElement.h"
+#include "UIController.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	//! Plays a sequence of image files at a fixed rate. Frames are decoded ahead on the shared WorkerPool, downscaled to
+	//! the element's size as they decode, into a fixed pool of buffers; uploads alternate between two textures.
+	class ImageSequence : public UIElement {
+	public:
+		ImageSequence( UIController *aUIController, const std::string &aName, const std::vector<std::string> &aPaths, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const std::vector<std::string> &aPaths, const Params &aParams );
+
+		void draw();
+		void update();
+		void upload();
+		ci::ColorA getFillColor() const { return getBackgroundColor(); }
+		void releaseResources();
+
+		void play();
+		void pause();
+		bool isPlaying() const { return mPlaying; }
+
+		//! frames whose time came and went before they were decoded
+		uint64_t getDroppedFrames() const { return mDroppedFrames; }
+		uint64_t getShownFrames() const { return mShownFrames; }
+
+		// decoded frames, shared with the decode tasks so they can outlive the element
+		struct Frame {
+			enum State { FREE, DECODING, READY, FAILED };
+			std::atomic<int> mState;
+			int64_t mIndex;
+			std::vector<uint8_t> mPixels;
+			// scratch space for the streaming downscale, reused from frame to frame
+			std::vector<uint8_t> mRow;
+			std::vector<uint32_t> mSums;
+		};
+		struct Pool {
+			std::vector<std::string> mPaths;
+			int mWidth, mHeight;
+			std::vector< std::unique_ptr<Frame> > mFrames;
+		};
+
+	private:
+		int64_t getFrameAtTime( const double &aTime ) const;
+		void schedule( const int64_t &aFirst );
+
+		std::shared_ptr<Pool> mPool;
+		double mFrameRate;
+		bool mLoop;
+		int mPrefetch;
+
+		bool mPlaying;
+		double mStartTime, mPausedAt;
+		int64_t mShownIndex;
+		uint64_t mDroppedFrames, mShownFrames;
+
+		ci::gl::Texture mTextures[2];
+		int mCurrentTexture;
+		bool mHasFrame;
+		// the frame update() picked to show, held until upload() has copied it
+		Frame *mUploadFrame;
+
+		static int DEFAULT_WIDTH;
+	};
+
+}
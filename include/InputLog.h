@@ -0,0 +1,139 @@
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Vector.h"
+
+#include "PercentileSketch.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+#include <cstdio>
+
+namespace MinimalUI {
+
+	class UIController;
+
+	typedef std::shared_ptr<class InputCapture> InputCaptureRef;
+
+	//! Records the raw mouse input a panel receives, and the start of every update, so an operator's session can be
+	//! replayed against the same panel definition. Unlike automation, which records the values that changed, this
+	//! records what caused them, so a replay runs the element code again. Mouse input is rare enough that encoding
+	//! happens on the main thread, into a buffer written out in large blocks.
+	class InputCapture {
+	public:
+		InputCapture( UIController *aUIController, const std::string &aPath );
+		~InputCapture();
+		static InputCaptureRef create( UIController *aUIController, const std::string &aPath );
+
+		void frame();
+		void mouseDown( const ci::Vec2i &aPos, const bool &aRight );
+		void mouseUp( const ci::Vec2i &aPos );
+		void mouseDrag( const ci::Vec2i &aPos );
+
+		//! writes the final values, to check replays against, and closes the file
+		void stop();
+
+		uint64_t getNumEvents() const { return mNumEvents; }
+
+		static size_t DEFAULT_FLUSH_SIZE;
+
+	private:
+		// disable copy and operator=
+		InputCapture( const InputCapture& );
+		InputCapture & operator=( const InputCapture& );
+
+		void beginRecord( const uint8_t &aType );
+		void writePosition( const ci::Vec2i &aPos );
+		void writeValues();
+		void flush();
+
+		UIController *mParent;
+		std::ofstream mFile;
+		std::vector<uint8_t> mBuffer;
+		std::chrono::steady_clock::time_point mStartTime;
+		int64_t mPreviousTime;
+		uint64_t mNumEvents;
+		bool mStopped;
+	};
+
+	//! Replays an input capture headlessly: the recorded mouse events go through the panel's handlers and each recorded
+	//! frame runs its update(), at the recorded pace or as fast as possible. Nothing is drawn. Use it through
+	//! UIController::replayInput(), which also counts the value changes.
+	class InputReplayer {
+	public:
+		enum EventType { MOUSE_DOWN, MOUSE_UP, MOUSE_DRAG, NUM_EVENT_TYPES };
+
+		struct Divergence {
+			uint32_t mElementId;
+			uint8_t mChannel;
+			float mRecorded, mReplayed;
+		};
+
+		struct Report {
+			uint64_t mNumEvents;
+			uint64_t mNumFrames;
+			//! time spent in the panel's handlers per event, by EventType, and in each update(), in microseconds
+			PercentileSketch mEventLatency[NUM_EVENT_TYPES];
+			PercentileSketch mFrameLatency;
+			//! value change notifications (what drives automation, undo and the bridge) per element id
+			std::vector<uint64_t> mCallbackCounts;
+			//! bound values that ended up different from the recording
+			std::vector<Divergence> mDivergences;
+			//! false if the panel doesn't have the number of elements the recording was made with
+			bool mPanelMatches;
+			//! false if the capture was never stopped, so there were no final values to check
+			bool mComplete;
+			//! wall time of the replay, in seconds
+			double mDuration;
+
+			bool passed() const { return mPanelMatches && mComplete && mDivergences.empty(); }
+			std::string toString() const;
+		};
+
+		InputReplayer( UIController *aUIController, const std::string &aPath );
+
+		//! replays the whole capture on the calling thread; aSpeed 1 is the recorded pace, 0 as fast as possible
+		Report run( const double &aSpeed = AS_FAST_AS_POSSIBLE );
+
+		//! called by the controller for each value change notification while a replay runs
+		void valueChanged( const uint32_t &aElementId );
+
+		static const double AS_FAST_AS_POSSIBLE;
+		//! relative difference allowed between a recorded and a replayed value
+		static float DEFAULT_TOLERANCE;
+
+	private:
+		// disable copy and operator=
+		InputReplayer( const InputReplayer& );
+		InputReplayer & operator=( const InputReplayer& );
+
+		struct Value {
+			uint32_t mElementId;
+			uint8_t mChannel;
+			float mValue;
+		};
+		bool readValues( size_t &aPosition, std::vector<Value> &aValues ) const;
+
+		UIController *mParent;
+		std::vector<uint8_t> mData;
+		size_t mHeaderSize;
+		uint32_t mNumElements;
+		std::vector<Value> mInitialValues;
+		Report *mReport;
+	};
+
+	//! Exception for input captures that can't be opened or aren't captures
+	class InputLogExc : public ci::Exception {
+	public:
+		InputLogExc( const std::string &aPath ) { snprintf( mMessage, sizeof( mMessage ), "Can't open input capture: %s", aPath.c_str() ); }
+
+		virtual const char * what() const throw() { return mMessage; }
+
+		char mMessage[4096];
+	};
+
+}
@@ -7,8 +7,8 @@ namespace MinimalUI {
 	
 	class Label : public UIElement {
 	public:
-		Label( UIController *aUIController, const std::string &aName, const std::string &aParamString );
-		static UIElementRef create( UIController *aUIController, const std::string &aName, const std::string &aParamString );
+		Label( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
 		void draw();
 		void update() { }
 		void setPositionAndBounds();
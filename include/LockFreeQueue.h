@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <memory>
+
+namespace MinimalUI {
+
+	//! Bounded single-producer / single-consumer queue. push() and pop() never block or allocate.
+	template <typename T>
+	class SpscQueue {
+	public:
+		//! capacity is rounded up to a power of two
+		explicit SpscQueue( size_t aCapacity )
+			: mHead( 0 ), mTail( 0 )
+		{
+			size_t capacity = 2;
+			while ( capacity < aCapacity ) capacity <<= 1;
+			mSlots.resize( capacity );
+			mMask = capacity - 1;
+		}
+
+		//! returns false if the queue is full
+		bool push( const T &aValue )
+		{
+			const size_t head = mHead.load( std::memory_order_relaxed );
+			if ( head - mTail.load( std::memory_order_acquire ) > mMask ) return false;
+			mSlots[head & mMask] = aValue;
+			mHead.store( head + 1, std::memory_order_release );
+			return true;
+		}
+
+		//! returns false if the queue is empty
+		bool pop( T &aValue )
+		{
+			const size_t tail = mTail.load( std::memory_order_relaxed );
+			if ( tail == mHead.load( std::memory_order_acquire ) ) return false;
+			aValue = mSlots[tail & mMask];
+			mTail.store( tail + 1, std::memory_order_release );
+			return true;
+		}
+
+		bool empty() const { return mTail.load( std::memory_order_acquire ) == mHead.load( std::memory_order_acquire ); }
+		size_t capacity() const { return mMask + 1; }
+
+	private:
+		// disable copy and operator=
+		SpscQueue( const SpscQueue& );
+		SpscQueue & operator=( const SpscQueue& );
+
+		std::vector<T> mSlots;
+		size_t mMask;
+		// keep the producer and consumer indices on separate cache lines
+		std::atomic<size_t> mHead;
+		char mPadding[64 - sizeof( std::atomic<size_t> )];
+		std::atomic<size_t> mTail;
+	};
+
+	//! Bounded multi-producer / single-consumer queue (Vyukov's bounded queue, with a plain consumer index). push() may
+	//! be called from any number of threads; neither push() nor pop() blocks or allocates.
+	template <typename T>
+	class MpscQueue {
+	public:
+		//! capacity is rounded up to a power of two
+		explicit MpscQueue( size_t aCapacity )
+			: mHead( 0 ), mTail( 0 )
+		{
+			size_t capacity = 2;
+			while ( capacity < aCapacity ) capacity <<= 1;
+			mCells.reset( new Cell[capacity] );
+			for ( size_t i = 0; i < capacity; i++ ) mCells[i].mSequence.store( i, std::memory_order_relaxed );
+			mMask = capacity - 1;
+		}
+
+		//! returns false if the queue is full
+		bool push( const T &aValue )
+		{
+			// claim a cell whose sequence says it's free for this lap, then publish it by advancing its sequence
+			size_t head = mHead.load( std::memory_order_relaxed );
+			Cell *cell;
+			for ( ;; ) {
+				cell = &mCells[head & mMask];
+				const size_t sequence = cell->mSequence.load( std::memory_order_acquire );
+				const ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)head;
+				if ( difference == 0 ) {
+					if ( mHead.compare_exchange_weak( head, head + 1, std::memory_order_relaxed ) ) break;
+				} else if ( difference < 0 ) {
+					return false;
+				} else {
+					head = mHead.load( std::memory_order_relaxed );
+				}
+			}
+			cell->mValue = aValue;
+			cell->mSequence.store( head + 1, std::memory_order_release );
+			return true;
+		}
+
+		//! returns false if the queue is empty, or the oldest push hasn't finished; only one thread may pop
+		bool pop( T &aValue )
+		{
+			Cell &cell = mCells[mTail & mMask];
+			if ( cell.mSequence.load( std::memory_order_acquire ) != mTail + 1 ) return false;
+			aValue = cell.mValue;
+			cell.mSequence.store( mTail + mMask + 1, std::memory_order_release );
+			mTail++;
+			return true;
+		}
+
+		size_t capacity() const { return mMask + 1; }
+
+	private:
+		// disable copy and operator=
+		MpscQueue( const MpscQueue& );
+		MpscQueue & operator=( const MpscQueue& );
+
+		struct Cell {
+			std::atomic<size_t> mSequence;
+			T mValue;
+		};
+		std::unique_ptr<Cell[]> mCells;
+		size_t mMask;
+		// producers contend on the head; keep it off the consumer's cache line
+		std::atomic<size_t> mHead;
+		char mPadding[64 - sizeof( std::atomic<size_t> )];
+		size_t mTail;
+	};
+
+}
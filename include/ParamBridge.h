@@ -0,0 +1,104 @@
+#pragma once
+
+#include "SharedMemory.h"
+
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Publishes a panel's bound values into shared memory so that another process (e.g. a renderer) can read them without
+// talking to the UI process. This header and ParamBridgeClient.cpp don't depend on Cinder, so the client side can be
+// built into any process.
+
+namespace MinimalUI {
+
+	class UIController;
+
+	typedef std::shared_ptr<class ParamBridge> ParamBridgeRef;
+	typedef std::shared_ptr<class ParamBridgeClient> ParamBridgeClientRef;
+
+	// shared segment layout: header, slots, then the change queue
+	struct ParamBridgeHeader {
+		uint32_t mMagic;
+		uint32_t mVersion;
+		uint32_t mMaxSlots;
+		uint32_t mQueueSize;
+		std::atomic<uint32_t> mNumSlots;
+		//! set by the writer when the change queue overflows; the reader should rescan every slot
+		std::atomic<uint32_t> mOverflow;
+		char mPadding0[40];
+		std::atomic<uint32_t> mQueueHead;
+		char mPadding1[60];
+		std::atomic<uint32_t> mQueueTail;
+		char mPadding2[60];
+	};
+
+	//! one bound element, guarded by a seqlock: the sequence is odd while the writer is updating the values
+	struct ParamBridgeSlot {
+		std::atomic<uint32_t> mSequence;
+		uint32_t mElementId;
+		uint32_t mNumValues;
+		char mName[52];
+		std::atomic<uint32_t> mValueBits[4];
+		char mPadding[48];
+	};
+
+	static const uint32_t PARAM_BRIDGE_MAGIC = 0x4D554942; // "MUIB"
+	static const uint32_t PARAM_BRIDGE_VERSION = 1;
+	static const uint32_t PARAM_BRIDGE_MAX_VALUES = 4;
+
+	//! UI side: owns the segment and republishes every bound value that changed, once per update
+	class ParamBridge {
+	public:
+		ParamBridge( UIController *aUIController, const SharedMemoryRef &aMemory, const uint32_t &aMaxSlots, const uint32_t &aQueueSize );
+		static ParamBridgeRef create( UIController *aUIController, const std::string &aName, const uint32_t &aMaxSlots = DEFAULT_MAX_SLOTS, const uint32_t &aQueueSize = DEFAULT_QUEUE_SIZE );
+
+		void publish();
+
+		static uint32_t DEFAULT_MAX_SLOTS;
+		static uint32_t DEFAULT_QUEUE_SIZE;
+
+	private:
+		void notify( const uint32_t &aSlot );
+
+		UIController *mParent;
+		SharedMemoryRef mMemory;
+		ParamBridgeHeader *mHeader;
+		ParamBridgeSlot *mSlots;
+		std::atomic<uint32_t> *mQueue;
+		// last published values, per slot, so unchanged values cost one compare
+		std::vector<float> mPublished;
+		std::vector<int> mSlotElements;
+	};
+
+	//! Render side: maps the segment and reads values without locks or system calls
+	class ParamBridgeClient {
+	public:
+		static ParamBridgeClientRef open( const std::string &aName );
+
+		//! drains the change queue; returns the slots that changed since the last poll (all of them after an overflow)
+		const std::vector<uint32_t> & poll();
+
+		//! slot of the element with the given name, or -1; slots are stable once published, so look them up once
+		int findSlot( const std::string &aName ) const;
+		int getNumSlots() const { return std::min( mHeader->mNumSlots.load( std::memory_order_acquire ), mHeader->mMaxSlots ); }
+		std::string getSlotName( const int &aSlot ) const { return mSlots[aSlot].mName; }
+
+		//! consistent snapshot of a slot's values; returns the number of values copied
+		int getValues( const int &aSlot, float *aValues ) const;
+		float getValue( const int &aSlot, const int &aChannel = 0 ) const;
+
+	private:
+		explicit ParamBridgeClient( const SharedMemoryRef &aMemory );
+
+		SharedMemoryRef mMemory;
+		ParamBridgeHeader *mHeader;
+		ParamBridgeSlot *mSlots;
+		std::atomic<uint32_t> *mQueue;
+		std::vector<uint32_t> mChanged;
+		std::vector<bool> mSeen;
+	};
+
+}
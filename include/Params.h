@@ -0,0 +1,259 @@
+#pragma once
+
+#include "cinder/Color.h"
+
+#include <string>
+#include <map>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	class ParamSet;
+
+	//! The options an element was created with, read through UIElement::hasParam() and getParam<T>(). Filled once,
+	//! either by parsing the JSON string API or straight from one of the typed builders below.
+	class Params {
+	public:
+		Params() { }
+		//! the compatibility layer for the string API: parses a JSON object such as "{ \"min\": -2.0, \"max\": 2.0 }"
+		Params( const std::string &aJson );
+		Params( const char *aJson );
+		explicit Params( const ParamSet &aParamSet );
+
+		bool has( const std::string &aName ) const { return mValues.find( aName ) != mValues.end(); }
+		//! numbers convert to any arithmetic type; a missing name reads as 0, false or ""
+		template <class T>
+		T get( const std::string &aName ) const { T value = T(); read( aName, value ); return value; }
+		//! a color given as a builder's 0xAARRGGBB, or as a hex string, since JSON doesn't support hex literals
+		ci::ColorA getColor( const std::string &aName ) const;
+
+		void set( const std::string &aName, const bool &aValue );
+		void set( const std::string &aName, const double &aValue );
+		void set( const std::string &aName, const std::string &aValue );
+		void erase( const std::string &aName ) { mValues.erase( aName ); }
+
+		//! the options in the form the string API takes, e.g. to recreate the element elsewhere
+		std::string toJson() const;
+
+	private:
+		struct Value {
+			bool mIsString;
+			double mNumber;
+			std::string mString;
+		};
+
+		void read( const std::string &aName, std::string &aValue ) const;
+		template <class T>
+		void read( const std::string &aName, T &aValue ) const
+		{
+			std::map<std::string, Value>::const_iterator it = mValues.find( aName );
+			if ( it != mValues.end() ) aValue = static_cast<T>( it->second.mNumber );
+		}
+
+		std::map<std::string, Value> mValues;
+	};
+
+	//! Storage for the typed builders: a fixed slot per known option, so a builder is a plain value that never allocates.
+	//! Converted to Params when the element is created, without any parsing. Valid C++11, like the rest of the block.
+	//! String options are copied into the builder, so a temporary's c_str() is fine; one that doesn't fit in the
+	//! remaining MAX_TEXT bytes is kept by pointer instead and must outlive the builder.
+	class ParamSet {
+	public:
+		enum Key {
+			// common to all elements
+			GROUP, ICON, LOCKED, CLEAR, NAME_COLOR, BACKGROUND_COLOR, JUSTIFICATION, STYLE, BACKGROUND_IMAGE, CACHED,
+			WIDTH, HEIGHT,
+			// element specific
+			MIN, MAX, MIN_X, MAX_X, MIN_Y, MAX_Y, FOREGROUND_COLOR, HANDLE_VISIBLE, VERTICAL, READOUT, PRECISION, UNITS,
+			PRESSED, STATELESS, EXCLUSIVE, CALLBACK_ON_RELEASE, CONTINUOUS, NARROW, DENSITY, FPS, AUTOPLAY, LOOP,
+			PREFETCH, CAPACITY, BINS, LOG, DECAY, WINDOW, POINT_SIZE, REFRESH, GRAPH_MAX, COLORMAP, COLLAPSED,
+			NUM_KEYS
+		};
+
+		static const int MAX_TEXT = 256;
+
+		constexpr ParamSet() : mValues(), mSet( 0 ), mText(), mTextSize( 0 ) { }
+
+		constexpr bool has( const Key &aKey ) const { return ( mSet >> aKey ) & 1; }
+		constexpr double getNumber( const Key &aKey ) const { return mValues[aKey].mNumber; }
+		constexpr const char * getString( const Key &aKey ) const { return mValues[aKey].mText >= 0 ? mText + mValues[aKey].mText : mValues[aKey].mString; }
+
+		//! the option's name in the JSON string API
+		static const char * getName( const Key &aKey );
+
+	protected:
+		struct Value {
+			bool mIsBool;
+			double mNumber;
+			const char *mString;
+			//! offset of the copy in mText, or -1 when the option isn't a string or is kept by pointer
+			int mText;
+		};
+
+		void set( const Key &aKey, const bool &aValue ) { Value value = { true, aValue ? 1.0 : 0.0, nullptr, -1 }; store( aKey, value ); }
+		void set( const Key &aKey, const double &aValue ) { Value value = { false, aValue, nullptr, -1 }; store( aKey, value ); }
+		void set( const Key &aKey, const char *aValue );
+
+	private:
+		void store( const Key &aKey, const Value &aValue ) { mValues[aKey] = aValue; mSet |= uint64_t( 1 ) << aKey; }
+
+		friend class Params;
+
+		Value mValues[NUM_KEYS];
+		uint64_t mSet;
+		char mText[MAX_TEXT];
+		int mTextSize;
+	};
+
+	//! The options every element takes. Each builder only has setters for the options its element reads, so a
+	//! misspelled or unsupported option doesn't compile. Colors are 0xAARRGGBB.
+	template <class Derived>
+	class ElementParams : public ParamSet {
+	public:
+		Derived & group( const char *aGroup ) { set( GROUP, aGroup ); return self(); }
+		Derived & icon( const bool &aIcon ) { set( ICON, aIcon ); return self(); }
+		Derived & locked( const bool &aLocked ) { set( LOCKED, aLocked ); return self(); }
+		Derived & clear( const bool &aClear ) { set( CLEAR, aClear ); return self(); }
+		Derived & nameColor( const uint32_t &aColor ) { set( NAME_COLOR, (double)aColor ); return self(); }
+		Derived & backgroundColor( const uint32_t &aColor ) { set( BACKGROUND_COLOR, (double)aColor ); return self(); }
+		//! "left", "center" or "right"
+		Derived & justification( const char *aJustification ) { set( JUSTIFICATION, aJustification ); return self(); }
+		Derived & style( const char *aStyle ) { set( STYLE, aStyle ); return self(); }
+		Derived & backgroundImage( const char *aPath ) { set( BACKGROUND_IMAGE, aPath ); return self(); }
+		//! true to draw the element into the panel's cached layer, false to draw it on every refresh
+		Derived & cached( const bool &aCached ) { set( CACHED, aCached ); return self(); }
+
+	protected:
+		Derived & self() { return static_cast<Derived &>( *this ); }
+	};
+
+	class SliderParams : public ElementParams<SliderParams> {
+	public:
+		SliderParams & min( const double &aMin ) { set( MIN, aMin ); return *this; }
+		SliderParams & max( const double &aMax ) { set( MAX, aMax ); return *this; }
+		SliderParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		SliderParams & foregroundColor( const uint32_t &aColor ) { set( FOREGROUND_COLOR, (double)aColor ); return *this; }
+		SliderParams & handleVisible( const bool &aVisible ) { set( HANDLE_VISIBLE, aVisible ); return *this; }
+		SliderParams & vertical( const bool &aVertical ) { set( VERTICAL, aVertical ); return *this; }
+		SliderParams & readout( const bool &aReadout ) { set( READOUT, aReadout ); return *this; }
+		SliderParams & precision( const int &aPrecision ) { set( PRECISION, (double)aPrecision ); return *this; }
+		SliderParams & units( const char *aUnits ) { set( UNITS, aUnits ); return *this; }
+	};
+
+	class Slider2DParams : public ElementParams<Slider2DParams> {
+	public:
+		Slider2DParams & minX( const double &aMin ) { set( MIN_X, aMin ); return *this; }
+		Slider2DParams & maxX( const double &aMax ) { set( MAX_X, aMax ); return *this; }
+		Slider2DParams & minY( const double &aMin ) { set( MIN_Y, aMin ); return *this; }
+		Slider2DParams & maxY( const double &aMax ) { set( MAX_Y, aMax ); return *this; }
+		Slider2DParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		Slider2DParams & readout( const bool &aReadout ) { set( READOUT, aReadout ); return *this; }
+		Slider2DParams & precision( const int &aPrecision ) { set( PRECISION, (double)aPrecision ); return *this; }
+		Slider2DParams & units( const char *aUnits ) { set( UNITS, aUnits ); return *this; }
+	};
+
+	//! the options of buttons, and of moving graphs, which can act as one
+	template <class Derived>
+	class PressableParams : public ElementParams<Derived> {
+	public:
+		Derived & pressed( const bool &aPressed ) { this->set( ParamSet::PRESSED, aPressed ); return this->self(); }
+		Derived & stateless( const bool &aStateless ) { this->set( ParamSet::STATELESS, aStateless ); return this->self(); }
+		Derived & exclusive( const bool &aExclusive ) { this->set( ParamSet::EXCLUSIVE, aExclusive ); return this->self(); }
+		Derived & callbackOnRelease( const bool &aOnRelease ) { this->set( ParamSet::CALLBACK_ON_RELEASE, aOnRelease ); return this->self(); }
+		Derived & continuous( const bool &aContinuous ) { this->set( ParamSet::CONTINUOUS, aContinuous ); return this->self(); }
+		Derived & width( const int &aWidth ) { this->set( ParamSet::WIDTH, (double)aWidth ); return this->self(); }
+		Derived & height( const int &aHeight ) { this->set( ParamSet::HEIGHT, (double)aHeight ); return this->self(); }
+	};
+
+	class ButtonParams : public PressableParams<ButtonParams> { };
+
+	class MovingGraphParams : public PressableParams<MovingGraphParams> {
+	public:
+		MovingGraphParams & min( const double &aMin ) { set( MIN, aMin ); return *this; }
+		MovingGraphParams & max( const double &aMax ) { set( MAX, aMax ); return *this; }
+	};
+
+	class LabelParams : public ElementParams<LabelParams> {
+	public:
+		LabelParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		LabelParams & narrow( const bool &aNarrow ) { set( NARROW, aNarrow ); return *this; }
+	};
+
+	class ImageParams : public ElementParams<ImageParams> {
+	public:
+		ImageParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		ImageParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+		ImageParams & density( const double &aDensity ) { set( DENSITY, aDensity ); return *this; }
+	};
+
+	class ImageSequenceParams : public ElementParams<ImageSequenceParams> {
+	public:
+		ImageSequenceParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		ImageSequenceParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+		ImageSequenceParams & fps( const double &aFps ) { set( FPS, aFps ); return *this; }
+		ImageSequenceParams & autoplay( const bool &aAutoplay ) { set( AUTOPLAY, aAutoplay ); return *this; }
+		ImageSequenceParams & loop( const bool &aLoop ) { set( LOOP, aLoop ); return *this; }
+		ImageSequenceParams & prefetch( const int &aFrames ) { set( PREFETCH, (double)aFrames ); return *this; }
+	};
+
+	class MultiGraphParams : public ElementParams<MultiGraphParams> {
+	public:
+		//! an end left unset follows the data
+		MultiGraphParams & min( const double &aMin ) { set( MIN, aMin ); return *this; }
+		MultiGraphParams & max( const double &aMax ) { set( MAX, aMax ); return *this; }
+		MultiGraphParams & capacity( const int &aCapacity ) { set( CAPACITY, (double)aCapacity ); return *this; }
+		MultiGraphParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		MultiGraphParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+	};
+
+	class HistogramParams : public ElementParams<HistogramParams> {
+	public:
+		HistogramParams & min( const double &aMin ) { set( MIN, aMin ); return *this; }
+		HistogramParams & max( const double &aMax ) { set( MAX, aMax ); return *this; }
+		HistogramParams & bins( const int &aBins ) { set( BINS, (double)aBins ); return *this; }
+		HistogramParams & log( const bool &aLog ) { set( LOG, aLog ); return *this; }
+		HistogramParams & decay( const double &aDecay ) { set( DECAY, aDecay ); return *this; }
+		HistogramParams & window( const int &aWindow ) { set( WINDOW, (double)aWindow ); return *this; }
+		HistogramParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		HistogramParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+	};
+
+	class ScatterPlotParams : public ElementParams<ScatterPlotParams> {
+	public:
+		ScatterPlotParams & minX( const double &aMin ) { set( MIN_X, aMin ); return *this; }
+		ScatterPlotParams & maxX( const double &aMax ) { set( MAX_X, aMax ); return *this; }
+		ScatterPlotParams & minY( const double &aMin ) { set( MIN_Y, aMin ); return *this; }
+		ScatterPlotParams & maxY( const double &aMax ) { set( MAX_Y, aMax ); return *this; }
+		ScatterPlotParams & pointSize( const double &aSize ) { set( POINT_SIZE, aSize ); return *this; }
+		ScatterPlotParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		ScatterPlotParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+	};
+
+	class StatsOverlayParams : public ElementParams<StatsOverlayParams> {
+	public:
+		//! seconds of frame times summarized
+		StatsOverlayParams & window( const double &aSeconds ) { set( WINDOW, aSeconds ); return *this; }
+		StatsOverlayParams & refresh( const double &aSeconds ) { set( REFRESH, aSeconds ); return *this; }
+		//! top of the frame time graph, in milliseconds
+		StatsOverlayParams & graphMax( const double &aMax ) { set( GRAPH_MAX, aMax ); return *this; }
+		StatsOverlayParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+	};
+
+	class HeatmapParams : public ElementParams<HeatmapParams> {
+	public:
+		HeatmapParams & min( const double &aMin ) { set( MIN, aMin ); return *this; }
+		HeatmapParams & max( const double &aMax ) { set( MAX, aMax ); return *this; }
+		//! "gray", "spectrum" or "heat"
+		HeatmapParams & colormap( const char *aName ) { set( COLORMAP, aName ); return *this; }
+		HeatmapParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		HeatmapParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+	};
+
+	class SectionParams : public ElementParams<SectionParams> {
+	public:
+		SectionParams & collapsed( const bool &aCollapsed ) { set( COLLAPSED, aCollapsed ); return *this; }
+		SectionParams & width( const int &aWidth ) { set( WIDTH, (double)aWidth ); return *this; }
+		SectionParams & height( const int &aHeight ) { set( HEIGHT, (double)aHeight ); return *this; }
+	};
+
+}
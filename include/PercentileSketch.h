@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace MinimalUI {
+
+	//! Streaming percentiles over positive values, in fixed memory. Samples are counted in log-spaced buckets (32 per
+	//! octave, about 2% wide) taken straight from the float's exponent and mantissa bits, so add() is a few instructions.
+	class PercentileSketch {
+	public:
+		PercentileSketch() { reset(); }
+
+		void reset()
+		{
+			memset( mCounts, 0, sizeof( mCounts ) );
+			mCount = 0;
+			mMax = 0.0f;
+		}
+
+		void add( const float &aValue )
+		{
+			if ( !( aValue == aValue ) ) return;
+			mCounts[bucketOf( aValue )]++;
+			mCount++;
+			if ( aValue > mMax ) mMax = aValue;
+		}
+
+		void merge( const PercentileSketch &aOther )
+		{
+			for ( int i = 0; i < NUM_BUCKETS; i++ ) mCounts[i] += aOther.mCounts[i];
+			mCount += aOther.mCount;
+			if ( aOther.mMax > mMax ) mMax = aOther.mMax;
+		}
+
+		uint64_t getCount() const { return mCount; }
+		float getMax() const { return mMax; }
+
+		//! the value below which aFraction (0-1) of the samples fall, to within a bucket
+		float getPercentile( const float &aFraction ) const
+		{
+			if ( mCount == 0 ) return 0.0f;
+			uint64_t rank = (uint64_t)( aFraction * ( mCount - 1 ) ) + 1;
+			uint64_t seen = 0;
+			for ( int i = 0; i < NUM_BUCKETS; i++ ) {
+				seen += mCounts[i];
+				if ( seen >= rank ) {
+					float value = bucketValue( i );
+					return value < mMax ? value : mMax;
+				}
+			}
+			return mMax;
+		}
+
+		// covers 2^-10 to 2^20; values outside the range are counted in the first or last bucket
+		static const int SUB_BUCKET_BITS = 5;
+		static const int MIN_EXPONENT = -10;
+		static const int MAX_EXPONENT = 20;
+		static const int NUM_BUCKETS = ( MAX_EXPONENT - MIN_EXPONENT ) << SUB_BUCKET_BITS;
+
+	private:
+		static const int SHIFT = 23 - SUB_BUCKET_BITS;
+		static const uint32_t FIRST = (uint32_t)( 127 + MIN_EXPONENT ) << ( 23 - SHIFT );
+
+		static int bucketOf( const float &aValue )
+		{
+			uint32_t bits;
+			memcpy( &bits, &aValue, sizeof( bits ) );
+			// negative values have the sign bit set, so they land in the last bucket unless we catch them here
+			if ( bits & 0x80000000 ) return 0;
+			uint32_t bucket = bits >> SHIFT;
+			if ( bucket < FIRST ) return 0;
+			bucket -= FIRST;
+			return bucket < (uint32_t)NUM_BUCKETS ? (int)bucket : NUM_BUCKETS - 1;
+		}
+
+		// middle of the bucket
+		static float bucketValue( const int &aBucket )
+		{
+			uint32_t bits = ( ( (uint32_t)aBucket + FIRST ) << SHIFT ) | ( 1u << ( SHIFT - 1 ) );
+			float value;
+			memcpy( &value, &bits, sizeof( value ) );
+			return value;
+		}
+
+		uint32_t mCounts[NUM_BUCKETS];
+		uint64_t mCount;
+		float mMax;
+	};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "UIController.h"
+#include "Replication.h"
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class ReplicaPanel> ReplicaPanelRef;
+
+	//! Rebuilds a replicated panel in a window of this app, and keeps it in step with the stream. Sliders, buttons and
+	//! graphs are recreated as such; anything else becomes a label with its name. The replica is for display: changes
+	//! made on it aren't sent back, and are undone by the next change that arrives.
+	class ReplicaPanel {
+	public:
+		ReplicaPanel( const ReplicaClientRef &aClient, ci::app::WindowRef aWindow );
+		static ReplicaPanelRef create( const ReplicaClientRef &aClient, ci::app::WindowRef aWindow = ci::app::App::get()->getWindow() );
+
+		//! applies what arrived since the last call, then updates the panel; call instead of the controller's update()
+		void update();
+		void draw();
+
+		//! the rebuilt panel, or an empty ref until the first snapshot arrives
+		UIControllerRef getController() const { return mController; }
+		const ReplicaClientRef & getClient() const { return mClient; }
+
+	private:
+		void rebuild();
+		void apply( const uint32_t &aId );
+
+		ReplicaClientRef mClient;
+		ci::app::WindowRef mWindow;
+		UIControllerRef mController;
+		uint32_t mNumSnapshots;
+		//! by replicated element id: the element standing in for it, if it isn't hidden, and its bound value
+		std::vector<UIElementRef> mElements;
+		std::vector<ci::Vec2f> mValues;
+		//! the hidden flags the panel was built with; elements are only added or removed by a rebuild
+		std::vector<bool> mHidden;
+	};
+
+}
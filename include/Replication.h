@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Socket.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Streams a panel's state to viewers on other machines: a snapshot of every element when a viewer connects, then one
+// message per frame with only what changed. This header and ReplicaClient.cpp don't depend on Cinder, so a viewer can
+// be built into any process; ReplicaPanel rebuilds the panel itself from a ReplicaClient.
+//
+// Each message is a 4 byte little endian length and then:
+//   byte    message type
+//   varint  frame number
+// A snapshot follows with a 4 byte magic, the version and the panel's params string, then a varint element count and
+// for each element:
+//   string  name, then params string (varint length and bytes)
+//   byte    ReplicaKind
+//   varint  zigzag bounds x1, y1, x2, y2
+//   byte    ReplicaFlags
+//   byte    value count, then the varint of each value's bits
+//   varint  sample capacity, sample count, and the number of samples sent, then the samples as in deltas
+// A delta follows with a varint count of changed elements, each with:
+//   varint  element id, as the gap from the previous changed element's id plus one
+//   byte    ReplicaChange mask, then for each bit set, in order:
+//           the varint zigzag difference of each value's bits from the last sent
+//           the ReplicaFlags byte
+//           the 4 varint zigzag bounds
+//           a varint count of new samples and how many of them follow, then the varint zigzag difference of each
+//           sample's bits from the previous one
+
+namespace MinimalUI {
+
+	class UIController;
+
+	typedef std::shared_ptr<class ReplicationServer> ReplicationServerRef;
+	typedef std::shared_ptr<class ReplicaClient> ReplicaClientRef;
+
+	static const uint32_t REPLICATION_MAGIC = 0x4D554952; // "MUIR"
+	static const uint32_t REPLICATION_VERSION = 1;
+
+	enum ReplicaMessage { REPLICA_SNAPSHOT = 1, REPLICA_DELTA = 2 };
+	//! what a viewer should build for an element, from what it exposes
+	enum ReplicaKind { REPLICA_OTHER, REPLICA_SLIDER, REPLICA_SLIDER_2D, REPLICA_BUTTON, REPLICA_GRAPH };
+	enum ReplicaFlags { REPLICA_PRESSED = 1, REPLICA_LOCKED = 2, REPLICA_HIDDEN = 4 };
+	enum ReplicaChange { REPLICA_VALUES = 1, REPLICA_FLAGS = 2, REPLICA_BOUNDS = 4, REPLICA_SAMPLES = 8 };
+
+	//! UI side: accepts viewers and sends each of them a snapshot, then one delta message per frame in which anything
+	//! changed. Sends never block the panel; a viewer that falls too far behind is sent a fresh snapshot instead.
+	class ReplicationServer {
+	public:
+		ReplicationServer( UIController *aUIController, const TcpSocketRef &aListener );
+		//! listens on aAddress, loopback only by default; returns an empty ref if the port can't be opened
+		static ReplicationServerRef create( UIController *aUIController, const uint16_t &aPort, const std::string &aAddress = "127.0.0.1" );
+
+		//! called by the controller once per frame
+		void publish();
+
+		int getNumViewers() const { return mViewers.size(); }
+		uint16_t getPort() const { return mListener->getPort(); }
+		//! everything sent to every viewer, in bytes, framing included
+		uint64_t getBytesSent() const { return mBytesSent; }
+		uint64_t getNumMessages() const { return mNumMessages; }
+
+		//! unsent bytes a viewer may have queued before it's resynchronized with a snapshot
+		static size_t MAX_BACKLOG;
+
+	private:
+		struct Viewer {
+			TcpSocketRef mSocket;
+			std::vector<uint8_t> mPending;
+			bool mNeedsSnapshot;
+		};
+
+		struct ElementState {
+			std::vector<uint32_t> mValueBits;
+			uint8_t mFlags;
+			int32_t mBounds[4];
+			uint64_t mSampleCount;
+			uint32_t mLastSampleBits;
+		};
+
+		void capture( const int &aId, ElementState &aState );
+		void writeSnapshot( std::vector<uint8_t> &aMessage );
+		//! returns false if nothing changed
+		bool writeDelta( std::vector<uint8_t> &aMessage );
+		void beginMessage( std::vector<uint8_t> &aMessage, const uint8_t &aType );
+		void endMessage( std::vector<uint8_t> &aMessage );
+		void send( Viewer &aViewer, const std::vector<uint8_t> &aMessage );
+
+		UIController *mParent;
+		TcpSocketRef mListener;
+		std::vector<Viewer> mViewers;
+		//! what viewers were last sent, per element id
+		std::vector<ElementState> mSent;
+		ElementState mCurrent;
+		std::vector<float> mSamples;
+		std::vector<uint8_t> mSnapshot, mDelta;
+		uint64_t mFrame;
+		uint64_t mBytesSent;
+		uint64_t mNumMessages;
+	};
+
+	//! Viewer side: connects to a ReplicationServer and keeps a copy of the panel's state
+	class ReplicaClient {
+	public:
+		struct Element {
+			std::string mName;
+			//! the element's params, in the form of the JSON string API
+			std::string mParams;
+			uint8_t mKind;
+			int32_t mBounds[4];
+			uint8_t mFlags;
+			std::vector<float> mValues;
+			//! the most recent samples, oldest first, at most mSampleCapacity of them
+			std::vector<float> mSamples;
+			uint32_t mSampleCapacity;
+			uint64_t mSampleCount;
+		};
+
+		static ReplicaClientRef connect( const std::string &aAddress, const uint16_t &aPort );
+
+		//! reads what has arrived; returns the ids of the elements that changed (all of them after a snapshot)
+		const std::vector<uint32_t> & poll();
+
+		bool isConnected() const { return (bool)mSocket; }
+		//! incremented by every snapshot, after which the panel should be rebuilt
+		uint32_t getNumSnapshots() const { return mNumSnapshots; }
+		uint64_t getFrame() const { return mFrame; }
+		const std::string & getPanelParams() const { return mPanelParams; }
+		const std::vector<Element> & getElements() const { return mElements; }
+		uint64_t getBytesReceived() const { return mBytesReceived; }
+
+	private:
+		explicit ReplicaClient( const TcpSocketRef &aSocket );
+
+		//! returns false for a malformed message, after which the connection is dropped
+		bool readMessage( const uint8_t *aData, const size_t &aSize );
+		bool readSnapshot( const uint8_t *aData, const size_t &aSize, size_t &aPosition );
+		bool readDelta( const uint8_t *aData, const size_t &aSize, size_t &aPosition );
+		void changed( const uint32_t &aId );
+
+		TcpSocketRef mSocket;
+		std::vector<uint8_t> mBuffer;
+		std::vector<Element> mElements;
+		std::vector<uint32_t> mChanged;
+		std::vector<bool> mSeen;
+		std::string mPanelParams;
+		uint32_t mNumSnapshots;
+		uint64_t mFrame;
+		uint64_t mBytesReceived;
+	};
+
+}
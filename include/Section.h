@@ -0,0 +1,31 @@
+#pragma once
+
+#include "UIElement.h"
+#include "UIController.h"
+
+namespace MinimalUI {
+
+	//! Collapsible header for the elements added after it, up to the matching UIController::endSection(). Sections nest.
+	//! While collapsed, its descendants are skipped by update, draw, hit testing and layout, and their name textures are released.
+	class Section : public UIElement {
+	public:
+		Section( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
+
+		void draw();
+		void update() { }
+		ci::ColorA getFillColor() const { return isActive() ? UIController::ACTIVE_STROKE_COLOR : UIController::DEFAULT_STROKE_COLOR; }
+		void handleMouseUp( const ci::Vec2i &aMousePos );
+
+		bool isCollapsed() const { return mCollapsed; }
+		void setCollapsed( const bool &aCollapsed );
+		void toggle() { setCollapsed( !mCollapsed ); }
+
+	private:
+		bool mCollapsed;
+
+		static int DEFAULT_WIDTH;
+		static int DEFAULT_HEIGHT;
+	};
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class SharedMemory> SharedMemoryRef;
+
+	//! A named memory-mapped segment shared between processes. The creator owns the name and removes it when destroyed.
+	class SharedMemory {
+	public:
+		~SharedMemory();
+
+		//! creates (or replaces) a zero-filled segment; returns an empty ref on failure
+		static SharedMemoryRef create( const std::string &aName, const size_t &aSize );
+		//! maps an existing segment; returns an empty ref if it doesn't exist
+		static SharedMemoryRef open( const std::string &aName );
+
+		void * getData() const { return mData; }
+		size_t getSize() const { return mSize; }
+		const std::string & getName() const { return mName; }
+
+	private:
+		SharedMemory( const std::string &aName, const bool &aOwner );
+
+		// disable copy and operator=
+		SharedMemory( const SharedMemory& );
+		SharedMemory & operator=( const SharedMemory& );
+
+		bool map( const size_t &aSize, const bool &aCreate );
+
+		std::string mName;
+		bool mOwner;
+		void *mData;
+		size_t mSize;
+#if defined( _WIN32 )
+		void *mHandle;
+#else
+		int mFd;
+#endif
+	};
+
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// SSE2 where the compiler targets it (always on x64); MINIMALUI_SSE2 selects the vector paths, with a scalar fallback
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+	#define MINIMALUI_SSE2
+#endif
@@ -2,22 +2,43 @@
 
 #include "UIElement.h"
 #include "UIController.h"
+#include "GlyphAtlas.h"
+#include "SmoothingEngine.h"
 
 namespace MinimalUI {
 
 	class Slider : public UIElement {
 	public:
-		Slider( UIController *aUIController, const std::string &aName, float *aValueToLink, const std::string &aParamString );
-		static UIElementRef create( UIController *aUIController, const std::string &aName, float *aValueToLink, const std::string &aParamString );
+		Slider( UIController *aUIController, const std::string &aName, float *aValueToLink, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, float *aValueToLink, const Params &aParams );
 		
 		void draw();
 		void update();
+		ci::ColorA getFillColor() const { return isLocked() ? UIController::DEFAULT_STROKE_COLOR : getBackgroundColor(); }
 		
 		void handleMouseDown( const ci::Vec2i &aMousePos, const bool isRight );
 		void handleMouseDrag( const ci::Vec2i &aMousePos );
+		void handleExternalValue( const int &aChannel, const float &aValue );
 		void updatePosition( const int &aPos );
 		
+		int getNumValues() const { return 1; }
+		float getValue( const int &aChannel ) const { return *mLinkedValue; }
+		void setValue( const int &aChannel, const float &aValue ) { *mLinkedValue = aValue; if ( mSmoothingIndex >= 0 ) mSmoothingEngine->setTarget( mSmoothingIndex, aValue ); }
+		bool hasContinuousValues() const { return true; }
+		//! only while it isn't being dragged, and hasn't changed value for DEFAULT_SETTLE_UPDATES updates
+		bool isStatic() const { return mStatic && !isActive() && mUnsettledUpdates == 0; }
+
+		//! also sends the value to a parameter of aEngine whenever it changes, for an audio thread to read as ramps
+		//! instead of reading the linked float directly; a null engine stops it
+		void setSmoothing( const SmoothingEngineRef &aEngine, const SmoothingEngine::Ramp &aRamp = SmoothingEngine::ONE_POLE, const double &aTime = SmoothingEngine::DEFAULT_RAMP_TIME );
+		//! the slider's parameter in the smoothing engine, or -1
+		int getSmoothingIndex() const { return mSmoothingIndex; }
+		
 	protected:
+		void boundsChanged();
+		//! notifies the controller of a change to the linked value, and sends it to the smoothing engine
+		void publishValue();
+		
 		float mMin;
 		float mMax;
 		int mScreenMin;
@@ -28,23 +49,47 @@ namespace MinimalUI {
 		bool mHandleVisible;
 		bool mVertical;
 
+		// optional value readout, enabled with the "readout" param
+		GlyphAtlasRef mReadoutAtlas;
+		ValueReadout mReadout;
+
+		SmoothingEngineRef mSmoothingEngine;
+		int mSmoothingIndex;
+		//! the linked value as of the last update(), to notice the app changing it
+		float mLastValue;
+		//! updates left until a changed value goes back into the cached layer
+		int mUnsettledUpdates;
+
 		static int DEFAULT_HEIGHT;
 		static int DEFAULT_WIDTH;
 		static int DEFAULT_HANDLE_HALFWIDTH;
+		static int DEFAULT_SETTLE_UPDATES;
 	};  
    
 	class Slider2D : public UIElement {
 	public:
-		Slider2D( UIController *aUIController, const std::string &aName, ci::Vec2f *aValueToLink, const std::string &aParamString );
-		static UIElementRef create( UIController *aUIController, const std::string &aName, ci::Vec2f *aValueToLink, const std::string &aParamString );
+		Slider2D( UIController *aUIController, const std::string &aName, ci::Vec2f *aValueToLink, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, ci::Vec2f *aValueToLink, const Params &aParams );
 		
 		void draw();
 		void update();
+		ci::ColorA getFillColor() const { return UIController::DEFAULT_STROKE_COLOR; }
 		
 		void handleMouseDown( const ci::Vec2i &aMousePos, const bool isRight );
 		void handleMouseDrag( const ci::Vec2i &aMousePos );
+		void handleExternalValue( const int &aChannel, const float &aValue );
 		void updatePosition( const ci::Vec2i &aPos );
 		
+		int getNumValues() const { return 2; }
+		float getValue( const int &aChannel ) const { return aChannel == 0 ? mLinkedValue->x : mLinkedValue->y; }
+		void setValue( const int &aChannel, const float &aValue ) { ( aChannel == 0 ? mLinkedValue->x : mLinkedValue->y ) = aValue; }
+		bool hasContinuousValues() const { return true; }
+		//! only while it isn't being dragged, and hasn't changed value for DEFAULT_SETTLE_UPDATES updates
+		bool isStatic() const { return mStatic && !isActive() && mUnsettledUpdates == 0; }
+		
+	protected:
+		void boundsChanged();
+		
 	private:
 		ci::Vec2f mMin;
 		ci::Vec2f mMax;
@@ -53,18 +98,26 @@ namespace MinimalUI {
 		ci::Vec2f mValue;
 		ci::Vec2f *mLinkedValue;
 		ci::Vec2f mDefaultValue;
+		ci::Vec2f mLastValue;
+		int mUnsettledUpdates;
+
+		GlyphAtlasRef mReadoutAtlas;
+		ValueReadout mReadout;
  
 		static int DEFAULT_HEIGHT;
 		static int DEFAULT_WIDTH;
 		static int DEFAULT_HANDLE_HALFWIDTH;
+		static int DEFAULT_SETTLE_UPDATES;
 	};
 
 	class SliderCallback : public Slider {
 	public:
-		SliderCallback( UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const std::string &aParamString );
-		static UIElementRef create( UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const std::string &aParamString );
+		SliderCallback( UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const Params &aParams );
 		
 		void handleMouseDown( const ci::Vec2i &aMousePos, const bool isRight );
+		void handleExternalValue( const int &aChannel, const float &aValue );
+		void setValue( const int &aChannel, const float &aValue );
 		
 		void addEventHandler( const std::function<void()>& aEventHandler );
 		void callEventHandlers();
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class SmoothingEngine> SmoothingEngineRef;
+
+	//! Turns parameter values that change at UI rate into per-sample ramps for an audio callback. The UI side (a
+	//! Slider, see Slider::setSmoothing()) stores targets into a lock-free slot per parameter; the audio thread calls
+	//! process() once per block and reads each parameter's ramp with getOutput().
+	//!
+	//! Every ramp is the same recurrence, y = a * y + b, stopped at the target, so process() runs four parameters per
+	//! SSE instruction however they're configured. Nothing in process() allocates, locks or blocks.
+	class SmoothingEngine {
+	public:
+		enum Ramp {
+			//! a straight line to the target, reached after the ramp time
+			LINEAR,
+			//! a one pole lowpass; the ramp time is its time constant, the time to cover 63% of the distance
+			ONE_POLE,
+			//! a constant ratio per sample, reached after the ramp time; for frequencies and gains. Falls back to
+			//! LINEAR when the start and target don't have the same sign.
+			EXPONENTIAL
+		};
+
+		SmoothingEngine( const double &aSampleRate, const int &aMaxParameters, const int &aMaxBlockSize );
+		static SmoothingEngineRef create( const double &aSampleRate, const int &aMaxParameters = DEFAULT_MAX_PARAMETERS, const int &aMaxBlockSize = DEFAULT_MAX_BLOCK_SIZE );
+
+		//! from the UI thread, also while processing; returns the parameter's index, or -1 when the engine is full
+		int addParameter( const float &aValue, const Ramp &aRamp = ONE_POLE, const double &aTime = DEFAULT_RAMP_TIME );
+		//! from any thread; the ramp toward it starts at the next process()
+		void setTarget( const int &aIndex, const float &aValue ) { mTargets[aIndex].store( aValue, std::memory_order_relaxed ); }
+
+		//! from the audio thread: computes the next aNumSamples (at most the max block size) of every parameter
+		void process( const int &aNumSamples );
+		//! the ramp computed by the last process(), one value per sample
+		const float * getOutput( const int &aIndex ) const { return &mOutput[aIndex * mMaxBlockSize]; }
+		//! the value at the end of the last process(), from the audio thread
+		float getValue( const int &aIndex ) const { return mCurrent[aIndex]; }
+
+		int getNumParameters() const { return mNumParameters.load( std::memory_order_acquire ); }
+		int getMaxBlockSize() const { return mMaxBlockSize; }
+		double getSampleRate() const { return mSampleRate; }
+
+		static int DEFAULT_MAX_PARAMETERS;
+		static int DEFAULT_MAX_BLOCK_SIZE;
+		//! in seconds
+		static double DEFAULT_RAMP_TIME;
+
+	private:
+		// disable copy and operator=
+		SmoothingEngine( const SmoothingEngine& );
+		SmoothingEngine & operator=( const SmoothingEngine& );
+
+		//! sets up the recurrence from the current value to a new target
+		void retarget( const int &aIndex, const float &aTarget );
+
+		double mSampleRate;
+		int mMaxParameters;
+		int mMaxBlockSize;
+		std::atomic<int> mNumParameters;
+		//! parameters process() has picked up; the rest were added since, and start at their target
+		int mNumActive;
+
+		// written by the UI thread; a parameter's ramp settings don't change once it's added
+		std::vector<std::atomic<float> > mTargets;
+		std::vector<Ramp> mRamps;
+		std::vector<float> mRampSamples;
+
+		// the audio thread's state, one entry per parameter, padded to a multiple of four: y' = a * y + b, and the
+		// ramp stops at the target once it overshoots (the step changes sign against mDirection) or gets within mSnap
+		std::vector<float> mCurrent, mA, mB, mTarget, mDirection, mSnap;
+		std::vector<float> mOutput;
+		//! per group of four parameters, true once they've all reached their targets and their output is filled
+		std::vector<bool> mResting;
+	};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class TcpSocket> TcpSocketRef;
+
+	//! A non-blocking TCP socket, just enough for streaming to and from a few peers on a frame loop. Doesn't depend on
+	//! Cinder, so viewers can be built without it.
+	class TcpSocket {
+	public:
+		~TcpSocket();
+
+		//! listens on aAddress ("127.0.0.1" for loopback only, "0.0.0.0" for every interface); port 0 picks a free
+		//! port, see getPort(). Returns an empty ref on failure.
+		static TcpSocketRef listen( const std::string &aAddress, const uint16_t &aPort );
+		//! connects, blocking until the peer accepts or refuses; returns an empty ref on failure
+		static TcpSocketRef connect( const std::string &aAddress, const uint16_t &aPort );
+
+		//! a pending connection on a listening socket, or an empty ref
+		TcpSocketRef accept();
+		//! sends what the socket takes without blocking; returns the number of bytes sent, or -1 once the peer is gone
+		int send( const uint8_t *aData, const size_t &aSize );
+		//! returns the number of bytes read, 0 if nothing has arrived, or -1 once the peer is gone
+		int receive( uint8_t *aData, const size_t &aSize );
+
+		//! the local port, e.g. the one picked for a listening socket bound to port 0
+		uint16_t getPort() const;
+
+	private:
+		explicit TcpSocket( const intptr_t &aHandle );
+
+		// disable copy and operator=
+		TcpSocket( const TcpSocket& );
+		TcpSocket & operator=( const TcpSocket& );
+
+		intptr_t mHandle;
+	};
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "UIElement.h"
+#include "UIController.h"
+#include "PercentileSketch.h"
+#include "GlyphAtlas.h"
+#include "LockFreeQueue.h"
+
+namespace MinimalUI {
+
+	//! Live frame time percentiles, panel update and draw time, process memory, and texture atlas use. The controller
+	//! feeds it a sample every frame; the readout is drawn from a glyph atlas, so refreshing it never rasterizes text.
+	class StatsOverlay : public UIElement {
+	public:
+		StatsOverlay( UIController *aUIController, const std::string &aName, const Params &aParams );
+		static UIElementRef create( UIController *aUIController, const std::string &aName, const Params &aParams );
+
+		void draw();
+		void update();
+
+		//! times in milliseconds; called on the main thread, and handed to update(), which runs on a threaded panel's model
+		//! thread, through a queue
+		void addSample( const float &aFrameTime, const float &aUpdateTime, const float &aDrawTime );
+
+		//! the latest frame time, for linking to a MovingGraph
+		float * getFrameTimeLink() { return &mFrameTime; }
+		float getPercentile( const float &aFraction ) const { return mReport.getPercentile( aFraction ); }
+
+		//! resident memory of the process in bytes, or 0 where unsupported
+		static size_t getProcessMemory();
+
+	private:
+		struct Sample {
+			float mFrameTime, mUpdateTime, mDrawTime;
+		};
+		// a sample is dropped if the queue is full, e.g. while the panel is hidden
+		SpscQueue<Sample> mSamples;
+		float mFrameTime, mUpdateTime, mDrawTime;
+		// percentiles cover the previous window and the current one, so the readout doesn't empty at each rollover
+		PercentileSketch mCurrent, mPrevious, mReport;
+		double mWindow, mWindowStart;
+		double mRefresh, mLastRefresh;
+
+		GlyphAtlasRef mAtlas;
+		static const int NUM_LINES = 4;
+		char mLines[NUM_LINES][96];
+
+		static int DEFAULT_WIDTH;
+		static size_t DEFAULT_QUEUE_SIZE;
+	};
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Texture.h"
+#include "cinder/Surface.h"
+#include "cinder/ImageIo.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <exception>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class TextureAtlas> TextureAtlasRef;
+
+	//! Background images and icons, packed at load time into a few large pages. Each image is surrounded by a copy of
+	//! its own edge pixels and starts on a 4 pixel boundary, so neither filtering nor the first two mip levels bleed in
+	//! from its neighbours. Quads are queued like GlyphAtlas text and drawn in submission order, binding each page once
+	//! per run of quads that share it.
+	class TextureAtlas {
+	public:
+		//! where an image ended up; empty until added
+		struct Region {
+			Region() : mPage( -1 ) { }
+			explicit operator bool() const { return mPage >= 0; }
+			int mPage;
+			ci::Rectf mTexCoords;
+			ci::Vec2i mSize;
+		};
+
+		struct Stats {
+			int mNumPages;
+			int mNumRegions;
+			//! texture memory, including the mip levels
+			size_t mGpuBytes;
+			//! the copies kept to pack later images into the same pages
+			size_t mCpuBytes;
+			//! fraction of the page area covered by images
+			float mOccupancy;
+			//! page binds since the atlas was created; compare two readings for a per-frame count
+			int mNumBinds;
+		};
+
+		TextureAtlas( const int &aPageSize = DEFAULT_PAGE_SIZE );
+		static TextureAtlasRef create( const int &aPageSize = DEFAULT_PAGE_SIZE );
+
+		//! packs an image, once per key; an empty key always adds a new region
+		Region add( const ci::Surface &aSurface, const std::string &aKey = "" );
+		Region add( ci::ImageSourceRef aImage, const std::string &aKey = "" );
+		//! the region added under aKey, or an empty one
+		Region get( const std::string &aKey ) const;
+
+		//! queues aRegion stretched over aRect
+		void draw( const Region &aRegion, const ci::Rectf &aRect, const ci::ColorA &aColor = ci::ColorA::white() );
+		//! draws everything queued since the last flush, uploading any page that changed first
+		void flush();
+
+		Stats getStats() const;
+
+		static const int DEFAULT_PAGE_SIZE = 2048;
+		static const int PADDING = 4;
+
+	private:
+		// disable copy and operator=
+		TextureAtlas( const TextureAtlas& );
+		TextureAtlas & operator=( const TextureAtlas& );
+
+		struct Shelf {
+			int mY, mHeight, mX;
+		};
+		struct Page {
+			ci::Surface mSurface;
+			ci::gl::Texture mTexture;
+			std::vector<Shelf> mShelves;
+			int mTop;
+			int mUsedPixels;
+			bool mDirty;
+		};
+		// a run of queued quads on one page
+		struct Batch {
+			int mPage, mFirst, mCount;
+		};
+
+		bool allocate( Page &aPage, const ci::Vec2i &aSize, ci::Vec2i *aPosition );
+		int addPage( const ci::Vec2i &aSize );
+		void bindPage( Page &aPage );
+
+		int mPageSize;
+		std::vector<Page> mPages;
+		std::map<std::string, Region> mRegions;
+		int mNumRegions;
+		int mNumBinds;
+
+		std::vector<float> mVertices;
+		std::vector<float> mTexCoords;
+		std::vector<float> mColors;
+		std::vector<Batch> mBatches;
+	};
+
+	//! An image that hasn't been packed yet: an asset path, or a source the caller already opened. prewarm() decodes it
+	//! on the shared worker pool; pack() uses that if it's done, waits if it's underway, and decodes it itself if the
+	//! task hasn't started.
+	class PendingImage {
+	public:
+		PendingImage() { }
+		explicit PendingImage( const std::string &aAssetPath ) : mAssetPath( aAssetPath ) { }
+		explicit PendingImage( ci::ImageSourceRef aSource ) : mSource( aSource ) { }
+
+		explicit operator bool() const { return !mAssetPath.empty() || mSource; }
+
+		void prewarm();
+		//! adds the image to aAtlas (once per asset path) and forgets it; rethrows anything decoding threw
+		TextureAtlas::Region pack( TextureAtlas &aAtlas );
+
+	private:
+		// shared with the decode task, which may outlive the image
+		struct Decoded {
+			enum State { QUEUED, DECODING, DONE };
+			Decoded() : mState( QUEUED ) { }
+			std::atomic<int> mState;
+			ci::Surface mSurface;
+			std::exception_ptr mError;
+		};
+		static void decode( Decoded &aDecoded, const std::string &aAssetPath, ci::ImageSourceRef aSource );
+
+		std::string mAssetPath;
+		ci::ImageSourceRef mSource;
+		std::shared_ptr<Decoded> mDecoded;
+	};
+
+}
@@ -5,15 +5,40 @@
 #include "cinder/gl/gl.h"
 #include "cinder/gl/Fbo.h"
 #include "cinder/Timeline.h"
+#include "Automation.h"
+#include "UndoJournal.h"
+#include "ParamBridge.h"
+#include "Replication.h"
+#include "GlyphAtlas.h"
+#include "TextureAtlas.h"
+#include "ExternalInput.h"
+#include "InputLog.h"
+#include "LockFreeQueue.h"
+#include "Params.h"
 #include <vector>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 namespace MinimalUI {
 	
 	class UIElement;
+	class UIManager;
+	class Section;
+	class StatsOverlay;
 	
 	typedef std::shared_ptr<class UIController> UIControllerRef;
 	typedef std::shared_ptr<class UIElement> UIElementRef;
 
+	// one touch in window points; synthetic touches can be fed in without a window
+	struct TouchPoint {
+		uint32_t mId;
+		ci::Vec2f mPos;
+	};
+
 	class UIController {
 	public:
 
@@ -21,69 +46,283 @@ namespace MinimalUI {
 		static int DEFAULT_MARGIN_LARGE;
 		static int DEFAULT_MARGIN_SMALL;
 		static int DEFAULT_UPDATE_FREQUENCY;
-		static int DEFAULT_FBO_WIDTH;
+		// the panel is rendered in square tiles of this many pixels, allocated when first on screen
+		static int DEFAULT_TILE_SIZE;
 		static ci::ColorA DEFAULT_STROKE_COLOR;
 		static ci::ColorA ACTIVE_STROKE_COLOR;
 		static ci::ColorA DEFAULT_NAME_COLOR;
 		static ci::ColorA DEFAULT_BACKGROUND_COLOR;
 
-		UIController( ci::app::WindowRef window, const std::string &aParamString );
+		// controllers created by a UIManager share its fonts and textures, and get their input from it
+		UIController( ci::app::WindowRef window, const std::string &aParamString, UIManager *aManager = nullptr );
+		~UIController();
 		static UIControllerRef create( const std::string &aParamString = "{}", ci::app::WindowRef aWindow = ci::app::App::get()->getWindow() );
 		
 		void mouseDown( ci::app::MouseEvent &event );
+		void mouseUp( ci::app::MouseEvent &event );
+		void mouseDrag( ci::app::MouseEvent &event );
+		bool contains( const ci::Vec2i &aPos ) const { return ( mBounds + mPosition ).contains( aPos ) || mForceInteraction; }
+
+		// multi-touch: each touch captures the element it began on until it ends; an event's touches are hit tested together
+		void touchesBegan( ci::app::TouchEvent &event );
+		void touchesMoved( ci::app::TouchEvent &event );
+		void touchesEnded( ci::app::TouchEvent &event );
+		// one frame of synthetic touches, e.g. from a test harness
+		void touchesBegan( const TouchPoint *aTouches, const size_t &aCount );
+		void touchesMoved( const TouchPoint *aTouches, const size_t &aCount );
+		void touchesEnded( const TouchPoint *aTouches, const size_t &aCount );
+		typedef void ( UIController::*TouchHandler )( const TouchPoint *, const size_t & );
+		// the element a touch has captured, or null
+		UIElement* getTouchedElement( const uint32_t &aId ) const;
+		int getNumTouches() const;
+		// touches beyond this many at once are ignored
+		static const int MAX_TOUCHES = 32;
+
+		// where hardware controllers send values, by element id; created on first use, so call it on the main thread first
+		ExternalInputRef getExternalInput();
 		
-		void addElement( const UIElementRef &aElement ) { mUIElements.push_back( aElement ); }
+		void addElement( const UIElementRef &aElement );
+		int getNumElements() const { return mUIElements.size(); }
+		UIElementRef getElement( const int &aId ) const { return ( aId >= 0 && aId < (int)mUIElements.size() ) ? mUIElements[aId] : UIElementRef(); }
 
-		UIElementRef addSlider( const std::string &aName, float *aValueToLink, const std::string &aParamString = "{}" );
-		UIElementRef addSlider2D( const std::string &aName, ci::Vec2f *aValueToLink, const std::string &aParamString = "{}" );
-		UIElementRef addSliderCallback( const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const std::string &aParamString = "{}" );
-		UIElementRef addToggleSlider( const std::string &aSliderName, float *aValueToLink, const std::string &aButtonName, const std::function<void( bool )>& aEventHandler, const std::string &aSliderParamString = "{}", const std::string &aButtonParamString = "{}" );
-		UIElementRef addButton( const std::string &aName, const std::function<void( bool )>& aEventHandler, const std::string &aParamString = "{}" );
-		UIElementRef addLinkedButton( const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const std::string &aParamString = "{}" );
-		UIElementRef addLabel( const std::string &aName, const std::string &aParamString = "{}" );
-		UIElementRef addImage( const std::string &aName, ci::ImageSourceRef aImage, const std::string &aParamString = "{}" );
-		UIElementRef addMovingGraph(const std::string &aName, float *aValueToLink, const std::string &aParamString = "{}");
-		UIElementRef addMovingGraphButton(const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const std::string &aParamString = "{}");
+		// options are a JSON string, e.g. "{ \"min\": -2.0 }", or a typed builder, e.g. SliderParams().min( -2 )
+		UIElementRef addSlider( const std::string &aName, float *aValueToLink, const Params &aParams = Params() );
+		UIElementRef addSlider2D( const std::string &aName, ci::Vec2f *aValueToLink, const Params &aParams = Params() );
+		UIElementRef addSliderCallback( const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const Params &aParams = Params() );
+		UIElementRef addToggleSlider( const std::string &aSliderName, float *aValueToLink, const std::string &aButtonName, const std::function<void( bool )>& aEventHandler, const Params &aSliderParams = Params(), const Params &aButtonParams = Params() );
+		UIElementRef addButton( const std::string &aName, const std::function<void( bool )>& aEventHandler, const Params &aParams = Params() );
+		UIElementRef addLinkedButton( const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const Params &aParams = Params() );
+		UIElementRef addLabel( const std::string &aName, const Params &aParams = Params() );
+		UIElementRef addImage( const std::string &aName, ci::ImageSourceRef aImage, const Params &aParams = Params() );
+		UIElementRef addImageSequence( const std::string &aName, const std::vector<std::string> &aPaths, const Params &aParams = Params() );
+		UIElementRef addMovingGraph(const std::string &aName, float *aValueToLink, const Params &aParams = Params());
+		UIElementRef addMovingGraphButton(const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const Params &aParams = Params());
+		UIElementRef addMultiGraph( const std::string &aName, const Params &aParams = Params() );
+		UIElementRef addHistogram( const std::string &aName, const Params &aParams = Params() );
+		UIElementRef addScatterPlot( const std::string &aName, const Params &aParams = Params() );
+		// a frame time and memory readout, followed by a MovingGraph of the frame time
+		UIElementRef addStatsOverlay( const std::string &aName, const Params &aParams = Params() );
+		UIElementRef addHeatmap( const std::string &aName, const Params &aParams = Params() );
 
-		void addSeparator() { mInsertPosition.x = mMarginLarge; mInsertPosition.y += mMarginLarge; }
+		// elements added until the matching endSection() collapse under the section's header
+		UIElementRef addSection( const std::string &aName, const Params &aParams = Params() );
+
+		// the typed builders only convert explicitly, so passing one element's builder to another element doesn't compile
+		UIElementRef addSlider( const std::string &aName, float *aValueToLink, const SliderParams &aParams ) { return addSlider( aName, aValueToLink, Params( aParams ) ); }
+		UIElementRef addSlider2D( const std::string &aName, ci::Vec2f *aValueToLink, const Slider2DParams &aParams ) { return addSlider2D( aName, aValueToLink, Params( aParams ) ); }
+		UIElementRef addSliderCallback( const std::string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const SliderParams &aParams ) { return addSliderCallback( aName, aValueToLink, aEventHandler, Params( aParams ) ); }
+		UIElementRef addToggleSlider( const std::string &aSliderName, float *aValueToLink, const std::string &aButtonName, const std::function<void( bool )>& aEventHandler, const SliderParams &aSliderParams, const ButtonParams &aButtonParams = ButtonParams() ) { return addToggleSlider( aSliderName, aValueToLink, aButtonName, aEventHandler, Params( aSliderParams ), Params( aButtonParams ) ); }
+		UIElementRef addButton( const std::string &aName, const std::function<void( bool )>& aEventHandler, const ButtonParams &aParams ) { return addButton( aName, aEventHandler, Params( aParams ) ); }
+		UIElementRef addLinkedButton( const std::string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const ButtonParams &aParams ) { return addLinkedButton( aName, aEventHandler, aLinkedState, Params( aParams ) ); }
+		UIElementRef addLabel( const std::string &aName, const LabelParams &aParams ) { return addLabel( aName, Params( aParams ) ); }
+		UIElementRef addImage( const std::string &aName, ci::ImageSourceRef aImage, const ImageParams &aParams ) { return addImage( aName, aImage, Params( aParams ) ); }
+		UIElementRef addImageSequence( const std::string &aName, const std::vector<std::string> &aPaths, const ImageSequenceParams &aParams ) { return addImageSequence( aName, aPaths, Params( aParams ) ); }
+		UIElementRef addMovingGraph( const std::string &aName, float *aValueToLink, const MovingGraphParams &aParams ) { return addMovingGraph( aName, aValueToLink, Params( aParams ) ); }
+		UIElementRef addMovingGraphButton( const std::string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const MovingGraphParams &aParams ) { return addMovingGraphButton( aName, aValueToLink, aEventHandler, Params( aParams ) ); }
+		UIElementRef addMultiGraph( const std::string &aName, const MultiGraphParams &aParams ) { return addMultiGraph( aName, Params( aParams ) ); }
+		UIElementRef addHistogram( const std::string &aName, const HistogramParams &aParams ) { return addHistogram( aName, Params( aParams ) ); }
+		UIElementRef addScatterPlot( const std::string &aName, const ScatterPlotParams &aParams ) { return addScatterPlot( aName, Params( aParams ) ); }
+		UIElementRef addStatsOverlay( const std::string &aName, const StatsOverlayParams &aParams ) { return addStatsOverlay( aName, Params( aParams ) ); }
+		UIElementRef addHeatmap( const std::string &aName, const HeatmapParams &aParams ) { return addHeatmap( aName, Params( aParams ) ); }
+		UIElementRef addSection( const std::string &aName, const SectionParams &aParams ) { return addSection( aName, Params( aParams ) ); }
+		void endSection();
+
+		void addSeparator();
 		
-		void offsetInsertPosition( const ci::Vec2i &offset ) { mInsertPosition += offset; }
-		void resetInsertPosition( const int &offsetY ) { mInsertPosition = ci::Vec2i( mMarginLarge, mInsertPosition.y + offsetY ); }
+		void offsetInsertPosition( const ci::Vec2i &offset );
+		void resetInsertPosition( const int &offsetY );
+		// used by elements to move past themselves once they've been positioned
+		void advanceInsertPosition( const ci::Vec2i &aSize, const bool &aClear );
 		void drawBackground();
 
 		void draw();
 		void update();
 		void resize();
+
+		// Threading: a panel created with "threaded": true runs its model (input, bindings, layout and element updates)
+		// on a thread of its own, and element handlers run there. update() only requests a step; input is queued for the
+		// next one. Each step holds mModelMutex, and render() redraws the tiles only when it can take that lock, from the
+		// last finished step (getGeneration()). lockModel() holds the model still to change the panel from another
+		// thread; the panel's own setters use lockModelIfThreaded(). GL resources are only created and freed on the main
+		// thread, so name textures the model thread changes or releases are handled at the next render. replayInput()
+		// steps the model on the calling thread instead, with mSynchronous set.
+		bool isThreaded() const { return mThreaded; }
+		bool onModelThread() const { return mThreaded && std::this_thread::get_id() == mModelThread.get_id(); }
+		std::unique_lock<std::mutex> lockModel() { return std::unique_lock<std::mutex>( mModelMutex ); }
+		uint64_t getGeneration() const { return mGeneration; }
+		void deferNameTextureRelease() { mNameTexturesReleased = true; }
+		
+		// the two halves of draw(): refresh the tiles (dynamic elements over the cached layer), then draw them to the window
+		void render();
+		void composite();
+
+		// mirrors: the panel's tiles drawn in other windows too, at aDestination in that window's points; call draw() from each
+		void addWindow( ci::app::WindowRef aWindow, const ci::Rectf &aDestination = ci::Rectf() );
+		void removeWindow( ci::app::WindowRef aWindow );
+		void setWindowDestination( ci::app::WindowRef aWindow, const ci::Rectf &aDestination );
+		int getNumWindows() const { return mMirrors.size() + 1; }
+
+		// has the cached layer drawn again, e.g. after changing the DEFAULT_ colors
+		void invalidateLayers();
+		// rasterizes every name again in the current fonts, then redraws the cached layer; setFont() calls this
+		void fontChanged();
 		
+		// repositions every visible element; happens when a section is collapsed or expanded
+		void layout();
+		void sectionToggled( Section *aSection );
+		
+		// show() creates the panel's resources first, if it was hidden until now or released them
 		void show();
 		void hide();
 		bool isVisible() { return mVisible; }
+
+		// a panel created with "visible": false holds no tiles, name textures or images until it's shown
+		void materialize();
+		// decodes the panel's images on the shared worker pool, ahead of show()
+		void prewarm();
+		// frees the tiles and name textures; also "idleRelease" seconds after hide(), if that's given
+		void releaseResources();
+		bool isMaterialized() const { return mMaterialized; }
 		
 		void releaseGroup( const std::string &aGroup );
 		void selectGroupElementByName( const std::string &aGroup, const std::string &aName );
 		void setLockedByGroup( const std::string &aGroup, const bool &locked );
 		void setPressedByGroup( const std::string &aGroup, const bool &pressed );
 
+		// automation: record value changes made through the UI to disk, and play them back
+		void startRecording( const std::string &aPath );
+		void stopRecording();
+		void startPlayback( const std::string &aPath, const double &aRate = AutomationPlayer::DEFAULT_RATE );
+		void stopPlayback();
+		bool isRecording() const { return (bool)mRecorder; }
+		bool isPlaying() const { return mPlayer && mPlayer->isPlaying(); }
+
+		// input capture: a session's raw input and frame times, replayed headlessly as a regression test
+		void startInputCapture( const std::string &aPath );
+		void stopInputCapture();
+		bool isCapturingInput() const { return (bool)mInputCapture; }
+		// replays a capture on the calling thread, at aSpeed times the recorded pace, or as fast as possible for 0
+		InputReplayer::Report replayInput( const std::string &aPath, const double &aSpeed = InputReplayer::AS_FAST_AS_POSSIBLE );
+		
+		// publishes every bound value into a named shared memory segment, for a ParamBridgeClient
+		bool startBridge( const std::string &aName );
+		void stopBridge();
+
+		// streams the panel's state to ReplicaClient viewers on aPort (0 picks a free one), loopback only by default
+		bool startReplication( const uint16_t &aPort, const std::string &aAddress = "127.0.0.1" );
+		void stopReplication();
+		ReplicationServerRef getReplicationServer() const { return mReplication; }
+		// the options the panel was created with
+		const std::string & getParamString() const { return mParamString; }
+		
+		// called by elements whenever the user changes one of their bound values
+		void valueChanged( UIElement *aElement, const int &aChannel, const float &aValue );
+		
+		// undo history: each mouse gesture on an element (a click, a drag, a right-click reset) becomes one step
+		void beginGesture( UIElement *aElement );
+		void endGesture( UIElement *aElement );
+		bool undo();
+		bool redo();
+		bool canUndo() const { return mUndoJournal->canUndo(); }
+		bool canRedo() const { return mUndoJournal->canRedo(); }
+		UndoJournalRef getUndoJournal() const { return mUndoJournal; }
+
 		ci::app::WindowRef getWindow() { return mWindow; }
 		ci::Vec2i getInsertPosition() { return mInsertPosition; }
 		
+		// the font for a style, at the render scale; setFont() takes fonts sized in points
 		ci::Font getFont( const std::string &aStyle );
 		void setFont( const std::string &aStyle, const ci::Font &aFont );
+
+		// pixels per point that text and the tiles are rendered at
+		float getRenderScale() const { return mRenderScale; }
 		
 		ci::gl::Texture getBackgroundTexture() const { return mBackgroundTexture; }
 		void setBackgroundTexture(const ci::gl::Texture &aBackgroundTexture) { mBackgroundTexture = aBackgroundTexture; }
+		const TextureAtlas::Region & getBackgroundRegion() const { return mBackgroundRegion; }
+		void setBackgroundRegion( const TextureAtlas::Region &aRegion ) { mBackgroundRegion = aRegion; }
+		
+		// the glyph atlas for a font style, built on first use and shared like the fonts
+		GlyphAtlasRef getGlyphAtlas( const std::string &aStyle );
+		void flushGlyphAtlases();
+
+		// loads an image asset, through the manager's texture cache if there is one
+		ci::gl::Texture loadTexture( const std::string &aAssetPath );
+		// background images and icons, packed into one atlas per manager (or per panel without one)
+		TextureAtlasRef getTextureAtlas();
+		// loads an image asset into the texture atlas, once per path
+		TextureAtlas::Region loadTextureRegion( const std::string &aAssetPath );
+		// texture binds made drawing background images in the last render
+		int getBackgroundBinds() const { return mBackgroundBinds; }
+		UIManager* getManager() const { return mManager; }
 
 		int getDepth() { return mDepth + mUIElements.size(); }
+		int getBaseDepth() const { return mDepth; }
 		int getWidth() { return mWidth; }
 		ci::Vec2i getPosition() { return mPosition; }
+		// timings of the last complete frame, in milliseconds
+		float getFrameTime() const { return mFrameTime; }
+		float getUpdateTime() const { return mLastUpdateTime; }
+		float getDrawTime() const { return mLastDrawTime; }
+
 		void setHeight() { mHeightSpecified = true; mHeight = mInsertPosition.y + mMarginLarge; resize(); }
 		
 	private:
 		
-		void setupFbo();
+		struct Tile;
+		// drops every tile, e.g. after the panel's size in pixels changed
+		void setupTiles();
+		// redraws the visible tiles that are out of date, and, on a refresh, those with dynamic elements
+		void renderTiles( const bool &aRefresh );
+		// draws the tile's cached layer: the panel, its background and the static elements
+		void bakeTile( Tile &aTile, const bool &aDynamic );
+		// draws the dynamic elements over a copy of the cached layer
+		void composeTile( Tile &aTile );
+		void beginTile( ci::gl::Fbo &aFbo, const Tile &aTile, const bool &aClear );
+		// draws the fills, then the content, of the tile's static or dynamic elements
+		void drawTileElements( const Tile &aTile, const bool &aStatic );
+		bool hasDynamicElements( const Tile &aTile ) const;
+		void buildTileIndex();
+		// marks the tiles under elements that changed layer or look as stale
+		void updateLayers();
+		// the inclusive range of tiles, by column and row, under an area of the panel in pixels
+		ci::Area getTileRange( const ci::Area &aBounds ) const;
+		// the part of the panel on screen in any of its windows, in points
+		ci::Area getVisibleArea() const;
+		// draws the fills and background images of the given elements, by index into mVisibleElements
+		void drawElementBackgrounds( const std::vector<int> &aElements );
+		// everything update() does with the model, inline or on the model thread
+		void step();
+		void modelThread();
+		void processInput();
+		void dispatchTouches( const std::vector<ci::app::TouchEvent::Touch> &aTouches, TouchHandler aHandler );
+		void buildTouchIndex();
+		void applyExternalInput();
+		// the topmost visible element under each touch, or null
+		void hitTest( const TouchPoint *aTouches, const size_t &aCount, UIElement **aElements );
+		ci::Vec2i getPixelSize() const;
+		void displayChanged();
+
+		struct Mirror {
+			ci::app::WindowRef mWindow;
+			// empty for the panel's position in its own window
+			ci::Rectf mDestination;
+			ci::signals::scoped_connection mCbMouseDown, mCbMouseUp, mCbMouseDrag, mCbClose;
+			ci::signals::scoped_connection mCbTouchesBegan, mCbTouchesMoved, mCbTouchesEnded;
+		};
+		// where the panel is drawn in aWindow, in its points
+		ci::Rectf getDestination( const ci::app::WindowRef &aWindow ) const;
+		// a position in a mirror's window, in the panel's own window's points
+		ci::Vec2f fromMirror( const Mirror &aMirror, const ci::Vec2f &aPos ) const;
+		void mirrorMouse( const Mirror &aMirror, ci::app::MouseEvent &event, void ( UIController::*aHandler )( ci::app::MouseEvent & ) );
+		void mirrorTouches( const Mirror &aMirror, ci::app::TouchEvent &event, TouchHandler aHandler );
+		ci::Font getBaseFont( const std::string &aStyle ) const;
 		
 		ci::app::WindowRef mWindow;
-		ci::signals::scoped_connection mCbMouseDown;
+		UIManager *mManager;
+		ci::signals::scoped_connection mCbMouseDown, mCbMouseUp, mCbMouseDrag, mCbDisplayChange;
+		ci::signals::scoped_connection mCbTouchesBegan, mCbTouchesMoved, mCbTouchesEnded;
+		std::vector< std::unique_ptr<Mirror> > mMirrors;
 		std::string mParamString;
 
 		bool mVisible;
@@ -95,18 +334,139 @@ namespace MinimalUI {
 		int mMarginLarge;
 		
 		std::vector<UIElementRef> mUIElements;
+
+		// everything that moves the insert position, in order, so the panel can be laid out again without hidden elements
+		struct LayoutOp {
+			enum Type { ELEMENT, SEPARATOR, OFFSET, RESET };
+			Type mType;
+			Section *mSection;
+			UIElement *mElement;
+			ci::Vec2i mOffset;
+		};
+		void addLayoutOp( const LayoutOp::Type &aType, UIElement *aElement, const ci::Vec2i &aOffset );
+		std::vector<LayoutOp> mLayoutOps;
+		std::vector<Section *> mSectionStack;
+		// elements outside collapsed sections; this is what update, draw and hit testing walk
+		std::vector<UIElement *> mVisibleElements;
+		bool mLayoutDirty;
 		int mWidth, mHeight, mX, mY;
 		ci::Area mBounds;
 		ci::Vec2i mPosition;
 		ci::Vec2i mInsertPosition;
 		ci::ColorA mPanelColor;
 		ci::Font mLabelFont, mSmallLabelFont, mIconFont, mHeaderFont, mBodyFont, mFooterFont;
+		std::map<std::string, ci::Font> mScaledFonts;
+		float mRenderScale;
 		ci::gl::Texture mBackgroundTexture;
+		TextureAtlas::Region mBackgroundRegion;
+		PendingImage mPendingBackground;
+		bool mMaterialized;
+		bool mNameTexturesReleased;
+		double mIdleRelease, mHiddenSince;
+		std::map<std::string, GlyphAtlasRef> mGlyphAtlases;
+		TextureAtlasRef mTextureAtlas;
+		int mBackgroundBinds;
+		// element fills, batched into one draw
+		std::vector<float> mFillVertices;
+		std::vector<float> mFillColors;
 
-		ci::gl::Fbo mFbo;
+		// the rendered panel, a grid of tiles in pixels; edge tiles only cover what's left of the panel
+		struct Tile {
+			ci::Area mArea;
+			// empty until the tile is first drawn
+			ci::gl::Fbo mFbo;
+			// the cached layer, for a tile with dynamic elements; otherwise mFbo holds just the layer
+			ci::gl::Fbo mLayerFbo;
+			// the visible elements overlapping the tile, by index into mVisibleElements
+			std::vector<int> mElements;
+			// true when the cached layer has to be drawn again
+			bool mStale;
+			// true when dynamic elements changed while the tile was off screen
+			bool mOutdated;
+		};
+		std::vector<Tile> mTiles;
+		// whether each visible element was static when its tiles were last drawn
+		std::vector<bool> mStaticElements;
+		// the static or dynamic elements of the tile being drawn
+		std::vector<int> mLayerElements;
+		int mTileColumns, mTileRows;
+		ci::Vec2i mPixelSize;
+		bool mTileIndexDirty;
 		ci::gl::Fbo::Format mFormat;
 		int mFboNumSamples;
 		ci::Anim<float> mAlpha;
+
+		AutomationRecorderRef mRecorder;
+		AutomationPlayerRef mPlayer;
+		InputCaptureRef mInputCapture;
+		InputReplayer *mInputReplayer;
+
+		void applyJournalEntry( const UndoJournal::Entry &aEntry, const bool &aUndo );
+
+		ParamBridgeRef mBridge;
+		ReplicationServerRef mReplication;
+
+		UndoJournalRef mUndoJournal;
+		// open gestures, one per element held by the mouse or a touch; slots are reused, so holding doesn't allocate
+		struct Gesture {
+			UIElement *mElement;
+			std::vector<UndoJournal::Entry> mValues;
+		};
+		std::vector<Gesture> mGestures;
+
+		// which element each touch has captured; free slots have no element
+		struct TouchCapture {
+			uint32_t mId;
+			UIElement *mElement;
+		};
+		TouchCapture mTouches[MAX_TOUCHES];
+		// for each cell of a grid over the panel, the visible elements overlapping it, by index into mVisibleElements
+		static const int TOUCH_CELL_SIZE = 32;
+		int mIndexColumns, mIndexRows;
+		std::vector<int> mIndexStarts;
+		std::vector<int> mIndexElements;
+		bool mIndexDirty;
+
+		ExternalInputRef mExternalInput;
+		// this update's external values: the latest per slider channel, and every button event, in arrival order
+		std::vector<ExternalInputEvent> mExternalEvents;
+		// sliders being moved from a controller; each one's undo step ends once it has been still for a while
+		struct ExternalGesture {
+			UIElement *mElement;
+			double mLastInput;
+		};
+		std::vector<ExternalGesture> mExternalGestures;
+		// external input arrived since the last render, so the elements update and their tiles redraw this frame
+		bool mExternalRefresh;
+		static double EXTERNAL_GESTURE_TIMEOUT;
+
+		// the model thread (see Threading above), and the input waiting for its next step
+		struct ModelInput {
+			enum Type { MOUSE_DOWN, MOUSE_UP, MOUSE_DRAG, TOUCHES_BEGAN, TOUCHES_MOVED, TOUCHES_ENDED };
+			Type mType;
+			ci::Vec2f mPos;
+			uint32_t mId;
+			bool mRight;
+		};
+		// returns false if the input should be handled right away instead
+		bool queueInput( const ModelInput::Type &aType, const ci::Vec2f &aPos, const uint32_t &aId, const bool &aRight );
+		std::unique_lock<std::mutex> lockModelIfThreaded();
+		bool mThreaded;
+		std::thread mModelThread;
+		std::mutex mModelMutex;
+		std::mutex mStepMutex;
+		std::condition_variable mStepCondition;
+		bool mStepRequested, mStopping;
+		bool mSynchronous;
+		std::atomic<uint64_t> mGeneration;
+		uint64_t mRenderedGeneration;
+		SpscQueue<ModelInput> mModelInput;
+
+		std::chrono::steady_clock::time_point mLastFrame;
+		// running totals for this frame, and the totals of the last one
+		float mUpdateTime, mDrawTime;
+		float mFrameTime, mLastUpdateTime, mLastDrawTime;
+		StatsOverlay *mStatsOverlay;
 	};
 
 	//! Exception for unknown
@@ -5,28 +5,56 @@
 #include "cinder/gl/Texture.h"
 #include "cinder/ImageIo.h"
 #include "cinder/Text.h"
-#include "cinder/Json.h"
+#include "TextureAtlas.h"
+#include "Params.h"
 
 namespace MinimalUI {
 	
 	class UIController;
+	class Section;
 
 	class UIElement {
 	public:
-		UIElement( UIController *aUIController, const std::string &aName, const std::string &aParamString );
+		UIElement( UIController *aUIController, const std::string &aName, const Params &aParams );
 		virtual ~UIElement() { }
 		
 		void offsetInsertPosition();
-		void setPositionAndBounds();
+		virtual void setPositionAndBounds();
+		//! repositions the element at the controller's insert position, e.g. when a section above it collapses
+		void relayout() { setPositionAndBounds(); boundsChanged(); }
 		
+		//! rasterizes the name, or just notes that it's needed while the panel has no resources
 		void renderNameTexture();
+		//! left to the panel's next render on its model thread, since the texture can only be freed on the main thread
+		void releaseNameTexture();
+		//! frees a texture the model thread released; called by the controller on the main thread
+		void releaseDeferredNameTexture() { if ( mNameTextureReleased ) { mNameTexture.reset(); mNameTextureReleased = false; } }
+		//! the size of the name as it will render, in points, without rasterizing it
+		ci::Vec2f measureName();
+
+		// GPU and text resources, created when the panel is first shown rather than when the element is added
+		//! creates what the element needs to draw; called by the controller, or right away once its panel has been shown
+		virtual void materialize();
+		//! frees what materialize() created, while the panel is hidden
+		virtual void releaseResources() { releaseNameTexture(); }
+		//! decodes images ahead of materialize(), on the shared worker pool
+		virtual void prewarm() { mPendingBackground.prewarm(); }
+		
+		//! the innermost section the element was added to, or null
+		Section* getSection() const { return mSection; }
+		void setSection( Section *aSection ) { mSection = aSection; }
+		//! true while any enclosing section is collapsed
+		bool isHidden() const;
 		
 		std::string getGroup() const { return mGroup; }
 		
-		void setLocked( const bool &locked ) { mLocked = locked; }
+		void setLocked( const bool &locked ) { mLocked = locked; mLayerDirty = true; }
 		
 		UIController* getParent() const { return mParent; }
 
+		//! index of the element in its controller, stable for the lifetime of the panel
+		int getId() const { return mId; }
+
 		ci::Vec2i getPosition() const { return ci::app::toPixels( mPosition ); }
 		void setPosition( const ci::Vec2i &aPosition ) { mPosition = aPosition; }
 		
@@ -36,43 +64,80 @@ namespace MinimalUI {
 		ci::Area getBounds() const { return ci::app::toPixels( mBounds ); }
 		void setBounds( const ci::Area &aBounds ) { mBounds = aBounds; }
 		
-		bool hasParam( const std::string &aName ) const { return mParams.hasChild( aName ); }
+		bool hasParam( const std::string &aName ) const { return mParams.has( aName ); }
 		template <class T>
-		T getParam( const std::string &aName ) const { return mParams[aName].getValue<T>(); }
+		T getParam( const std::string &aName ) const { return mParams.get<T>( aName ); }
+		ci::ColorA getColorParam( const std::string &aName, const ci::ColorA &aDefault ) const { return mParams.has( aName ) ? mParams.getColor( aName ) : aDefault; }
+		const Params & getParams() const { return mParams; }
 		
 		bool isActive() const { return mActive; }
 		void setActive( const bool &aActive ) { mActive = aActive; }
 		void deactivate() { mActive = false; }
 		bool isLocked() const { return mLocked; }
 		
+		//! a background image in its own texture, drawn with a bind of its own; prefer setBackgroundRegion()
 		ci::gl::Texture getBackgroundTexture() const { return mBackgroundTexture; }
-		void setBackgroundTexture( const ci::gl::Texture &aBackgroundTexture ) { mBackgroundTexture = aBackgroundTexture; }
+		void setBackgroundTexture( const ci::gl::Texture &aBackgroundTexture ) { mBackgroundTexture = aBackgroundTexture; mLayerDirty = true; }
+		//! a background image packed into the controller's texture atlas ("backgroundImage" loads into one)
+		const TextureAtlas::Region & getBackgroundRegion() const { return mBackgroundRegion; }
+		void setBackgroundRegion( const TextureAtlas::Region &aRegion ) { mBackgroundRegion = aRegion; mLayerDirty = true; }
+		//! packs an image into the atlas as the background, now if the panel has been shown, otherwise when it is
+		void setBackgroundImage( const PendingImage &aImage );
+		//! the solid color under the background image, or transparent for none; the controller draws every element's
+		//! fill and background image in one batch before any element draws, so draw() only draws what goes on top
+		virtual ci::ColorA getFillColor() const { return ci::ColorA( 0.0f, 0.0f, 0.0f, 0.0f ); }
 		
 		ci::ColorA getBackgroundColor() const { return mBackgroundColor; }
-		void setBackgroundColor( const ci::ColorA &aBackgroundColor ) { mBackgroundColor = aBackgroundColor; }
+		void setBackgroundColor( const ci::ColorA &aBackgroundColor ) { mBackgroundColor = aBackgroundColor; mLayerDirty = true; }
 		
 		ci::ColorA getForegroundColor() const { return mForegroundColor; }
-		void setForegroundColor( const ci::ColorA &aForegroundColor ) { mForegroundColor = aForegroundColor; }
+		void setForegroundColor( const ci::ColorA &aForegroundColor ) { mForegroundColor = aForegroundColor; mLayerDirty = true; }
 
 		ci::ColorA getNameColor() const { return mNameColor; }
-		void setNameColor( const ci::ColorA &aNameColor ) { mNameColor = aNameColor; renderNameTexture(); }	  
+		void setNameColor( const ci::ColorA &aNameColor ) { mNameColor = aNameColor; renderNameTexture(); mLayerDirty = true; }	  
 
 		std::string getName() const { return mName; }
-		void setName( const std::string &aName ) { mName = aName; renderNameTexture(); }
+		void setName( const std::string &aName ) { mName = aName; renderNameTexture(); mLayerDirty = true; }
 
+		//! the name, rasterized at the panel's render scale
 		ci::gl::Texture getNameTexture() const { return mNameTexture; }
 		void setNameTexture( const ci::gl::Texture &aTexture ) { mNameTexture = aTexture; }
-		void drawBackground();
 		void drawLabel();
 		
 		virtual void draw() = 0;
 		virtual void update() = 0;
+		//! GL work for what update() prepared, such as texture uploads; update() runs on the panel's model thread when
+		//! it's threaded, but this always runs on the main thread, before draw()
+		virtual void upload() { }
+
+		//! static elements are drawn into the panel's cached layer, and drawn again only after a layout, a change of name,
+		//! colors or lock, or invalidateLayer(); dynamic ones are drawn over that layer on every refresh
+		virtual bool isStatic() const { return mStatic; }
+		//! for a static element whose look changed in some other way
+		void invalidateLayer() { mLayerDirty = true; }
+		
+		// bound values, by channel (e.g. x and y for a Slider2D); used by automation and undo, so setValue() fires the
+		// element's own handlers, as input would, but doesn't notify the controller
+		virtual int getNumValues() const { return 0; }
+		virtual float getValue( const int &aChannel ) const { return 0.0f; }
+		virtual void setValue( const int &aChannel, const float &aValue ) { }
+		virtual bool hasContinuousValues() const { return false; }
+
+		// state beyond the bound values, for replicas of the panel
+		virtual bool isPressed() const { return false; }
+		//! the number of samples a graph has plotted since it was created
+		virtual uint64_t getSampleCount() const { return 0; }
+		//! the most recent samples a graph shows, oldest first, at most getSampleCapacity() of them
+		virtual void getSamples( std::vector<float> &aSamples ) const { aSamples.clear(); }
+		virtual int getSampleCapacity() const { return 0; }
 		
 		virtual void press() { }
 		virtual void release() { }
 		virtual void handleMouseDown( const ci::Vec2i &aMousePos, const bool isRight ) { }
 		virtual void handleMouseUp( const ci::Vec2i &aMousePos ) { }
 		virtual void handleMouseDrag( const ci::Vec2i &aMousePos ) { }
+		//! a value from a hardware controller, normalized as in ExternalInputEvent
+		virtual void handleExternalValue( const int &aChannel, const float &aValue ) { }
 		
 		static int DEFAULT_HEIGHT;
 
@@ -80,31 +145,52 @@ namespace MinimalUI {
 		ci::Vec2i mPosition;
 		ci::Vec2i mSize;
 		ci::Area mBounds;
+		//! from "cached", if it's given; elements that look the same from one refresh to the next default to true
+		bool mStatic;
+		
+		void notifyValueChanged( const int &aChannel, const float &aValue );
+		//! called after relayout() has moved the element, to update anything derived from its bounds
+		virtual void boundsChanged() { }
 		
 	private:
 		// disable copy and operator=
 		UIElement(const UIElement&);
 		UIElement & operator=(const UIElement&);
 		
-		void mouseDown( ci::app::MouseEvent &event );
+		// mouse events are dispatched by the controller, topmost element first
+		friend class UIController;
+		bool mouseDown( ci::app::MouseEvent &event );
 		void mouseUp( ci::app::MouseEvent &event );
 		void mouseDrag( ci::app::MouseEvent &event );
-		
-		ci::signals::scoped_connection mCbMouseDown, mCbMouseUp, mCbMouseDrag;
+		// touches are hit tested and captured by the controller, and drive the same handlers as the mouse
+		void touchBegan( const ci::Vec2i &aPos );
+		void touchMoved( const ci::Vec2i &aPos );
+		void touchEnded( const ci::Vec2i &aPos );
 
 		UIController *mParent;
-		ci::JsonTree mParams;
+		Section *mSection;
+		int mId;
+		Params mParams;
 		std::string mName;
 		std::string mGroup;
-		ci::Font mFont;
+		std::string mFontStyle;
+		float mNameTextureScale;
 		ci::TextBox::Alignment mAlignment;
 		ci::gl::Texture mBackgroundTexture;
+		TextureAtlas::Region mBackgroundRegion;
+		PendingImage mPendingBackground;
 		ci::gl::Texture mNameTexture;
+		bool mNameTextureWanted;
+		//! set on the model thread: the name changed, or the texture is to be freed, on the main thread
+		bool mNameTextureDirty, mNameTextureReleased;
 		ci::ColorA mBackgroundColor, mForegroundColor, mNameColor;
 		bool mActive;
+		bool mTouched;
 		bool mLocked;
 		bool mIcon;
 		bool mClear;
+		//! set when a static element's look changes, until the controller has redrawn its layer
+		bool mLayerDirty;
 
 	};
 	
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "UIController.h"
+
+#include <map>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class UIManager> UIManagerRef;
+
+	//! Owns every panel in a window. Fonts, image textures and the texture atlas are shared between panels, mouse input
+	//! is hit tested once, from the topmost panel down, and all panels are composited in a single pass.
+	class UIManager {
+	public:
+		UIManager( ci::app::WindowRef aWindow );
+		static UIManagerRef create( ci::app::WindowRef aWindow = ci::app::App::get()->getWindow() );
+
+		//! panels are stacked by their "depth" param, then by creation order; higher is on top
+		UIControllerRef addController( const std::string &aParamString = "{}" );
+		void removeController( const UIControllerRef &aController );
+		const std::vector<UIControllerRef> & getControllers() const { return mControllers; }
+
+		void update();
+		void draw();
+
+		//! the font for a style, at the window's content scale; setFont() takes fonts sized in points
+		ci::Font getFont( const std::string &aStyle );
+		void setFont( const std::string &aStyle, const ci::Font &aFont );
+		//! re-rasterizes fonts and glyphs if the window's content scale has changed; happens when the window changes display
+		void displayChanged();
+		ci::gl::Texture loadTexture( const std::string &aAssetPath );
+		//! one atlas of background images and icons for every panel, so skinned panels share pages
+		TextureAtlasRef getTextureAtlas() { return mTextureAtlas; }
+		GlyphAtlasRef getGlyphAtlas( const std::string &aStyle );
+		void flushGlyphAtlases();
+
+		ci::app::WindowRef getWindow() const { return mWindow; }
+
+	private:
+		void mouseDown( ci::app::MouseEvent &event );
+		void mouseUp( ci::app::MouseEvent &event );
+		void mouseDrag( ci::app::MouseEvent &event );
+		void touchesBegan( ci::app::TouchEvent &event );
+		void touchesMoved( ci::app::TouchEvent &event );
+		void touchesEnded( ci::app::TouchEvent &event );
+		//! hands each panel its share of a batch of touches in one call; aOwners gives each touch's panel, or null
+		void routeTouches( const std::vector<ci::app::TouchEvent::Touch> &aTouches, const bool &aEnded );
+		void dispatchTouches( const TouchPoint *aTouches, UIController **aOwners, const size_t &aCount, UIController::TouchHandler aHandler );
+		void sortControllers();
+
+		ci::app::WindowRef mWindow;
+		ci::signals::scoped_connection mCbMouseDown, mCbMouseUp, mCbMouseDrag;
+		ci::signals::scoped_connection mCbTouchesBegan, mCbTouchesMoved, mCbTouchesEnded;
+		ci::signals::scoped_connection mCbDisplayChange;
+
+		// bottom to top
+		std::vector<UIControllerRef> mControllers;
+		UIController *mCapture;
+		// the panel each touch began on, which gets the rest of it
+		struct TouchCapture {
+			uint32_t mId;
+			UIController *mController;
+		};
+		TouchCapture mTouches[UIController::MAX_TOUCHES];
+
+		std::map<std::string, ci::Font> mFonts;
+		std::map<std::string, ci::Font> mScaledFonts;
+		float mFontScale;
+		std::map<std::string, ci::gl::Texture> mTextures;
+		std::map<std::string, GlyphAtlasRef> mGlyphAtlases;
+		TextureAtlasRef mTextureAtlas;
+	};
+
+}
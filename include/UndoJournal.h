@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class UndoJournal> UndoJournalRef;
+
+	//! Bounded undo/redo history of value changes. Recent entries live uncompressed in a fixed ring; when the ring fills up,
+	//! its oldest entries are delta-encoded into compressed blocks, and the oldest blocks are discarded once the memory budget is used up.
+	//! Redo history is limited to what fits in the ring.
+	class UndoJournal {
+	public:
+		//! one changed channel; a step (one gesture) is a run of entries starting with mStepStart
+		struct Entry {
+			uint32_t mElementId;
+			uint8_t mChannel;
+			bool mStepStart;
+			float mBefore;
+			float mAfter;
+		};
+
+		UndoJournal( const size_t &aMemoryBudget, const size_t &aRingSize );
+		static UndoJournalRef create( const size_t &aMemoryBudget = DEFAULT_MEMORY_BUDGET, const size_t &aRingSize = DEFAULT_RING_SIZE );
+
+		//! appends an entry, discarding anything that could have been redone
+		void push( const Entry &aEntry );
+
+		//! reverts the most recent step, calling aApply for each of its entries in reverse order
+		bool undo( const std::function<void( const Entry& )> &aApply );
+		//! re-applies the step after the cursor, calling aApply for each of its entries in order
+		bool redo( const std::function<void( const Entry& )> &aApply );
+
+		bool canUndo() const { return mCursor != mBegin || !mBlocks.empty(); }
+		bool canRedo() const { return mCursor != mEnd; }
+		void clear();
+
+		//! bytes used by the ring and the compressed blocks
+		size_t getMemoryUsage() const { return mRing.size() * sizeof( Entry ) + mCompressedBytes; }
+
+		static size_t DEFAULT_MEMORY_BUDGET;
+		static size_t DEFAULT_RING_SIZE;
+		static size_t BLOCK_SIZE;
+
+	private:
+		// disable copy and operator=
+		UndoJournal( const UndoJournal& );
+		UndoJournal & operator=( const UndoJournal& );
+
+		Entry & at( const uint64_t &aIndex ) { return mRing[aIndex & mMask]; }
+		void compressOldest();
+		void decompressNewest();
+
+		std::vector<Entry> mRing;
+		uint64_t mMask;
+		// absolute indices: [mBegin, mCursor) can be undone, [mCursor, mEnd) can be redone
+		uint64_t mBegin, mCursor, mEnd;
+
+		std::deque< std::vector<uint8_t> > mBlocks;
+		size_t mCompressedBytes;
+		size_t mMemoryBudget;
+		std::vector<Entry> mScratch;
+	};
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace MinimalUI {
+
+	// compact integer encodings shared by the binary formats (automation, undo journal)
+
+	inline void writeVarint( std::vector<uint8_t> &aBuffer, uint64_t aValue )
+	{
+		while ( aValue >= 0x80 ) {
+			aBuffer.push_back( (uint8_t)( aValue | 0x80 ) );
+			aValue >>= 7;
+		}
+		aBuffer.push_back( (uint8_t)aValue );
+	}
+
+	//! reads a varint from [aData + aPosition, aData + aSize), advancing aPosition; returns false if the data runs out
+	inline bool readVarint( const uint8_t *aData, const size_t &aSize, size_t &aPosition, uint64_t &aValue )
+	{
+		aValue = 0;
+		for ( int shift = 0; shift < 64 && aPosition < aSize; shift += 7 ) {
+			uint8_t byte = aData[aPosition++];
+			aValue |= (uint64_t)( byte & 0x7F ) << shift;
+			if ( !( byte & 0x80 ) ) return true;
+		}
+		return false;
+	}
+
+	inline uint32_t zigzagEncode( const int32_t &aValue ) { return ( (uint32_t)aValue << 1 ) ^ (uint32_t)( aValue >> 31 ); }
+	inline int32_t zigzagDecode( const uint32_t &aValue ) { return (int32_t)( ( aValue >> 1 ) ^ ( 0u - ( aValue & 1 ) ) ); }
+
+	//! raw float bits; deltas between them are small for nearby values of the same sign
+	inline uint32_t floatBits( const float &aValue ) { uint32_t bits; memcpy( &bits, &aValue, sizeof( bits ) ); return bits; }
+	inline float bitsFloat( const uint32_t &aBits ) { float value; memcpy( &value, &aBits, sizeof( value ) ); return value; }
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace MinimalUI {
+
+	typedef std::shared_ptr<class WorkerPool> WorkerPoolRef;
+
+	//! A fixed set of worker threads for data-parallel element work (colormapping, binning, decoding).
+	class WorkerPool {
+	public:
+		//! aNumThreads of 0 uses one thread per core, less the calling thread
+		explicit WorkerPool( const size_t &aNumThreads );
+		~WorkerPool();
+		static WorkerPoolRef create( const size_t &aNumThreads = 0 );
+
+		//! the pool shared by all elements, created on first use
+		static WorkerPool & getShared();
+
+		//! queues a task to run on a worker
+		void enqueue( const std::function<void()> &aTask );
+
+		//! splits [0, aCount) into chunks of at least aMinChunk and runs aTask( begin, end ) on each, using the calling
+		//! thread as well; returns once every chunk is done
+		void parallelFor( const size_t &aCount, const std::function<void( size_t, size_t )> &aTask, const size_t &aMinChunk = 1 );
+
+		//! number of worker threads, not counting the caller of parallelFor()
+		size_t getNumThreads() const { return mThreads.size(); }
+
+	private:
+		// disable copy and operator=
+		WorkerPool( const WorkerPool& );
+		WorkerPool & operator=( const WorkerPool& );
+
+		void run();
+
+		std::vector<std::thread> mThreads;
+		std::deque< std::function<void()> > mTasks;
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		bool mStopping;
+	};
+
+}
@@ -0,0 +1,72 @@
+#include "ParamBridge.h"
+
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+using namespace MinimalUI;
+
+// Reads what ParamBridgeWriterApp publishes, from a second process, and prints what a poll and a read cost. Doesn't
+// need Cinder: build it from this file, src/ParamBridgeClient.cpp and src/SharedMemory.cpp, with include/ on the
+// include path (and -lrt on older Linux). Takes the number of seconds to run, 10 by default.
+
+static const char *BRIDGE_NAME = "MinimalUIBridgeSample";
+static const int READS_PER_REPORT = 1000000;
+
+static double nanosecondsSince( const chrono::steady_clock::time_point &aStart )
+{
+	return chrono::duration<double, nano>( chrono::steady_clock::now() - aStart ).count();
+}
+
+int main( int argc, char *argv[] )
+{
+	const int seconds = argc > 1 ? atoi( argv[1] ) : 10;
+
+	// give the writer a few seconds to start
+	ParamBridgeClientRef client;
+	for ( int i = 0; i < 50 && !client; i++ ) {
+		client = ParamBridgeClient::open( BRIDGE_NAME );
+		if ( !client ) this_thread::sleep_for( chrono::milliseconds( 100 ) );
+	}
+	if ( !client ) {
+		fprintf( stderr, "No bridge named %s; start ParamBridgeWriterApp first\n", BRIDGE_NAME );
+		return 1;
+	}
+
+	const chrono::steady_clock::time_point end = chrono::steady_clock::now() + chrono::seconds( seconds );
+	volatile float sink = 0.0f;
+	while ( chrono::steady_clock::now() < end ) {
+		const int numSlots = client->getNumSlots();
+		if ( numSlots == 0 ) {
+			this_thread::sleep_for( chrono::milliseconds( 100 ) );
+			continue;
+		}
+
+		// once, as a renderer would each frame
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		const size_t numChanged = client->poll().size();
+		const double pollTime = nanosecondsSince( start );
+
+		// many times, since a single read is shorter than the clock can measure
+		float values[PARAM_BRIDGE_MAX_VALUES];
+		start = chrono::steady_clock::now();
+		for ( int i = 0; i < READS_PER_REPORT; i++ ) {
+			client->getValues( i % numSlots, values );
+			sink = sink + values[0];
+		}
+		const double readTime = nanosecondsSince( start ) / READS_PER_REPORT;
+
+		printf( "%d slots, %u changed: poll %.0f ns, read %.1f ns\n", numSlots, (unsigned)numChanged, pollTime, readTime );
+		for ( int slot = 0; slot < numSlots; slot++ ) {
+			const int numValues = client->getValues( slot, values );
+			printf( "  %-12s", client->getSlotName( slot ).c_str() );
+			for ( int channel = 0; channel < numValues; channel++ ) printf( " %8.4f", values[channel] );
+			printf( "\n" );
+		}
+
+		this_thread::sleep_for( chrono::seconds( 1 ) );
+	}
+	return 0;
+}
@@ -0,0 +1,61 @@
+#include "cinder/app/AppNative.h"
+
+#include "UIController.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// publishes a panel's values through a ParamBridge; run ParamBridgeReader alongside it to read them from another process
+class ParamBridgeWriterApp : public AppNative {
+public:
+	void setup();
+	void update();
+	void draw();
+
+private:
+	MinimalUI::UIControllerRef mParams;
+
+	float mSine;
+	float mRamp;
+	Vec2f mCircle;
+	float mManual;
+};
+
+void ParamBridgeWriterApp::setup()
+{
+	mSine = mRamp = mManual = 0.0f;
+	mCircle = Vec2f::zero();
+
+	mParams = MinimalUI::UIController::create();
+
+	// animated every frame, so the reader sees a change on each poll
+	mParams->addSlider( "Sine", &mSine, MinimalUI::SliderParams().min( -1.0 ).max( 1.0 ) );
+	mParams->addSlider( "Ramp", &mRamp );
+	mParams->addSlider2D( "Circle", &mCircle, MinimalUI::Slider2DParams().minX( -1.0 ).maxX( 1.0 ).minY( -1.0 ).maxY( 1.0 ) );
+	// only changes when dragged
+	mParams->addSlider( "Manual", &mManual );
+
+	if ( !mParams->startBridge( "MinimalUIBridgeSample" ) ) {
+		console() << "Can't create the shared memory segment" << endl;
+	}
+}
+
+void ParamBridgeWriterApp::update()
+{
+	const float time = (float)getElapsedSeconds();
+	mSine = math<float>::sin( time );
+	mRamp = time - math<float>::floor( time );
+	mCircle = Vec2f( math<float>::cos( time ), math<float>::sin( time ) );
+
+	// publishes everything that changed
+	mParams->update();
+}
+
+void ParamBridgeWriterApp::draw()
+{
+	gl::clear();
+	mParams->draw();
+}
+
+CINDER_APP_NATIVE( ParamBridgeWriterApp, RendererGl )
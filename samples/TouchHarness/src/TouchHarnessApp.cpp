@@ -0,0 +1,155 @@
+#include "cinder/app/AppNative.h"
+#include "cinder/Utilities.h"
+
+#include "UIController.h"
+#include "UIElement.h"
+
+#include <new>
+#include <cstdlib>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+// Drives a panel of sliders with synthetic touch frames of up to 24 simultaneous touches, through the TouchPoint overloads,
+// and checks that every touch captures the slider it began on and keeps it until it ends. Nothing is drawn: the window is
+// hidden, and the app prints its results to the console and quits.
+
+// counts allocations while sTracking is set, to see whether the touch path allocates per touch
+static bool sTracking = false;
+static size_t sAllocations = 0;
+
+void * operator new( size_t aSize )
+{
+	if ( sTracking ) sAllocations++;
+	void *data = malloc( aSize ? aSize : 1 );
+	if ( !data ) throw bad_alloc();
+	return data;
+}
+
+void operator delete( void *aData ) throw()
+{
+	free( aData );
+}
+
+class TouchHarnessApp : public AppNative {
+public:
+	void setup();
+
+private:
+	void check( const bool &aPassed, const string &aDescription );
+	//! a touch on slider aSlider, at aFraction of its width, and aRows slider heights below its center
+	TouchPoint touchOn( const int &aSlider, const float &aFraction, const float &aRows = 0.0f );
+
+	static const int NUM_SLIDERS = 24;
+
+	UIControllerRef mParams;
+	UIElementRef mSliders[NUM_SLIDERS];
+	float mValues[NUM_SLIDERS];
+	int mNumFailed;
+};
+
+void TouchHarnessApp::setup()
+{
+	getWindow()->hide();
+	mNumFailed = 0;
+
+	mParams = UIController::create( "{ \"height\": 2000 }" );
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) {
+		mValues[i] = 0.0f;
+		mSliders[i] = mParams->addSlider( "Slider " + toString( i ), &mValues[i] );
+	}
+
+	// a warm-up touch, so the touch index is built before anything is counted
+	TouchPoint warmup = touchOn( 0, 0.5f );
+	warmup.mId = 1000;
+	mParams->touchesBegan( &warmup, 1 );
+	mParams->touchesEnded( &warmup, 1 );
+
+	// every slider touched in the same frame, near its left end
+	TouchPoint touches[NUM_SLIDERS];
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) touches[i] = touchOn( i, 0.25f );
+	sAllocations = 0;
+	sTracking = true;
+	mParams->touchesBegan( touches, NUM_SLIDERS );
+	sTracking = false;
+	const size_t beganAllocations = sAllocations;
+	check( mParams->getNumTouches() == NUM_SLIDERS, "every touch captures a slider" );
+	bool captured = true;
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) {
+		captured &= mParams->getTouchedElement( touches[i].mId ) == mSliders[i].get() && mSliders[i]->isActive();
+	}
+	check( captured, "each touch captures the slider it began on" );
+	float began[NUM_SLIDERS];
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) began[i] = mValues[i];
+
+	// all of them dragged right, and down off their slider onto the next one, which must not steal them
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) touches[i] = touchOn( i, 0.75f, 1.0f );
+	sAllocations = 0;
+	sTracking = true;
+	mParams->touchesMoved( touches, NUM_SLIDERS );
+	sTracking = false;
+	const size_t movedAllocations = sAllocations;
+	bool held = true, moved = true;
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) {
+		held &= mParams->getTouchedElement( touches[i].mId ) == mSliders[i].get();
+		moved &= mValues[i] > began[i];
+	}
+	check( held, "a touch keeps its slider when it moves off it" );
+	check( moved, "each slider follows its own touch" );
+
+	// a second touch on a slider that is already held is ignored
+	TouchPoint extra = touchOn( 0, 0.5f );
+	extra.mId = 2000;
+	mParams->touchesBegan( &extra, 1 );
+	check( mParams->getNumTouches() == NUM_SLIDERS && !mParams->getTouchedElement( extra.mId ), "a held slider isn't captured twice" );
+
+	// half of them lifted
+	for ( int i = 0; i < NUM_SLIDERS / 2; i++ ) touches[i] = touchOn( i, 0.75f );
+	mParams->touchesEnded( touches, NUM_SLIDERS / 2 );
+	bool released = true;
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) {
+		const bool lifted = i < NUM_SLIDERS / 2;
+		released &= mSliders[i]->isActive() != lifted && ( mParams->getTouchedElement( touches[i].mId ) == nullptr ) == lifted;
+	}
+	check( mParams->getNumTouches() == NUM_SLIDERS - NUM_SLIDERS / 2 && released, "lifting a touch releases only its slider" );
+
+	// a lifted slider can be captured again while the others are still held
+	TouchPoint again = touchOn( 0, 0.5f );
+	again.mId = 3000;
+	mParams->touchesBegan( &again, 1 );
+	check( mParams->getTouchedElement( again.mId ) == mSliders[0].get(), "a released slider can be captured by a new touch" );
+	mParams->touchesEnded( &again, 1 );
+
+	// the rest lifted, plus ids that aren't down, which are ignored
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) touches[i] = touchOn( i, 0.75f );
+	mParams->touchesEnded( touches, NUM_SLIDERS );
+	mParams->touchesEnded( &extra, 1 );
+	bool idle = true;
+	for ( int i = 0; i < NUM_SLIDERS; i++ ) idle &= !mSliders[i]->isActive();
+	check( mParams->getNumTouches() == 0 && idle, "every slider is released once all touches end" );
+
+	console() << "allocations: " << beganAllocations << " in the began frame, " << movedAllocations << " in the moved frame, for " << NUM_SLIDERS << " touches" << endl;
+	console() << ( mNumFailed == 0 ? "all checks passed" : toString( mNumFailed ) + " checks failed" ) << endl;
+	quit();
+}
+
+void TouchHarnessApp::check( const bool &aPassed, const string &aDescription )
+{
+	console() << ( aPassed ? "pass: " : "FAIL: " ) << aDescription << endl;
+	if ( !aPassed ) mNumFailed++;
+}
+
+TouchPoint TouchHarnessApp::touchOn( const int &aSlider, const float &aFraction, const float &aRows )
+{
+	// touches are in window points; element bounds are in pixels, relative to the panel
+	const Vec2f upperLeft( toPoints( mSliders[aSlider]->getBounds().getUL() ) );
+	const Vec2f size( toPoints( mSliders[aSlider]->getSize() ) );
+	TouchPoint touch;
+	touch.mId = aSlider;
+	touch.mPos = Vec2f( mParams->getPosition() ) + upperLeft + Vec2f( size.x * aFraction, size.y * ( 0.5f + aRows ) );
+	return touch;
+}
+
+CINDER_APP_NATIVE( TouchHarnessApp, RendererGl )
@@ -0,0 +1,322 @@
+#include "Automation.h"
+#include "UIController.h"
+#include "UIElement.h"
+#include "VarInt.h"
+
+#include <cstring>
+
+using namespace std;
+using namespace MinimalUI;
+
+size_t AutomationRecorder::DEFAULT_QUEUE_SIZE = 1 << 16;
+size_t AutomationRecorder::DEFAULT_FLUSH_SIZE = 1 << 16;
+
+double AutomationPlayer::DEFAULT_RATE = 1000.0;
+double AutomationPlayer::DEFAULT_MAX_RAMP_TIME = 0.1;
+double AutomationPlayer::DEFAULT_LOOKAHEAD = 0.5;
+size_t AutomationPlayer::DEFAULT_READ_SIZE = 1 << 16;
+size_t AutomationPlayer::DEFAULT_MAX_TRACKS = 1024;
+
+// file format: a 4 byte magic, then one record per event:
+//   varint  time delta since the previous event, in microseconds
+//   varint  element id
+//   byte    channel
+//   varint  zigzag delta of the value's bits against the previous value of the same element and channel
+static const char AUTOMATION_MAGIC[4] = { 'M', 'U', 'I', 'A' };
+
+static uint64_t trackKey( const uint32_t &aElementId, const uint8_t &aChannel )
+{
+	return ( (uint64_t)aElementId << 8 ) | aChannel;
+}
+
+// AutomationRecorder
+AutomationRecorder::AutomationRecorder( const string &aPath, const size_t &aQueueSize )
+	: mQueue( aQueueSize ), mNumRecorded( 0 ), mNumDropped( 0 ), mPreviousTime( 0 ), mRunning( true )
+{
+	mFile.open( aPath.c_str(), ios::binary | ios::trunc );
+	if ( !mFile ) throw AutomationExc( aPath );
+	mFile.write( AUTOMATION_MAGIC, sizeof( AUTOMATION_MAGIC ) );
+
+	mBuffer.reserve( DEFAULT_FLUSH_SIZE + 32 );
+	mStartTime = chrono::steady_clock::now();
+	mThread = thread( &AutomationRecorder::writerThread, this );
+}
+
+AutomationRecorder::~AutomationRecorder()
+{
+	stop();
+}
+
+AutomationRecorderRef AutomationRecorder::create( const string &aPath, const size_t &aQueueSize )
+{
+	return shared_ptr<AutomationRecorder>( new AutomationRecorder( aPath, aQueueSize ) );
+}
+
+void AutomationRecorder::record( const uint32_t &aElementId, const uint8_t &aChannel, const float &aValue )
+{
+	AutomationEvent event;
+	event.mTime = chrono::duration_cast<chrono::nanoseconds>( chrono::steady_clock::now() - mStartTime ).count();
+	event.mElementId = aElementId;
+	event.mChannel = aChannel;
+	event.mValue = aValue;
+	if ( mQueue.push( event ) ) {
+		mNumRecorded++;
+	} else {
+		mNumDropped.fetch_add( 1, memory_order_relaxed );
+	}
+}
+
+void AutomationRecorder::stop()
+{
+	if ( !mRunning.exchange( false ) )
+		return;
+
+	mWakeup.notify_one();
+	if ( mThread.joinable() ) mThread.join();
+	mFile.close();
+}
+
+void AutomationRecorder::writerThread()
+{
+	AutomationEvent event;
+	for (;;) {
+		bool running = mRunning;
+		while ( mQueue.pop( event ) ) {
+			encode( event );
+			if ( mBuffer.size() >= DEFAULT_FLUSH_SIZE ) flush();
+		}
+		if ( !running ) break;
+
+		// the producer never signals; just wake up often enough to keep the queue short
+		unique_lock<mutex> lock( mMutex );
+		mWakeup.wait_for( lock, chrono::milliseconds( 5 ) );
+	}
+	flush();
+}
+
+void AutomationRecorder::encode( const AutomationEvent &aEvent )
+{
+	// microsecond resolution is plenty for UI input and keeps the deltas short
+	int64_t time = aEvent.mTime / 1000;
+	writeVarint( mBuffer, (uint64_t)( time - mPreviousTime ) );
+	mPreviousTime = time;
+
+	writeVarint( mBuffer, aEvent.mElementId );
+	mBuffer.push_back( aEvent.mChannel );
+
+	uint32_t bits = floatBits( aEvent.mValue );
+	uint32_t &previous = mPreviousBits[trackKey( aEvent.mElementId, aEvent.mChannel )];
+	writeVarint( mBuffer, zigzagEncode( (int32_t)( bits - previous ) ) );
+	previous = bits;
+}
+
+void AutomationRecorder::flush()
+{
+	if ( mBuffer.empty() )
+		return;
+
+	mFile.write( (const char *)mBuffer.data(), mBuffer.size() );
+	mFile.flush();
+	mBuffer.clear();
+}
+
+// AutomationPlayer
+AutomationPlayer::AutomationPlayer( UIController *aUIController, const string &aPath )
+	: mParent( aUIController ), mReadPosition( 0 ), mReadSize( 0 ), mEndOfFile( false ), mDecodedTime( 0 ),
+	mEvents( AutomationRecorder::DEFAULT_QUEUE_SIZE ), mSlots( DEFAULT_MAX_TRACKS ), mNumSlots( 0 ), mRunning( false )
+{
+	mFile.open( aPath.c_str(), ios::binary );
+	char magic[sizeof( AUTOMATION_MAGIC )];
+	if ( !mFile || !mFile.read( magic, sizeof( magic ) ) || memcmp( magic, AUTOMATION_MAGIC, sizeof( magic ) ) != 0 ) {
+		throw AutomationExc( aPath );
+	}
+	mReadBuffer.resize( DEFAULT_READ_SIZE );
+}
+
+AutomationPlayer::~AutomationPlayer()
+{
+	stop();
+}
+
+AutomationPlayerRef AutomationPlayer::create( UIController *aUIController, const string &aPath )
+{
+	return shared_ptr<AutomationPlayer>( new AutomationPlayer( aUIController, aPath ) );
+}
+
+void AutomationPlayer::start( const double &aRate )
+{
+	if ( mRunning.exchange( true ) )
+		return;
+
+	if ( mThread.joinable() ) mThread.join();
+	mThread = thread( &AutomationPlayer::playbackThread, this, aRate );
+}
+
+void AutomationPlayer::stop()
+{
+	mRunning = false;
+	if ( mThread.joinable() ) mThread.join();
+}
+
+void AutomationPlayer::update()
+{
+	// however many ticks there were since the last update, a continuous track is applied once, at its newest value
+	const size_t numSlots = mNumSlots.load( memory_order_acquire );
+	for ( size_t i = 0; i < numSlots; i++ ) {
+		Slot &slot = mSlots[i];
+		if ( !slot.mChanged.exchange( false, memory_order_acquire ) ) continue;
+		UIElementRef element = mParent->getElement( slot.mElementId );
+		if ( element ) element->setValue( slot.mChannel, bitsFloat( slot.mBits.load( memory_order_relaxed ) ) );
+	}
+
+	AutomationEvent event;
+	while ( mEvents.pop( event ) ) {
+		UIElementRef element = mParent->getElement( event.mElementId );
+		if ( element ) element->setValue( event.mChannel, event.mValue );
+	}
+}
+
+bool AutomationPlayer::getValue( const uint32_t &aElementId, const uint8_t &aChannel, float &aValue ) const
+{
+	const size_t numSlots = mNumSlots.load( memory_order_acquire );
+	for ( size_t i = 0; i < numSlots; i++ ) {
+		const Slot &slot = mSlots[i];
+		if ( slot.mElementId != aElementId || slot.mChannel != aChannel ) continue;
+		aValue = bitsFloat( slot.mBits.load( memory_order_relaxed ) );
+		return true;
+	}
+	return false;
+}
+
+void AutomationPlayer::playbackThread( const double &aRate )
+{
+	const chrono::nanoseconds period( (int64_t)( 1.0e9 / aRate ) );
+	const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	chrono::steady_clock::time_point next = startTime;
+
+	while ( mRunning ) {
+		tick( chrono::duration_cast<chrono::nanoseconds>( chrono::steady_clock::now() - startTime ).count() );
+
+		if ( mEndOfFile ) {
+			bool pending = false;
+			for ( map<uint64_t, Track>::iterator it = mTracks.begin(); it != mTracks.end(); ++it ) {
+				if ( !it->second.mPending.empty() ) { pending = true; break; }
+			}
+			if ( !pending ) break;
+		}
+
+		next += period;
+		this_thread::sleep_until( next );
+	}
+	mRunning = false;
+}
+
+void AutomationPlayer::tick( const int64_t &aTime )
+{
+	// stream events in from disk until we're far enough ahead to interpolate
+	const int64_t lookahead = aTime + (int64_t)( DEFAULT_LOOKAHEAD * 1.0e9 );
+	AutomationEvent event;
+	while ( !mEndOfFile && mDecodedTime <= lookahead && decodeNext( event ) ) {
+		Track &track = mTracks[trackKey( event.mElementId, event.mChannel )];
+		if ( !track.mElement ) {
+			UIElementRef element = mParent->getElement( event.mElementId );
+			if ( !element ) continue;
+			track.mElement = element.get();
+			track.mContinuous = element->hasContinuousValues();
+		}
+		track.mPending.push_back( event );
+	}
+
+	for ( map<uint64_t, Track>::iterator it = mTracks.begin(); it != mTracks.end(); ++it ) {
+		Track &track = it->second;
+		if ( !track.mElement ) continue;
+
+		while ( !track.mPending.empty() && track.mPending.front().mTime <= aTime ) {
+			track.mLast = track.mPending.front();
+			track.mHasLast = true;
+			track.mPending.pop_front();
+			if ( !track.mContinuous ) mEvents.push( track.mLast );
+		}
+
+		if ( !track.mContinuous || !track.mHasLast ) continue;
+
+		// ramp between events of one gesture; a longer gap is held until the next event
+		float value = track.mLast.mValue;
+		if ( !track.mPending.empty() ) {
+			const AutomationEvent &next = track.mPending.front();
+			const int64_t gap = next.mTime - track.mLast.mTime;
+			if ( gap <= (int64_t)( DEFAULT_MAX_RAMP_TIME * 1.0e9 ) ) {
+				float t = (float)( aTime - track.mLast.mTime ) / (float)gap;
+				value += ( next.mValue - value ) * t;
+			}
+		}
+		if ( value == track.mApplied ) continue;
+		const size_t numSlots = mNumSlots.load( memory_order_relaxed );
+		if ( track.mSlot < 0 && numSlots < mSlots.size() ) {
+			// published with its first value in place
+			Slot &slot = mSlots[numSlots];
+			slot.mElementId = track.mLast.mElementId;
+			slot.mChannel = track.mLast.mChannel;
+			slot.mBits.store( floatBits( value ), memory_order_relaxed );
+			slot.mChanged.store( true, memory_order_relaxed );
+			track.mSlot = (int)numSlots;
+			track.mApplied = value;
+			mNumSlots.store( numSlots + 1, memory_order_release );
+		} else if ( track.mSlot >= 0 ) {
+			// overwrites a value update() hasn't picked up yet, rather than queueing one per tick
+			Slot &slot = mSlots[track.mSlot];
+			slot.mBits.store( floatBits( value ), memory_order_relaxed );
+			slot.mChanged.store( true, memory_order_release );
+			track.mApplied = value;
+		} else {
+			// tried again next tick if the controller has fallen behind
+			AutomationEvent applied = track.mLast;
+			applied.mValue = value;
+			if ( mEvents.push( applied ) ) track.mApplied = value;
+		}
+	}
+}
+
+bool AutomationPlayer::decodeNext( AutomationEvent &aEvent )
+{
+	uint64_t timeDelta, elementId, zigzag;
+	uint8_t channel;
+	if ( !readVarint( timeDelta ) || !readVarint( elementId ) || !readByte( channel ) || !readVarint( zigzag ) ) {
+		mEndOfFile = true;
+		return false;
+	}
+
+	mDecodedTime += (int64_t)timeDelta * 1000;
+	aEvent.mTime = mDecodedTime;
+	aEvent.mElementId = (uint32_t)elementId;
+	aEvent.mChannel = channel;
+
+	uint32_t &previous = mPreviousBits[trackKey( aEvent.mElementId, aEvent.mChannel )];
+	previous += (uint32_t)zigzagDecode( (uint32_t)zigzag );
+	aEvent.mValue = bitsFloat( previous );
+	return true;
+}
+
+bool AutomationPlayer::readByte( uint8_t &aByte )
+{
+	if ( mReadPosition == mReadSize ) {
+		mFile.read( (char *)mReadBuffer.data(), mReadBuffer.size() );
+		mReadSize = (size_t)mFile.gcount();
+		mReadPosition = 0;
+		if ( mReadSize == 0 ) return false;
+	}
+	aByte = mReadBuffer[mReadPosition++];
+	return true;
+}
+
+bool AutomationPlayer::readVarint( uint64_t &aValue )
+{
+	aValue = 0;
+	uint8_t byte;
+	for ( int shift = 0; shift < 64; shift += 7 ) {
+		if ( !readByte( byte ) ) return false;
+		aValue |= (uint64_t)( byte & 0x7F ) << shift;
+		if ( !( byte & 0x80 ) ) return true;
+	}
+	return false;
+}
@@ -8,12 +8,13 @@ using namespace MinimalUI;
 int Button::DEFAULT_WIDTH = UIElement::DEFAULT_HEIGHT;
 int Button::DEFAULT_HEIGHT = UIElement::DEFAULT_HEIGHT;
 
-Button::Button( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, const string &aParamString )
-: UIElement( aUIController, aName, aParamString )
+Button::Button( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, const Params &aParams )
+: UIElement( aUIController, aName, aParams )
 {
 	// initialize unique variables
 	addEventHandler( aEventHandler );
 	mPressed = hasParam( "pressed" ) ? getParam<bool>( "pressed" ) : false;
+	mStatic = hasParam( "cached" ) ? getParam<bool>( "cached" ) : true;
 	mStateless = hasParam( "stateless" ) ? getParam<bool>( "stateless" ) : true;
 	mExclusive = hasParam( "exclusive" ) ? getParam<bool>( "exclusive" ) : false;
 	mCallbackOnRelease = hasParam( "callbackOnRelease" ) ? getParam<bool>( "callbackOnRelease" ) : true;
@@ -29,28 +30,23 @@ Button::Button( UIController *aUIController, const string &aName, const std::fun
 	setPositionAndBounds();
 }
 
-UIElementRef Button::create( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, const string &aParamString )
+UIElementRef Button::create( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, const Params &aParams )
 {
-	return shared_ptr<Button>( new Button( aUIController, aName, aEventHandler, aParamString ) );
+	return shared_ptr<Button>( new Button( aUIController, aName, aEventHandler, aParams ) );
 }
 
-void Button::draw()
+ColorA Button::getFillColor() const
 {
-	// set the color
 	if ( isActive() ) {
-		gl::color( UIController::ACTIVE_STROKE_COLOR );
+		return UIController::ACTIVE_STROKE_COLOR;
 	} else if ( mPressed ) {
-		gl::color( UIController::DEFAULT_STROKE_COLOR );
-	} else {
-		gl::color( getBackgroundColor() );
+		return UIController::DEFAULT_STROKE_COLOR;
 	}
+	return getBackgroundColor();
+}
 
-	// draw the button background
-	gl::drawSolidRect( getBounds() );
-
-	// draw the background
-	drawBackground();
-
+void Button::draw()
+{
 	// set the color
 	if ( isActive() ) {
 		gl::color( UIController::ACTIVE_STROKE_COLOR );
@@ -88,6 +84,7 @@ void Button::handleMouseUp( const Vec2i &aMousePos )
 	if ( mStateless ) {
 		// mPressed should always be false if it's a stateless button; just call the handler
 		callEventHandlers();
+		notifyValueChanged( 0, 1.0f );
 		
 	} else {
 		if ( mPressed ) {
@@ -96,6 +93,7 @@ void Button::handleMouseUp( const Vec2i &aMousePos )
 				// release the button
 				mPressed = false;
 				callEventHandlers();
+				notifyValueChanged( 0, 0.0f );
 			}
 		} else {
 			// if the button is an exclusive group and isn't pressed, release all the buttons in the group first
@@ -105,7 +103,22 @@ void Button::handleMouseUp( const Vec2i &aMousePos )
 			// press the button
 			mPressed = true;
 			callEventHandlers();
+			notifyValueChanged( 0, 1.0f );
+		}
+	}
+}
+
+void Button::setValue( const int &aChannel, const float &aValue )
+{
+	bool pressed = aValue != 0.0f;
+	if ( mStateless ) {
+		if ( pressed ) callEventHandlers();
+	} else if ( pressed != mPressed ) {
+		if ( pressed && mExclusive ) {
+			getParent()->releaseGroup( getGroup() );
 		}
+		mPressed = pressed;
+		callEventHandlers();
 	}
 }
 
@@ -129,15 +142,15 @@ void Button::update()
 }
 
 
-LinkedButton::LinkedButton( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const string &aParamString )
-: Button( aUIController, aName, aEventHandler, aParamString )
+LinkedButton::LinkedButton( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const Params &aParams )
+: Button( aUIController, aName, aEventHandler, aParams )
 {
 	mLinkedState = aLinkedState;
 }
 
-UIElementRef LinkedButton::create( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const string &aParamString )
+UIElementRef LinkedButton::create( UIController *aUIController, const string &aName, const std::function<void( bool )>& aEventHandler, bool *aLinkedState, const Params &aParams )
 {
-	return shared_ptr<LinkedButton>( new LinkedButton( aUIController, aName, aEventHandler, aLinkedState, aParamString ) );
+	return shared_ptr<LinkedButton>( new LinkedButton( aUIController, aName, aEventHandler, aLinkedState, aParams ) );
 }
 
 void LinkedButton::update()
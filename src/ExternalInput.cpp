@@ -0,0 +1,64 @@
+#include "ExternalInput.h"
+
+#include <chrono>
+
+using namespace std;
+using namespace MinimalUI;
+
+size_t ExternalInput::DEFAULT_CAPACITY = 1024;
+double VirtualInputDevice::DEFAULT_RATE = 500.0;
+
+ExternalInput::ExternalInput( const size_t &aCapacity )
+	: mQueue( aCapacity ), mNumDropped( 0 )
+{
+}
+
+ExternalInputRef ExternalInput::create( const size_t &aCapacity )
+{
+	return shared_ptr<ExternalInput>( new ExternalInput( aCapacity ) );
+}
+
+void ExternalInput::push( const uint32_t &aElementId, const uint8_t &aChannel, const float &aValue )
+{
+	ExternalInputEvent event = { aElementId, aChannel, aValue };
+	if ( !mQueue.push( event ) ) mNumDropped++;
+}
+
+VirtualInputDevice::VirtualInputDevice( const ExternalInputRef &aInput )
+	: mInput( aInput ), mRunning( false )
+{
+}
+
+VirtualInputDevice::~VirtualInputDevice()
+{
+	stop();
+}
+
+VirtualInputDeviceRef VirtualInputDevice::create( const ExternalInputRef &aInput )
+{
+	return shared_ptr<VirtualInputDevice>( new VirtualInputDevice( aInput ) );
+}
+
+void VirtualInputDevice::sweep( const uint32_t &aElementId, const uint8_t &aChannel, const float &aFrom, const float &aTo, const double &aDuration, const double &aRate )
+{
+	stop();
+	mRunning = true;
+	ExternalInputRef input = mInput;
+	mThread = thread( [this, input, aElementId, aChannel, aFrom, aTo, aDuration, aRate] {
+		const chrono::nanoseconds period( (int64_t)( 1.0e9 / aRate ) );
+		const int64_t steps = max<int64_t>( (int64_t)( aDuration * aRate ), 1 );
+		chrono::steady_clock::time_point next = chrono::steady_clock::now();
+		for ( int64_t i = 0; i <= steps && mRunning; i++ ) {
+			input->push( aElementId, aChannel, aFrom + ( aTo - aFrom ) * (float)i / (float)steps );
+			next += period;
+			this_thread::sleep_until( next );
+		}
+		mRunning = false;
+	} );
+}
+
+void VirtualInputDevice::stop()
+{
+	mRunning = false;
+	if ( mThread.joinable() ) mThread.join();
+}
@@ -0,0 +1,225 @@
+#include "GlyphAtlas.h"
+
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+GlyphAtlas::GlyphAtlas( const Font &aFont )
+	: mFont( aFont ), mBuilt( false ), mLineHeight( 0.0f )
+{
+}
+
+void GlyphAtlas::build()
+{
+	if ( mBuilt ) return;
+	mBuilt = true;
+
+	// rasterize each character in white, so the current color tints it
+	Surface glyphs[NUM_CHARS];
+	int height = 0;
+	for ( int i = 0; i < NUM_CHARS; i++ ) {
+		char text[2] = { (char)( FIRST_CHAR + i ), 0 };
+		// a lone space renders empty, so measure it between two characters
+		TextBox textBox = TextBox().font( mFont ).color( ColorA::white() ).text( i == 0 ? "0 0" : text );
+		glyphs[i] = textBox.render();
+		height = math<int>::max( height, glyphs[i].getHeight() );
+	}
+	mLineHeight = (float)height;
+
+	// shelve them into one surface, a pixel apart so filtering doesn't bleed between glyphs
+	const int ATLAS_WIDTH = 512;
+	Vec2i position( 0, 0 );
+	Area areas[NUM_CHARS];
+	for ( int i = 0; i < NUM_CHARS; i++ ) {
+		int width = glyphs[i].getWidth();
+		if ( position.x + width > ATLAS_WIDTH ) position = Vec2i( 0, position.y + height + 1 );
+		areas[i] = Area( position, position + Vec2i( width, glyphs[i].getHeight() ) );
+		position.x += width + 1;
+	}
+	Surface atlas( ATLAS_WIDTH, position.y + height, true );
+	for ( int y = 0; y < atlas.getHeight(); y++ ) {
+		memset( atlas.getData() + y * atlas.getRowBytes(), 0, atlas.getWidth() * atlas.getPixelInc() );
+	}
+	for ( int i = 1; i < NUM_CHARS; i++ ) {
+		atlas.copyFrom( glyphs[i], glyphs[i].getBounds(), areas[i].getUL() );
+	}
+	// uploaded on the first flush, so measuring text for a hidden panel doesn't touch the GPU
+	mSurface = atlas;
+	mTexture.reset();
+
+	const float u = 1.0f / atlas.getWidth(), v = 1.0f / atlas.getHeight();
+	for ( int i = 0; i < NUM_CHARS; i++ ) {
+		mGlyphs[i].mTexCoords = Rectf( areas[i].x1 * u, areas[i].y1 * v, areas[i].x2 * u, areas[i].y2 * v );
+		mGlyphs[i].mSize = Vec2f( (float)areas[i].getWidth(), (float)areas[i].getHeight() );
+	}
+	// the space is the width of "0 0" less two zeros, with nothing to draw
+	mGlyphs[0].mSize.x = math<float>::max( mGlyphs[0].mSize.x - 2.0f * mGlyphs['0' - FIRST_CHAR].mSize.x, 1.0f );
+	mGlyphs[0].mTexCoords = Rectf( 0.0f, 0.0f, 0.0f, 0.0f );
+}
+
+GlyphAtlasRef GlyphAtlas::create( const Font &aFont )
+{
+	return shared_ptr<GlyphAtlas>( new GlyphAtlas( aFont ) );
+}
+
+const GlyphAtlas::Glyph & GlyphAtlas::getGlyph( const char &aChar ) const
+{
+	int index = (unsigned char)aChar - FIRST_CHAR;
+	// anything unprintable shows as a question mark
+	return mGlyphs[( index >= 0 && index < NUM_CHARS ) ? index : '?' - FIRST_CHAR];
+}
+
+float GlyphAtlas::measure( const char *aText, const float &aScale )
+{
+	build();
+	float width = 0.0f;
+	for ( const char *c = aText; *c; c++ ) width += getGlyph( *c ).mSize.x;
+	return width * aScale;
+}
+
+void GlyphAtlas::add( const char *aText, const Vec2f &aPosition, const float &aScale, const ColorA &aColor )
+{
+	build();
+	Vec2f position = aPosition;
+	for ( const char *c = aText; *c; c++ ) {
+		const Glyph &glyph = getGlyph( *c );
+		if ( *c != ' ' ) {
+			const Vec2f lr = position + glyph.mSize * aScale;
+			const Rectf &t = glyph.mTexCoords;
+			const float vertices[8] = { position.x, position.y, lr.x, position.y, lr.x, lr.y, position.x, lr.y };
+			const float texCoords[8] = { t.x1, t.y1, t.x2, t.y1, t.x2, t.y2, t.x1, t.y2 };
+			mVertices.insert( mVertices.end(), vertices, vertices + 8 );
+			mTexCoords.insert( mTexCoords.end(), texCoords, texCoords + 8 );
+			for ( int i = 0; i < 4; i++ ) {
+				const float color[4] = { aColor.r, aColor.g, aColor.b, aColor.a };
+				mColors.insert( mColors.end(), color, color + 4 );
+			}
+		}
+		position.x += glyph.mSize.x * aScale;
+	}
+}
+
+void GlyphAtlas::flush()
+{
+	if ( mVertices.empty() ) return;
+
+	if ( !mTexture ) {
+		mTexture = gl::Texture( mSurface );
+		mSurface.reset();
+	}
+	mTexture.enableAndBind();
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+	glVertexPointer( 2, GL_FLOAT, 0, &mVertices[0] );
+	glTexCoordPointer( 2, GL_FLOAT, 0, &mTexCoords[0] );
+	glColorPointer( 4, GL_FLOAT, 0, &mColors[0] );
+	glDrawArrays( GL_QUADS, 0, mVertices.size() / 2 );
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+	mTexture.unbind();
+	mTexture.disable();
+
+	// keep the capacity for the next frame
+	mVertices.clear();
+	mTexCoords.clear();
+	mColors.clear();
+}
+
+int MinimalUI::formatFloat( char *aBuffer, const float &aValue, const int &aPrecision )
+{
+	char *out = aBuffer;
+	if ( aValue != aValue ) {
+		strcpy( aBuffer, "nan" );
+		return 3;
+	}
+
+	const int precision = aPrecision < 0 ? 0 : ( aPrecision > 6 ? 6 : aPrecision );
+	static const uint64_t POWERS[7] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+	double value = aValue;
+	if ( value < 0.0 ) {
+		value = -value;
+	}
+	// beyond what fits in the digits we print
+	if ( value >= 1e12 ) {
+		if ( aValue < 0.0f ) *out++ = '-';
+		strcpy( out, "inf" );
+		return (int)( out - aBuffer ) + 3;
+	}
+
+	// round once, in fixed point, so 0.999 at two decimals becomes 1.00
+	uint64_t fixed = (uint64_t)( value * POWERS[precision] + 0.5 );
+	uint64_t whole = fixed / POWERS[precision];
+	uint64_t fraction = fixed % POWERS[precision];
+
+	if ( aValue < 0.0f && fixed != 0 ) *out++ = '-';
+
+	char digits[24];
+	int numDigits = 0;
+	do {
+		digits[numDigits++] = (char)( '0' + whole % 10 );
+		whole /= 10;
+	} while ( whole );
+	while ( numDigits ) *out++ = digits[--numDigits];
+
+	if ( precision > 0 ) {
+		*out++ = '.';
+		for ( int i = precision - 1; i >= 0; i-- ) {
+			out[i] = (char)( '0' + fraction % 10 );
+			fraction /= 10;
+		}
+		out += precision;
+	}
+	*out = 0;
+	return (int)( out - aBuffer );
+}
+
+void ValueReadout::setup( const int &aPrecision, const string &aUnits )
+{
+	mPrecision = math<int>::clamp( aPrecision, 0, 6 );
+	mScale = powf( 10.0f, (float)mPrecision );
+	strncpy( mUnits, aUnits.c_str(), sizeof( mUnits ) - 1 );
+	mUnits[sizeof( mUnits ) - 1] = 0;
+	mNumValues = 0;
+}
+
+bool ValueReadout::update( const float *aValues, const int &aNumValues )
+{
+	// compare what would be shown, rounded the way formatFloat rounds, before formatting anything
+	const int numValues = math<int>::min( aNumValues, MAX_VALUES );
+	bool changed = numValues != mNumValues;
+	for ( int i = 0; i < numValues; i++ ) {
+		const float scaled = aValues[i] * mScale;
+		int64_t shown;
+		if ( !( fabsf( scaled ) < 9e18f ) ) {
+			// nan, inf and anything too large to round show as text rather than digits
+			shown = numeric_limits<int64_t>::min() + ( scaled > 0.0f ? 1 : 0 );
+		} else {
+			shown = (int64_t)( scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f );
+		}
+		if ( shown != mShown[i] ) {
+			mShown[i] = shown;
+			changed = true;
+		}
+	}
+	if ( !changed ) return false;
+	mNumValues = numValues;
+
+	char *out = mText;
+	for ( int i = 0; i < numValues; i++ ) {
+		if ( i > 0 ) {
+			*out++ = ',';
+			*out++ = ' ';
+		}
+		out += formatFloat( out, aValues[i], mPrecision );
+	}
+	strcpy( out, mUnits );
+	return true;
+}
@@ -4,6 +4,12 @@
 */
 
 #include "Graph.h"
+#include "WorkerPool.h"
+#include "Simd.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 
 using namespace ci;
 using namespace ci::app;
@@ -30,30 +36,36 @@ void MovingGraph::init()
 	int y = hasParam("height") ? getParam<int>("height") : MovingGraph::DEFAULT_HEIGHT;
 	setSize(Vec2i(x, y));
 	
+	mBufferSize = 128;
+	mSampleCount = 0;
+
 	// set position and bounds
 	setPositionAndBounds();
-	mScreenMin = mBounds.getX1();
-	mScreenMax = mBounds.getX2();
-	
-	mBufferSize = 128;
-	mScale = mBounds.getHeight() * 0.5f;
-	mInc = mBounds.getWidth() / ((float)mBufferSize - 1.0f);
+	boundsChanged();
 	
 	renderNameTexture();
 	// set screen value
 	update();
 }
 
+void MovingGraph::boundsChanged()
+{
+	mScreenMin = mBounds.getX1();
+	mScreenMax = mBounds.getX2();
+	mScale = mBounds.getHeight() * 0.5f;
+	mInc = mBounds.getWidth() / ((float)mBufferSize - 1.0f);
+}
+
 // without event handler
-MovingGraph::MovingGraph(UIController *aUIController, const string &aName, float *aValueToLink, const string &aParamString)
-: UIElement(aUIController, aName, aParamString), mLinkedValue(aValueToLink)
+MovingGraph::MovingGraph(UIController *aUIController, const string &aName, float *aValueToLink, const Params &aParams)
+: UIElement(aUIController, aName, aParams), mLinkedValue(aValueToLink)
 {
 	init();
 }
 
 // with event handler
-MovingGraph::MovingGraph(UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const string &aParamString)
-	: UIElement(aUIController, aName, aParamString), mLinkedValue(aValueToLink)
+MovingGraph::MovingGraph(UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const Params &aParams)
+	: UIElement(aUIController, aName, aParams), mLinkedValue(aValueToLink)
 {
 	// initialize unique variables
 	addEventHandler(aEventHandler);
@@ -62,35 +74,30 @@ MovingGraph::MovingGraph(UIController *aUIController, const string &aName, float
 }
 
 // without event handler
-UIElementRef MovingGraph::create(UIController *aUIController, const string &aName, float *aValueToLink, const string &aParamString)
+UIElementRef MovingGraph::create(UIController *aUIController, const string &aName, float *aValueToLink, const Params &aParams)
 {
-	return shared_ptr<MovingGraph>(new MovingGraph(aUIController, aName, aValueToLink, aParamString));
+	return shared_ptr<MovingGraph>(new MovingGraph(aUIController, aName, aValueToLink, aParams));
 }
 
 // with event handler
-UIElementRef MovingGraph::create(UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const string &aParamString)
+UIElementRef MovingGraph::create(UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const Params &aParams)
 {
-	return shared_ptr<MovingGraph>(new MovingGraph(aUIController, aName, aValueToLink, aEventHandler, aParamString));
+	return shared_ptr<MovingGraph>(new MovingGraph(aUIController, aName, aValueToLink, aEventHandler, aParams));
 }
 
-void MovingGraph::draw()
+ColorA MovingGraph::getFillColor() const
 {
-	// set the color
 	if ( isActive() && mEventHandlers.size() > 0 ) {
-		gl::color(UIController::ACTIVE_STROKE_COLOR);
+		return UIController::ACTIVE_STROKE_COLOR;
 	}
 	else if (mPressed) {
-		gl::color(UIController::DEFAULT_STROKE_COLOR);
+		return UIController::DEFAULT_STROKE_COLOR;
 	}
-	else {
-		gl::color(getBackgroundColor());
-	}
-	// draw the button background
-	gl::drawSolidRect(getBounds());
-
-	// draw the background
-	drawBackground();
+	return getBackgroundColor();
+}
 
+void MovingGraph::draw()
+{
 	// draw the graph
 	if ( isActive() && mEventHandlers.size() > 0 ) {
 		gl::color(UIController::ACTIVE_STROKE_COLOR);
@@ -185,9 +192,619 @@ void MovingGraph::update()
 		callEventHandlers();
 	}	
 	mBuffer.push_back( *mLinkedValue );
+	mSampleCount++;
 
 	if( mBuffer.size() >= mBufferSize )
 	{
 		mBuffer.erase( mBuffer.begin(), mBuffer.begin() + 1 );
 	}
 }
+
+void MovingGraph::setSamples( const std::vector<float> &aSamples )
+{
+	const size_t capacity = mBufferSize - 1;
+	mBuffer.assign( aSamples.end() - min( aSamples.size(), capacity ), aSamples.end() );
+}
+
+// MultiGraph
+int MultiGraph::DEFAULT_HEIGHT = UIElement::DEFAULT_HEIGHT * 2;
+int MultiGraph::DEFAULT_WIDTH = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+int MultiGraph::DEFAULT_CAPACITY = 1024;
+
+MultiGraph::MultiGraph( UIController *aUIController, const string &aName, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
+{
+	// initialize unique variables
+	mCapacity = hasParam( "capacity" ) ? getParam<int>( "capacity" ) : MultiGraph::DEFAULT_CAPACITY;
+	// either end that isn't given follows the data
+	mAutoscaleMin = !hasParam( "min" );
+	mAutoscaleMax = !hasParam( "max" );
+	mMin = hasParam( "min" ) ? getParam<float>( "min" ) : 0.0f;
+	mMax = hasParam( "max" ) ? getParam<float>( "max" ) : 1.0f;
+	if ( !mAutoscaleMin && !mAutoscaleMax && mMax <= mMin ) mMax = mMin + 1.0f;
+
+	// set size and render name texture
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : MultiGraph::DEFAULT_WIDTH;
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : MultiGraph::DEFAULT_HEIGHT;
+	setSize( Vec2i( x, y ) );
+	renderNameTexture();
+
+	// set position and bounds
+	setPositionAndBounds();
+	boundsChanged();
+}
+
+UIElementRef MultiGraph::create( UIController *aUIController, const string &aName, const Params &aParams )
+{
+	return shared_ptr<MultiGraph>( new MultiGraph( aUIController, aName, aParams ) );
+}
+
+void MultiGraph::SlidingExtremum::push( const uint64_t &aIndex, const float &aValue, const uint64_t &aWindow )
+{
+	const size_t size = mValues.size();
+	// drop everything the new value dominates, then everything that has scrolled out of the window
+	while ( mTail != mHead && ( mMax ? mValues[( mTail - 1 ) % size] <= aValue : mValues[( mTail - 1 ) % size] >= aValue ) ) mTail--;
+	mIndices[mTail % size] = aIndex;
+	mValues[mTail % size] = aValue;
+	mTail++;
+	while ( mIndices[mHead % size] + aWindow <= aIndex ) mHead++;
+}
+
+int MultiGraph::addSeries( const ColorA &aColor )
+{
+	lock_guard<mutex> lock( mMutex );
+	mSeries.push_back( Series() );
+	Series &series = mSeries.back();
+	series.mColor = aColor;
+	series.mSamples.resize( mCapacity );
+	series.mNumSamples = 0;
+	resetBuckets( series );
+	return mSeries.size() - 1;
+}
+
+void MultiGraph::resetBuckets( Series &aSeries )
+{
+	aSeries.mBucketMin.assign( mColumns, 0.0f );
+	aSeries.mBucketMax.assign( mColumns, 0.0f );
+	aSeries.mNumBuckets = 0;
+	aSeries.mPartialCount = 0;
+	aSeries.mWindowMin.reset( mColumns + 1, false );
+	aSeries.mWindowMax.reset( mColumns + 1, true );
+}
+
+void MultiGraph::boundsChanged()
+{
+	lock_guard<mutex> lock( mMutex );
+
+	// one bucket per pixel column, each covering enough samples that the whole ring fits across the plot
+	mColumns = math<int>::max( getBounds().getWidth(), 2 );
+	mBucketSize = math<int>::max( ( mCapacity + mColumns - 1 ) / mColumns, 1 );
+
+	// replay the raw samples into the new buckets
+	for ( unsigned int i = 0; i < mSeries.size(); i++ ) {
+		Series &series = mSeries[i];
+		resetBuckets( series );
+		uint64_t first = series.mNumSamples > mCapacity ? series.mNumSamples - mCapacity : 0;
+		for ( uint64_t n = first; n < series.mNumSamples; n++ ) {
+			addToBucket( series, series.mSamples[n % mCapacity] );
+		}
+	}
+}
+
+void MultiGraph::addToBucket( Series &aSeries, const float &aValue )
+{
+	if ( aSeries.mPartialCount == 0 ) {
+		aSeries.mPartialMin = aSeries.mPartialMax = aValue;
+	} else {
+		aSeries.mPartialMin = math<float>::min( aSeries.mPartialMin, aValue );
+		aSeries.mPartialMax = math<float>::max( aSeries.mPartialMax, aValue );
+	}
+
+	if ( ++aSeries.mPartialCount == mBucketSize ) {
+		uint64_t index = aSeries.mNumBuckets++;
+		aSeries.mBucketMin[index % mColumns] = aSeries.mPartialMin;
+		aSeries.mBucketMax[index % mColumns] = aSeries.mPartialMax;
+		aSeries.mWindowMin.push( index, aSeries.mPartialMin, mColumns );
+		aSeries.mWindowMax.push( index, aSeries.mPartialMax, mColumns );
+		aSeries.mPartialCount = 0;
+	}
+}
+
+void MultiGraph::push( const int &aSeries, const float *aValues, const size_t &aCount )
+{
+	lock_guard<mutex> lock( mMutex );
+	Series &series = mSeries[aSeries];
+
+	// only the last mCapacity samples of a large batch can ever be seen
+	size_t skip = aCount > mCapacity ? aCount - mCapacity : 0;
+	series.mNumSamples += skip;
+	for ( size_t i = skip; i < aCount; i++ ) {
+		series.mSamples[series.mNumSamples++ % mCapacity] = aValues[i];
+		addToBucket( series, aValues[i] );
+	}
+}
+
+void MultiGraph::update()
+{
+	lock_guard<mutex> lock( mMutex );
+
+	// autoscale from the incrementally maintained extremes
+	if ( mAutoscaleMin || mAutoscaleMax ) {
+		bool first = true;
+		for ( unsigned int i = 0; i < mSeries.size(); i++ ) {
+			const Series &series = mSeries[i];
+			float lo, hi;
+			if ( !series.mWindowMin.empty() ) {
+				lo = series.mWindowMin.front();
+				hi = series.mWindowMax.front();
+				if ( series.mPartialCount > 0 ) {
+					lo = math<float>::min( lo, series.mPartialMin );
+					hi = math<float>::max( hi, series.mPartialMax );
+				}
+			} else if ( series.mPartialCount > 0 ) {
+				lo = series.mPartialMin;
+				hi = series.mPartialMax;
+			} else {
+				continue;
+			}
+			if ( mAutoscaleMin ) mMin = first ? lo : math<float>::min( mMin, lo );
+			if ( mAutoscaleMax ) mMax = first ? hi : math<float>::max( mMax, hi );
+			first = false;
+		}
+		// keep the range from collapsing or inverting, moving only an end that follows the data
+		if ( mMax <= mMin ) {
+			if ( mAutoscaleMax ) mMax = mMin + 1.0f;
+			else mMin = mMax - 1.0f;
+		}
+	}
+
+	// build a zig-zag strip through each column's min and max, for every series
+	Rectf bounds = getBounds();
+	const float dx = bounds.getWidth() / (float)( mColumns - 1 );
+	const float scale = -bounds.getHeight() / ( mMax - mMin );
+	const float offset = bounds.getY2() - mMin * scale;
+
+	mVertices.clear();
+	mColors.clear();
+	mFirsts.clear();
+	mCounts.clear();
+	for ( unsigned int i = 0; i < mSeries.size(); i++ ) {
+		const Series &series = mSeries[i];
+		uint64_t numBuckets = math<uint64_t>::min( series.mNumBuckets, mColumns - ( series.mPartialCount > 0 ? 1 : 0 ) );
+		uint64_t firstBucket = series.mNumBuckets - numBuckets;
+		int numColumns = numBuckets + ( series.mPartialCount > 0 ? 1 : 0 );
+		if ( numColumns < 2 ) continue;
+
+		mFirsts.push_back( mVertices.size() / 2 );
+		mCounts.push_back( numColumns * 2 );
+		size_t base = mVertices.size();
+		mVertices.resize( base + numColumns * 4 );
+		float *vertex = &mVertices[base];
+		for ( int column = 0; column < numColumns; column++ ) {
+			float lo, hi;
+			if ( column < (int)numBuckets ) {
+				uint64_t bucket = ( firstBucket + column ) % mColumns;
+				lo = series.mBucketMin[bucket];
+				hi = series.mBucketMax[bucket];
+			} else {
+				lo = series.mPartialMin;
+				hi = series.mPartialMax;
+			}
+			float x = bounds.getX1() + dx * column;
+			vertex[0] = x;
+			vertex[1] = lo * scale + offset;
+			vertex[2] = x;
+			vertex[3] = hi * scale + offset;
+			vertex += 4;
+		}
+		for ( int v = 0; v < numColumns * 2; v++ ) {
+			mColors.push_back( series.mColor.r );
+			mColors.push_back( series.mColor.g );
+			mColors.push_back( series.mColor.b );
+			mColors.push_back( series.mColor.a );
+		}
+	}
+}
+
+void MultiGraph::draw()
+{
+	// draw the outer rect
+	gl::color( UIController::DEFAULT_STROKE_COLOR );
+	gl::drawStrokedRect( getBounds() );
+
+	// draw every series in one call
+	if ( !mFirsts.empty() ) {
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glEnableClientState( GL_COLOR_ARRAY );
+		glVertexPointer( 2, GL_FLOAT, 0, &mVertices[0] );
+		glColorPointer( 4, GL_FLOAT, 0, &mColors[0] );
+		glMultiDrawArrays( GL_LINE_STRIP, &mFirsts[0], &mCounts[0], mFirsts.size() );
+		glDisableClientState( GL_COLOR_ARRAY );
+		glDisableClientState( GL_VERTEX_ARRAY );
+	}
+
+	// draw the label
+	drawLabel();
+}
+
+// Histogram
+int Histogram::DEFAULT_HEIGHT = UIElement::DEFAULT_HEIGHT * 2;
+int Histogram::DEFAULT_WIDTH = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+const int Histogram::MAX_BINS;
+
+Histogram::Histogram( UIController *aUIController, const string &aName, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
+{
+	// initialize unique variables
+	mNumBins = hasParam( "bins" ) ? math<int>::clamp( getParam<int>( "bins" ), 1, Histogram::MAX_BINS ) : 64;
+	mLog = hasParam( "log" ) ? getParam<bool>( "log" ) : false;
+	mMin = hasParam( "min" ) ? getParam<float>( "min" ) : ( mLog ? 1.0f : 0.0f );
+	mMax = hasParam( "max" ) ? getParam<float>( "max" ) : ( mLog ? 1000.0f : 1.0f );
+	mDecay = hasParam( "decay" ) ? getParam<float>( "decay" ) : 1.0f;
+	mWindow = hasParam( "window" ) ? getParam<int>( "window" ) : 0;
+
+	mPending.reset( new std::atomic<uint32_t>[mNumBins] );
+	for ( int i = 0; i < mNumBins; i++ ) mPending[i] = 0;
+	mBins.assign( mNumBins, 0.0f );
+	mHistory.assign( mNumBins * mWindow, 0 );
+	mHistoryIndex = 0;
+	mPeak = 0.0f;
+
+	// set size and render name texture
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : Histogram::DEFAULT_WIDTH;
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : Histogram::DEFAULT_HEIGHT;
+	setSize( Vec2i( x, y ) );
+	renderNameTexture();
+
+	// set position and bounds
+	setPositionAndBounds();
+}
+
+UIElementRef Histogram::create( UIController *aUIController, const string &aName, const Params &aParams )
+{
+	return shared_ptr<Histogram>( new Histogram( aUIController, aName, aParams ) );
+}
+
+// cheap log2, accurate to about 1e-4, which is far finer than any bin
+static inline float fastLog2( const float &aValue )
+{
+	uint32_t bits;
+	memcpy( &bits, &aValue, sizeof( bits ) );
+	float exponent = (float)( (int)( bits >> 23 ) - 127 );
+	bits = ( bits & 0x007FFFFF ) | 0x3F800000;
+	float m;
+	memcpy( &m, &bits, sizeof( m ) );
+	return exponent + ( -2.51287742f + ( 4.070135f + ( -2.12069939f + ( 0.64514372f - 0.08161449f * m ) * m ) * m ) * m );
+}
+
+#if defined( MINIMALUI_SSE2 )
+static inline __m128 fastLog2( const __m128 &aValue )
+{
+	__m128i bits = _mm_castps_si128( aValue );
+	__m128 exponent = _mm_cvtepi32_ps( _mm_sub_epi32( _mm_srli_epi32( bits, 23 ), _mm_set1_epi32( 127 ) ) );
+	__m128 m = _mm_castsi128_ps( _mm_or_si128( _mm_and_si128( bits, _mm_set1_epi32( 0x007FFFFF ) ), _mm_set1_epi32( 0x3F800000 ) ) );
+	__m128 p = _mm_sub_ps( _mm_set1_ps( 0.64514372f ), _mm_mul_ps( _mm_set1_ps( 0.08161449f ), m ) );
+	p = _mm_add_ps( _mm_set1_ps( -2.12069939f ), _mm_mul_ps( p, m ) );
+	p = _mm_add_ps( _mm_set1_ps( 4.070135f ), _mm_mul_ps( p, m ) );
+	p = _mm_add_ps( _mm_set1_ps( -2.51287742f ), _mm_mul_ps( p, m ) );
+	return _mm_add_ps( exponent, p );
+}
+#endif
+
+// aCounts holds four interleaved sub-histograms, so consecutive samples landing in the same bin don't serialize on one counter
+void Histogram::binLinear( const float *aValues, const size_t &aCount, uint32_t *aCounts ) const
+{
+	const float scale = mNumBins / ( mMax - mMin );
+	const float last = (float)( mNumBins - 1 );
+	size_t i = 0;
+#if defined( MINIMALUI_SSE2 )
+	const __m128 vMin = _mm_set1_ps( mMin ), vScale = _mm_set1_ps( scale ), vZero = _mm_setzero_ps(), vLast = _mm_set1_ps( last );
+	for ( ; i + 4 <= aCount; i += 4 ) {
+		__m128 t = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( aValues + i ), vMin ), vScale );
+		t = _mm_min_ps( _mm_max_ps( t, vZero ), vLast );
+		alignas( 16 ) int32_t bins[4];
+		_mm_store_si128( (__m128i *)bins, _mm_cvttps_epi32( t ) );
+		aCounts[bins[0] * 4]++;
+		aCounts[bins[1] * 4 + 1]++;
+		aCounts[bins[2] * 4 + 2]++;
+		aCounts[bins[3] * 4 + 3]++;
+	}
+#endif
+	for ( ; i < aCount; i++ ) {
+		float t = ( aValues[i] - mMin ) * scale;
+		t = t > 0.0f ? ( t < last ? t : last ) : 0.0f;
+		aCounts[(int)t * 4]++;
+	}
+}
+
+void Histogram::binLog( const float *aValues, const size_t &aCount, uint32_t *aCounts ) const
+{
+	const float logMin = fastLog2( mMin );
+	const float scale = mNumBins / ( fastLog2( mMax ) - logMin );
+	const float last = (float)( mNumBins - 1 );
+	size_t i = 0;
+#if defined( MINIMALUI_SSE2 )
+	const __m128 vMin = _mm_set1_ps( mMin ), vLogMin = _mm_set1_ps( logMin ), vScale = _mm_set1_ps( scale ), vZero = _mm_setzero_ps(), vLast = _mm_set1_ps( last );
+	for ( ; i + 4 <= aCount; i += 4 ) {
+		// values below min (including zero and negatives) land in the first bin
+		__m128 v = _mm_max_ps( _mm_loadu_ps( aValues + i ), vMin );
+		__m128 t = _mm_mul_ps( _mm_sub_ps( fastLog2( v ), vLogMin ), vScale );
+		t = _mm_min_ps( _mm_max_ps( t, vZero ), vLast );
+		alignas( 16 ) int32_t bins[4];
+		_mm_store_si128( (__m128i *)bins, _mm_cvttps_epi32( t ) );
+		aCounts[bins[0] * 4]++;
+		aCounts[bins[1] * 4 + 1]++;
+		aCounts[bins[2] * 4 + 2]++;
+		aCounts[bins[3] * 4 + 3]++;
+	}
+#endif
+	for ( ; i < aCount; i++ ) {
+		float v = aValues[i] > mMin ? aValues[i] : mMin;
+		float t = ( fastLog2( v ) - logMin ) * scale;
+		t = t > 0.0f ? ( t < last ? t : last ) : 0.0f;
+		aCounts[(int)t * 4]++;
+	}
+}
+
+void Histogram::push( const float *aValues, const size_t &aCount )
+{
+	// bin into local counters in chunks, so the shared counters see one atomic add per bin rather than per sample
+	const size_t CHUNK_SIZE = 1 << 16;
+	uint32_t counts[MAX_BINS * 4];
+	static_assert( sizeof( counts ) <= 64 * 1024, "Histogram::MAX_BINS makes push()'s stack buffer too large" );
+	for ( size_t offset = 0; offset < aCount; offset += CHUNK_SIZE ) {
+		memset( counts, 0, sizeof( uint32_t ) * mNumBins * 4 );
+		size_t count = math<size_t>::min( CHUNK_SIZE, aCount - offset );
+		if ( mLog ) {
+			binLog( aValues + offset, count, counts );
+		} else {
+			binLinear( aValues + offset, count, counts );
+		}
+		for ( int bin = 0; bin < mNumBins; bin++ ) {
+			uint32_t total = counts[bin * 4] + counts[bin * 4 + 1] + counts[bin * 4 + 2] + counts[bin * 4 + 3];
+			if ( total ) mPending[bin].fetch_add( total, std::memory_order_relaxed );
+		}
+	}
+}
+
+void Histogram::update()
+{
+	mPeak = 0.0f;
+	uint32_t *history = mWindow > 0 ? &mHistory[mHistoryIndex * mNumBins] : nullptr;
+	for ( int bin = 0; bin < mNumBins; bin++ ) {
+		uint32_t pending = mPending[bin].exchange( 0, std::memory_order_relaxed );
+		if ( history ) {
+			// sliding window: add the newest update's counts, drop the oldest
+			mBins[bin] += (float)pending - (float)history[bin];
+			history[bin] = pending;
+		} else {
+			mBins[bin] = mBins[bin] * mDecay + (float)pending;
+		}
+		mPeak = math<float>::max( mPeak, mBins[bin] );
+	}
+	if ( mWindow > 0 ) mHistoryIndex = ( mHistoryIndex + 1 ) % mWindow;
+
+	// one batch of triangles for all the bars
+	Rectf bounds = getBounds();
+	const float barWidth = bounds.getWidth() / mNumBins;
+	const float scale = mPeak > 0.0f ? bounds.getHeight() / mPeak : 0.0f;
+	mVertices.resize( mNumBins * 12 );
+	float *vertex = &mVertices[0];
+	for ( int bin = 0; bin < mNumBins; bin++ ) {
+		float x1 = bounds.getX1() + barWidth * bin;
+		float x2 = x1 + barWidth;
+		float y1 = bounds.getY2() - mBins[bin] * scale;
+		float y2 = bounds.getY2();
+		const float quad[12] = { x1, y1, x2, y1, x2, y2, x1, y1, x2, y2, x1, y2 };
+		memcpy( vertex, quad, sizeof( quad ) );
+		vertex += 12;
+	}
+}
+
+void Histogram::draw()
+{
+	// draw the bars
+	if ( !mVertices.empty() ) {
+		gl::color( UIController::ACTIVE_STROKE_COLOR );
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glVertexPointer( 2, GL_FLOAT, 0, &mVertices[0] );
+		glDrawArrays( GL_TRIANGLES, 0, mVertices.size() / 2 );
+		glDisableClientState( GL_VERTEX_ARRAY );
+	}
+
+	// draw the outer rect
+	gl::color( UIController::DEFAULT_STROKE_COLOR );
+	gl::drawStrokedRect( getBounds() );
+
+	// draw the label
+	drawLabel();
+}
+
+// ScatterPlot
+int ScatterPlot::DEFAULT_SIZE = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+
+ScatterPlot::ScatterPlot( UIController *aUIController, const string &aName, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
+{
+	// initialize unique variables
+	mMinX = hasParam( "minX" ) ? getParam<float>( "minX" ) : 0.0f;
+	mMaxX = hasParam( "maxX" ) ? getParam<float>( "maxX" ) : 1.0f;
+	mMinY = hasParam( "minY" ) ? getParam<float>( "minY" ) : 0.0f;
+	mMaxY = hasParam( "maxY" ) ? getParam<float>( "maxY" ) : 1.0f;
+	// an empty or inverted range would scale by infinity, so widen it to one unit
+	if ( mMaxX <= mMinX ) mMaxX = mMinX + 1.0f;
+	if ( mMaxY <= mMinY ) mMaxY = mMinY + 1.0f;
+	mPointSize = hasParam( "pointSize" ) ? getParam<float>( "pointSize" ) : 2.0f;
+	mX = mY = nullptr;
+	mCount = 0;
+	mStride = 0;
+	mBinned = false;
+	mBinsWidth = mBinsHeight = 0;
+	mPixelsChanged = false;
+
+	// set size and render name texture
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : ScatterPlot::DEFAULT_SIZE;
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : ScatterPlot::DEFAULT_SIZE;
+	setSize( Vec2i( x, y ) );
+	renderNameTexture();
+
+	// set position and bounds
+	setPositionAndBounds();
+}
+
+UIElementRef ScatterPlot::create( UIController *aUIController, const string &aName, const Params &aParams )
+{
+	return shared_ptr<ScatterPlot>( new ScatterPlot( aUIController, aName, aParams ) );
+}
+
+void ScatterPlot::setPoints( const float *aX, const float *aY, const size_t &aCount, const size_t &aStride )
+{
+	mX = aX;
+	mY = aY;
+	mCount = ( aX && aY ) ? aCount : 0;
+	mStride = aStride;
+}
+
+void ScatterPlot::releaseResources()
+{
+	UIElement::releaseResources();
+	// the bins and texture are sized again on the next update
+	mDensityTexture.reset();
+	mBins.clear();
+	mPixels.clear();
+	mBinsWidth = mBinsHeight = 0;
+	mBinned = false;
+	mPixelsChanged = false;
+}
+
+void ScatterPlot::update()
+{
+	// fall back to binning once there are more points than pixels to show them
+	const Vec2i size = getSize();
+	mBinned = mCount > (size_t)size.x * size.y;
+	if ( mBinned ) {
+		mVertices.clear();
+		updateDensity();
+	} else {
+		updatePoints();
+	}
+}
+
+void ScatterPlot::updatePoints()
+{
+	// map to screen space, dropping points outside the range
+	const Rectf bounds = getBounds();
+	const float scaleX = bounds.getWidth() / ( mMaxX - mMinX );
+	const float scaleY = bounds.getHeight() / ( mMaxY - mMinY );
+	const uint8_t *x = (const uint8_t *)mX;
+	const uint8_t *y = (const uint8_t *)mY;
+	mVertices.clear();
+	for ( size_t i = 0; i < mCount; i++, x += mStride, y += mStride ) {
+		const float px = *(const float *)x, py = *(const float *)y;
+		if ( px < mMinX || px > mMaxX || py < mMinY || py > mMaxY ) continue;
+		mVertices.push_back( bounds.getX1() + ( px - mMinX ) * scaleX );
+		mVertices.push_back( bounds.getY2() - ( py - mMinY ) * scaleY );
+	}
+}
+
+void ScatterPlot::updateDensity()
+{
+	const Vec2i size = getSize();
+	const int numPixels = size.x * size.y;
+	WorkerPool &pool = WorkerPool::getShared();
+	const size_t numParts = pool.getNumThreads() + 1;
+	if ( mBins.size() != numParts || mBinsWidth != size.x || mBinsHeight != size.y ) {
+		mBins.assign( numParts, vector<uint32_t>( numPixels ) );
+		mPixels.assign( numPixels, 0 );
+		mBinsWidth = size.x;
+		mBinsHeight = size.y;
+	}
+
+	// each worker bins its share of the points into its own counts, so no atomics are needed
+	const float scaleX = size.x / ( mMaxX - mMinX );
+	const float scaleY = size.y / ( mMaxY - mMinY );
+	const size_t partSize = ( mCount + numParts - 1 ) / numParts;
+	pool.parallelFor( numParts, [&]( size_t aBegin, size_t aEnd ) {
+		for ( size_t part = aBegin; part < aEnd; part++ ) {
+			vector<uint32_t> &bins = mBins[part];
+			fill( bins.begin(), bins.end(), 0 );
+			const size_t begin = part * partSize;
+			const size_t end = math<size_t>::min( begin + partSize, mCount );
+			const uint8_t *x = (const uint8_t *)mX + begin * mStride;
+			const uint8_t *y = (const uint8_t *)mY + begin * mStride;
+			for ( size_t i = begin; i < end; i++, x += mStride, y += mStride ) {
+				const float bx = ( *(const float *)x - mMinX ) * scaleX;
+				const float by = ( *(const float *)y - mMinY ) * scaleY;
+				if ( !( bx >= 0.0f && bx < size.x && by >= 0.0f && by < size.y ) ) continue;
+				// row 0 is the top of the plot
+				bins[( size.y - 1 - (int)by ) * size.x + (int)bx]++;
+			}
+		}
+	} );
+
+	// merge into the first set of bins, a band of pixels per task, finding the densest pixel on the way
+	vector<uint32_t> peaks( numParts, 0 );
+	const size_t bandSize = ( numPixels + numParts - 1 ) / numParts;
+	pool.parallelFor( numParts, [&]( size_t aBegin, size_t aEnd ) {
+		for ( size_t band = aBegin; band < aEnd; band++ ) {
+			uint32_t peak = 0;
+			uint32_t *total = &mBins[0][0];
+			for ( size_t i = band * bandSize; i < math<size_t>::min( ( band + 1 ) * bandSize, numPixels ); i++ ) {
+				for ( size_t part = 1; part < numParts; part++ ) total[i] += mBins[part][i];
+				peak = math<uint32_t>::max( peak, total[i] );
+			}
+			peaks[band] = peak;
+		}
+	} );
+	const uint32_t peak = *max_element( peaks.begin(), peaks.end() );
+
+	// log-scaled opacity, so sparse regions stay visible next to dense ones
+	const ColorA color = UIController::ACTIVE_STROKE_COLOR;
+	const uint8_t r = (uint8_t)( color.r * 255.0f ), g = (uint8_t)( color.g * 255.0f ), b = (uint8_t)( color.b * 255.0f );
+	const float scale = peak > 0 ? 255.0f / logf( 1.0f + peak ) : 0.0f;
+	const uint32_t *total = &mBins[0][0];
+	for ( int i = 0; i < numPixels; i++ ) {
+		uint8_t bytes[4] = { r, g, b, (uint8_t)( logf( 1.0f + total[i] ) * scale ) };
+		memcpy( &mPixels[i], bytes, sizeof( uint32_t ) );
+	}
+	mPixelsChanged = true;
+}
+
+void ScatterPlot::upload()
+{
+	if ( !mPixelsChanged ) return;
+
+	if ( !mDensityTexture || mDensityTexture.getWidth() != mBinsWidth || mDensityTexture.getHeight() != mBinsHeight ) {
+		gl::Texture::Format format;
+		format.setMinFilter( GL_NEAREST );
+		format.setMagFilter( GL_NEAREST );
+		mDensityTexture = gl::Texture( mBinsWidth, mBinsHeight, format );
+	}
+	mDensityTexture.bind();
+	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, mBinsWidth, mBinsHeight, GL_RGBA, GL_UNSIGNED_BYTE, &mPixels[0] );
+	mDensityTexture.unbind();
+	mPixelsChanged = false;
+}
+
+void ScatterPlot::draw()
+{
+	// draw the points or their density
+	if ( mBinned && mDensityTexture ) {
+		gl::color( Color::white() );
+		gl::draw( mDensityTexture, getBounds() );
+	} else if ( !mVertices.empty() ) {
+		gl::color( UIController::ACTIVE_STROKE_COLOR );
+		glPointSize( toPixels( mPointSize ) );
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glVertexPointer( 2, GL_FLOAT, 0, &mVertices[0] );
+		glDrawArrays( GL_POINTS, 0, mVertices.size() / 2 );
+		glDisableClientState( GL_VERTEX_ARRAY );
+	}
+
+	// draw the outer rect
+	gl::color( UIController::DEFAULT_STROKE_COLOR );
+	gl::drawStrokedRect( getBounds() );
+
+	// draw the label
+	drawLabel();
+}
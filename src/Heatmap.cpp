@@ -0,0 +1,270 @@
+#include "Heatmap.h"
+#include "WorkerPool.h"
+#include "Simd.h"
+
+#include <cstring>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+int Heatmap::DEFAULT_SIZE = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+int Heatmap::TILE_SIZE = 64;
+int Heatmap::MAX_GRID_SIZE = 4096;
+
+Heatmap::Heatmap( UIController *aUIController, const string &aName, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
+{
+	// initialize unique variables
+	mMin = hasParam( "min" ) ? getParam<float>( "min" ) : 0.0f;
+	mMax = hasParam( "max" ) ? getParam<float>( "max" ) : 1.0f;
+	buildColormap( hasParam( "colormap" ) ? getParam<string>( "colormap" ) : "heat" );
+	mGridWidth = mGridHeight = 0;
+	mPreviewWidth = mPreviewHeight = 0;
+	mTilesX = mTilesY = 0;
+	mDirty = false;
+	mColored = false;
+	mResized = false;
+
+	// set size and render name texture
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : Heatmap::DEFAULT_SIZE;
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : Heatmap::DEFAULT_SIZE;
+	setSize( Vec2i( x, y ) );
+	renderNameTexture();
+
+	// set position and bounds
+	setPositionAndBounds();
+}
+
+UIElementRef Heatmap::create( UIController *aUIController, const string &aName, const Params &aParams )
+{
+	return shared_ptr<Heatmap>( new Heatmap( aUIController, aName, aParams ) );
+}
+
+void Heatmap::buildColormap( const string &aName )
+{
+	vector<Color> stops;
+	if ( aName == "gray" ) {
+		stops.push_back( Color( 0.0f, 0.0f, 0.0f ) );
+		stops.push_back( Color( 1.0f, 1.0f, 1.0f ) );
+	} else if ( aName == "spectrum" ) {
+		stops.push_back( Color( 0.0f, 0.0f, 1.0f ) );
+		stops.push_back( Color( 0.0f, 1.0f, 1.0f ) );
+		stops.push_back( Color( 0.0f, 1.0f, 0.0f ) );
+		stops.push_back( Color( 1.0f, 1.0f, 0.0f ) );
+		stops.push_back( Color( 1.0f, 0.0f, 0.0f ) );
+	} else {
+		stops.push_back( Color( 0.0f, 0.0f, 0.0f ) );
+		stops.push_back( Color( 1.0f, 0.0f, 0.0f ) );
+		stops.push_back( Color( 1.0f, 1.0f, 0.0f ) );
+		stops.push_back( Color( 1.0f, 1.0f, 1.0f ) );
+	}
+
+	// RGBA bytes in memory order
+	for ( int i = 0; i < 256; i++ ) {
+		float t = i / 255.0f * ( stops.size() - 1 );
+		int stop = math<int>::min( (int)t, (int)stops.size() - 2 );
+		Color c = stops[stop].lerp( t - stop, stops[stop + 1] );
+		uint8_t r = (uint8_t)( c.r * 255.0f + 0.5f ), g = (uint8_t)( c.g * 255.0f + 0.5f ), b = (uint8_t)( c.b * 255.0f + 0.5f );
+		uint8_t bytes[4] = { r, g, b, 255 };
+		memcpy( &mColormap[i], bytes, sizeof( uint32_t ) );
+	}
+}
+
+void Heatmap::colormapRow( const float *aValues, uint32_t *aPixels, const int &aCount ) const
+{
+	const float scale = mMax > mMin ? 255.0f / ( mMax - mMin ) : 0.0f;
+	int i = 0;
+#if defined( MINIMALUI_SSE2 )
+	// four lookup indices at a time; NaNs map to the bottom of the colormap
+	const __m128 vMin = _mm_set1_ps( mMin ), vScale = _mm_set1_ps( scale ), vZero = _mm_setzero_ps(), vLast = _mm_set1_ps( 255.0f );
+	for ( ; i + 4 <= aCount; i += 4 ) {
+		__m128 t = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( aValues + i ), vMin ), vScale );
+		t = _mm_min_ps( _mm_max_ps( t, vZero ), vLast );
+		alignas( 16 ) int32_t indices[4];
+		_mm_store_si128( (__m128i *)indices, _mm_cvttps_epi32( t ) );
+		aPixels[i] = mColormap[indices[0]];
+		aPixels[i + 1] = mColormap[indices[1]];
+		aPixels[i + 2] = mColormap[indices[2]];
+		aPixels[i + 3] = mColormap[indices[3]];
+	}
+#endif
+	for ( ; i < aCount; i++ ) {
+		float t = ( aValues[i] - mMin ) * scale;
+		t = t > 0.0f ? ( t < 255.0f ? t : 255.0f ) : 0.0f;
+		aPixels[i] = mColormap[(int)t];
+	}
+}
+
+void Heatmap::setData( const float *aData, const int &aWidth, const int &aHeight )
+{
+	setData( aData, aWidth, aHeight, Area( 0, 0, aWidth, aHeight ) );
+}
+
+void Heatmap::setData( const float *aData, const int &aWidth, const int &aHeight, const Area &aChanged )
+{
+	if ( aWidth <= 0 || aHeight <= 0 || aWidth > MAX_GRID_SIZE || aHeight > MAX_GRID_SIZE ) return;
+
+	// one call at a time; the grid and preview sizes are only changed here, so they can be read without mMutex
+	lock_guard<mutex> dataLock( mDataMutex );
+
+	// the preview is at most one texel per pixel of the element
+	const bool resized = aWidth != mGridWidth || aHeight != mGridHeight;
+	const int previewWidth = resized ? math<int>::min( aWidth, getSize().x ) : mPreviewWidth;
+	const int previewHeight = resized ? math<int>::min( aHeight, getSize().y ) : mPreviewHeight;
+
+	Area changed = resized ? Area( 0, 0, aWidth, aHeight ) : aChanged;
+	changed.clipBy( Area( 0, 0, aWidth, aHeight ) );
+	if ( changed.getWidth() <= 0 || changed.getHeight() <= 0 ) return;
+
+	// preview texels covering the changed cells
+	const int x1 = changed.x1 * previewWidth / aWidth;
+	const int x2 = ( changed.x2 * previewWidth + aWidth - 1 ) / aWidth;
+	const int y1 = changed.y1 * previewHeight / aHeight;
+	const int y2 = ( changed.y2 * previewHeight + aHeight - 1 ) / aHeight;
+	const int width = x2 - x1;
+
+	// box-filter the grid into those texels, a band of rows per task, without holding up update() and upload()
+	mScratch.resize( width * ( y2 - y1 ) );
+	WorkerPool::getShared().parallelFor( y2 - y1, [&]( size_t aBegin, size_t aEnd ) {
+		for ( int y = y1 + (int)aBegin; y < y1 + (int)aEnd; y++ ) {
+			const int sy1 = y * aHeight / previewHeight;
+			const int sy2 = math<int>::max( ( y + 1 ) * aHeight / previewHeight, sy1 + 1 );
+			float *row = &mScratch[( y - y1 ) * width];
+			for ( int x = x1; x < x2; x++ ) {
+				const int sx1 = x * aWidth / previewWidth;
+				const int sx2 = math<int>::max( ( x + 1 ) * aWidth / previewWidth, sx1 + 1 );
+				float sum = 0.0f;
+				for ( int sy = sy1; sy < sy2; sy++ ) {
+					const float *source = aData + (size_t)sy * aWidth;
+					for ( int sx = sx1; sx < sx2; sx++ ) sum += source[sx];
+				}
+				row[x - x1] = sum / ( ( sx2 - sx1 ) * ( sy2 - sy1 ) );
+			}
+		}
+	}, 8 );
+
+	lock_guard<mutex> lock( mMutex );
+	if ( resized ) {
+		mGridWidth = aWidth;
+		mGridHeight = aHeight;
+		mPreviewWidth = previewWidth;
+		mPreviewHeight = previewHeight;
+		mPixels.assign( mPreviewWidth * mPreviewHeight, 0 );
+		mTilesX = ( mPreviewWidth + TILE_SIZE - 1 ) / TILE_SIZE;
+		mTilesY = ( mPreviewHeight + TILE_SIZE - 1 ) / TILE_SIZE;
+		mDirtyTiles.assign( mTilesX * mTilesY, TILE_CLEAN );
+		mResized = true;
+	}
+
+	if ( width == mPreviewWidth && y2 - y1 == mPreviewHeight ) {
+		// the whole preview changed
+		mPreview.swap( mScratch );
+	} else {
+		for ( int y = y1; y < y2; y++ ) {
+			memcpy( &mPreview[y * mPreviewWidth + x1], &mScratch[( y - y1 ) * width], width * sizeof( float ) );
+		}
+	}
+
+	for ( int ty = y1 / TILE_SIZE; ty <= ( y2 - 1 ) / TILE_SIZE; ty++ ) {
+		for ( int tx = x1 / TILE_SIZE; tx <= ( x2 - 1 ) / TILE_SIZE; tx++ ) {
+			mDirtyTiles[ty * mTilesX + tx] = TILE_CHANGED;
+		}
+	}
+	mDirty = true;
+}
+
+void Heatmap::setRange( const float &aMin, const float &aMax )
+{
+	lock_guard<mutex> lock( mMutex );
+	mMin = aMin;
+	mMax = aMax;
+	fill( mDirtyTiles.begin(), mDirtyTiles.end(), (uint8_t)TILE_CHANGED );
+	mDirty = !mDirtyTiles.empty();
+}
+
+void Heatmap::releaseResources()
+{
+	UIElement::releaseResources();
+	lock_guard<mutex> lock( mMutex );
+	mTexture.reset();
+	// every tile goes up again into a new texture on the next update
+	mResized = true;
+	fill( mDirtyTiles.begin(), mDirtyTiles.end(), (uint8_t)TILE_CHANGED );
+	mDirty = !mDirtyTiles.empty();
+}
+
+void Heatmap::update()
+{
+	lock_guard<mutex> lock( mMutex );
+	if ( !mDirty ) return;
+
+	// color the changed tiles, a band of rows per task
+	WorkerPool::getShared().parallelFor( mPreviewHeight, [this]( size_t aBegin, size_t aEnd ) {
+		for ( int y = (int)aBegin; y < (int)aEnd; y++ ) {
+			const int ty = y / TILE_SIZE;
+			for ( int tx = 0; tx < mTilesX; tx++ ) {
+				if ( mDirtyTiles[ty * mTilesX + tx] != TILE_CHANGED ) continue;
+				const int x = tx * TILE_SIZE;
+				const int offset = y * mPreviewWidth + x;
+				colormapRow( &mPreview[offset], &mPixels[offset], math<int>::min( TILE_SIZE, mPreviewWidth - x ) );
+			}
+		}
+	}, 8 );
+
+	for ( unsigned int i = 0; i < mDirtyTiles.size(); i++ ) {
+		if ( mDirtyTiles[i] == TILE_CHANGED ) mDirtyTiles[i] = TILE_COLORED;
+	}
+	mDirty = false;
+	mColored = true;
+}
+
+void Heatmap::upload()
+{
+	lock_guard<mutex> lock( mMutex );
+	if ( !mColored ) return;
+
+	if ( mResized ) {
+		gl::Texture::Format format;
+		format.setMinFilter( GL_NEAREST );
+		format.setMagFilter( GL_NEAREST );
+		mTexture = gl::Texture( mPreviewWidth, mPreviewHeight, format );
+		mResized = false;
+	}
+
+	// upload just the tiles update() colored; tiles changed again since wait for the next one
+	mTexture.bind();
+	glPixelStorei( GL_UNPACK_ROW_LENGTH, mPreviewWidth );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	for ( int ty = 0; ty < mTilesY; ty++ ) {
+		for ( int tx = 0; tx < mTilesX; tx++ ) {
+			if ( mDirtyTiles[ty * mTilesX + tx] != TILE_COLORED ) continue;
+			const int x = tx * TILE_SIZE;
+			const int y = ty * TILE_SIZE;
+			const int width = math<int>::min( TILE_SIZE, mPreviewWidth - x );
+			const int height = math<int>::min( TILE_SIZE, mPreviewHeight - y );
+			glTexSubImage2D( GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &mPixels[y * mPreviewWidth + x] );
+			mDirtyTiles[ty * mTilesX + tx] = TILE_CLEAN;
+		}
+	}
+	glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+	mTexture.unbind();
+	mColored = false;
+}
+
+void Heatmap::draw()
+{
+	// draw the field
+	if ( mTexture ) {
+		gl::color( Color::white() );
+		gl::draw( mTexture, getBounds() );
+	}
+
+	// draw the outer rect
+	gl::color( UIController::DEFAULT_STROKE_COLOR );
+	gl::drawStrokedRect( getBounds() );
+
+	// draw the label
+	drawLabel();
+}
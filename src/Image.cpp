@@ -5,31 +5,33 @@ using namespace ci::app;
 using namespace std;
 using namespace MinimalUI;
 
-Image::Image( UIController *aUIController, const string &aName, ImageSourceRef aImage, const string &aParamString ) : UIElement( aUIController, aName, aParamString )
+Image::Image( UIController *aUIController, const string &aName, ImageSourceRef aImage, const Params &aParams ) : UIElement( aUIController, aName, aParams )
 {
 	// initialize unique variables
+	mStatic = hasParam( "cached" ) ? getParam<bool>( "cached" ) : true;
 	
-	// create texture from data source
-	setBackgroundTexture( gl::Texture( aImage ) );
+	// the image is packed into the controller's texture atlas once the panel is shown
+	setBackgroundImage( PendingImage( aImage ) );
 	
-	// set actual size based on the height of the texture, divided by 2 because we render it twice as large for retina displays
+	// set actual size based on the size of the image and its pixel density ("density", 2 for images made for retina displays)
 	// if width and/or height are specified, override size
-	int x = hasParam( "width" ) ? getParam<int>( "width" ) : getBackgroundTexture().getWidth() / 2;
-	int y = hasParam( "height" ) ? getParam<int>( "height" ) : getBackgroundTexture().getHeight() / 2;
+	float density = hasParam( "density" ) ? getParam<float>( "density" ) : 2.0f;
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : (int)( aImage->getWidth() / density );
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : (int)( aImage->getHeight() / density );
 	setSize( Vec2i( x, y ) );
 	
 	// set position and bounds
 	setPositionAndBounds();
 }
 
-UIElementRef Image::create( UIController *aUIController, const string &aName, ImageSourceRef aImage, const string &aParamString )
+UIElementRef Image::create( UIController *aUIController, const string &aName, ImageSourceRef aImage, const Params &aParams )
 {
-	return shared_ptr<Image>( new Image( aUIController, aName, aImage, aParamString ) );
+	return shared_ptr<Image>( new Image( aUIController, aName, aImage, aParams ) );
 }
 
 void Image::draw()
 {
-	drawBackground();
+	// the image is the background, which the controller draws with the other elements' from the texture atlas
 }
 
 void Image::setPositionAndBounds()
@@ -0,0 +1,281 @@
+#include "ImageSequence.h"
+#include "WorkerPool.h"
+
+#include <cstring>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+int ImageSequence::DEFAULT_WIDTH = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+
+namespace {
+
+	// Receives decoded rows one at a time and box-filters them straight into a frame buffer, so a full-size copy of the
+	// image is never kept. Decoders hand out rows in order: each row is consumed when the next one is requested.
+	class DownscaleTarget : public ImageTarget {
+	public:
+		DownscaleTarget( const ImageSourceRef &aSource, ImageSequence::Frame *aFrame, const int &aWidth, const int &aHeight )
+			: mFrame( aFrame ), mWidth( aWidth ), mHeight( aHeight ), mPendingRow( -1 ), mDestRow( 0 ), mRowsInSums( 0 )
+		{
+			setSize( aSource->getWidth(), aSource->getHeight() );
+			setColorModel( ImageIo::CM_RGB );
+			setDataType( ImageIo::UINT8 );
+			setChannelOrder( ImageIo::RGBA );
+
+			const int sourceWidth = aSource->getWidth();
+			mSourceHeight = aSource->getHeight();
+			if ( (int)mFrame->mRow.size() < sourceWidth * 4 ) mFrame->mRow.resize( sourceWidth * 4 );
+			mFrame->mSums.assign( mWidth * 4, 0 );
+
+			// source columns [mColumns[x], mColumns[x + 1]) feed destination column x, at least one each
+			mColumns.resize( mWidth + 1 );
+			for ( int x = 0; x <= mWidth; x++ ) mColumns[x] = x * sourceWidth / mWidth;
+		}
+
+		void* getRowPointer( int32_t aRow )
+		{
+			if ( mPendingRow >= 0 ) consumeRow( mPendingRow );
+			mPendingRow = aRow;
+			return &mFrame->mRow[0];
+		}
+
+		void finalize()
+		{
+			if ( mPendingRow >= 0 ) consumeRow( mPendingRow );
+			mPendingRow = -1;
+		}
+
+		bool hasAlpha() const { return true; }
+
+	private:
+		int rowStart( const int &aDestRow ) const { return aDestRow * mSourceHeight / mHeight; }
+		int rowEnd( const int &aDestRow ) const { return math<int>::max( ( aDestRow + 1 ) * mSourceHeight / mHeight, rowStart( aDestRow ) + 1 ); }
+
+		void consumeRow( const int &aRow )
+		{
+			if ( mDestRow >= mHeight || aRow < rowStart( mDestRow ) ) return;
+
+			const uint8_t *row = &mFrame->mRow[0];
+			uint32_t *sums = &mFrame->mSums[0];
+			for ( int x = 0; x < mWidth; x++ ) {
+				const int x1 = mColumns[x], x2 = math<int>::max( mColumns[x + 1], x1 + 1 );
+				uint32_t r = 0, g = 0, b = 0, a = 0;
+				for ( int sx = x1; sx < x2; sx++ ) {
+					r += row[sx * 4];
+					g += row[sx * 4 + 1];
+					b += row[sx * 4 + 2];
+					a += row[sx * 4 + 3];
+				}
+				sums[x * 4] += r;
+				sums[x * 4 + 1] += g;
+				sums[x * 4 + 2] += b;
+				sums[x * 4 + 3] += a;
+			}
+			mRowsInSums++;
+
+			// emit every destination row this source row completes; when upscaling, one source row completes several
+			while ( mDestRow < mHeight && rowEnd( mDestRow ) <= aRow + 1 ) {
+				uint8_t *dest = &mFrame->mPixels[mDestRow * mWidth * 4];
+				for ( int x = 0; x < mWidth; x++ ) {
+					const uint32_t count = mRowsInSums * ( math<int>::max( mColumns[x + 1], mColumns[x] + 1 ) - mColumns[x] );
+					for ( int c = 0; c < 4; c++ ) dest[x * 4 + c] = (uint8_t)( sums[x * 4 + c] / count );
+				}
+				mDestRow++;
+				if ( mDestRow < mHeight && rowStart( mDestRow ) <= aRow ) continue;
+				memset( sums, 0, mWidth * 4 * sizeof( uint32_t ) );
+				mRowsInSums = 0;
+			}
+		}
+
+		ImageSequence::Frame *mFrame;
+		int mWidth, mHeight, mSourceHeight;
+		std::vector<int> mColumns;
+		int mPendingRow;
+		int mDestRow;
+		uint32_t mRowsInSums;
+	};
+
+}
+
+ImageSequence::ImageSequence( UIController *aUIController, const string &aName, const vector<string> &aPaths, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
+{
+	// initialize unique variables
+	mFrameRate = hasParam( "fps" ) ? getParam<double>( "fps" ) : 30.0;
+	mLoop = hasParam( "loop" ) ? getParam<bool>( "loop" ) : true;
+	mPrefetch = hasParam( "prefetch" ) ? math<int>::max( getParam<int>( "prefetch" ), 1 ) : 8;
+	mPlaying = false;
+	mStartTime = mPausedAt = 0.0;
+	mShownIndex = -1;
+	mDroppedFrames = mShownFrames = 0;
+	mCurrentTexture = 0;
+	mHasFrame = false;
+	mUploadFrame = nullptr;
+
+	// set size, 16:9 unless given
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : ImageSequence::DEFAULT_WIDTH;
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : x * 9 / 16;
+	setSize( Vec2i( x, y ) );
+
+	// frames are decoded at the element's size in pixels, into buffers that are allocated once
+	mPool = make_shared<Pool>();
+	mPool->mPaths = aPaths;
+	mPool->mWidth = getSize().x;
+	mPool->mHeight = getSize().y;
+	for ( int i = 0; i < mPrefetch + 1; i++ ) {
+		unique_ptr<Frame> frame( new Frame );
+		frame->mState = Frame::FREE;
+		frame->mIndex = -1;
+		frame->mPixels.resize( mPool->mWidth * mPool->mHeight * 4 );
+		mPool->mFrames.push_back( move( frame ) );
+	}
+
+	// set position and bounds
+	setPositionAndBounds();
+
+	if ( hasParam( "autoplay" ) ? getParam<bool>( "autoplay" ) : true ) play();
+}
+
+UIElementRef ImageSequence::create( UIController *aUIController, const string &aName, const vector<string> &aPaths, const Params &aParams )
+{
+	return shared_ptr<ImageSequence>( new ImageSequence( aUIController, aName, aPaths, aParams ) );
+}
+
+void ImageSequence::play()
+{
+	if ( mPlaying ) return;
+	mPlaying = true;
+	// resume from where we paused
+	mStartTime = getElapsedSeconds() - mPausedAt;
+}
+
+void ImageSequence::pause()
+{
+	if ( !mPlaying ) return;
+	mPlaying = false;
+	mPausedAt = getElapsedSeconds() - mStartTime;
+}
+
+int64_t ImageSequence::getFrameAtTime( const double &aTime ) const
+{
+	int64_t index = (int64_t)( aTime * mFrameRate );
+	if ( !mLoop ) index = math<int64_t>::min( index, (int64_t)mPool->mPaths.size() - 1 );
+	return index;
+}
+
+void ImageSequence::schedule( const int64_t &aFirst )
+{
+	const int64_t numPaths = mPool->mPaths.size();
+	const int64_t last = mLoop ? aFirst + mPrefetch : math<int64_t>::min( aFirst + mPrefetch, numPaths );
+	for ( int64_t index = aFirst; index < last; index++ ) {
+		// already decoded or on its way?
+		Frame *free = nullptr;
+		bool pending = false;
+		for ( unsigned int i = 0; i < mPool->mFrames.size(); i++ ) {
+			Frame *frame = mPool->mFrames[i].get();
+			int state = frame->mState.load( memory_order_acquire );
+			if ( state == Frame::FREE ) {
+				if ( !free ) free = frame;
+			} else if ( frame->mIndex == index ) {
+				pending = true;
+				break;
+			}
+		}
+		if ( pending ) continue;
+		if ( !free ) return;
+
+		free->mIndex = index;
+		free->mState.store( Frame::DECODING, memory_order_release );
+		shared_ptr<Pool> pool = mPool;
+		string path = pool->mPaths[index % numPaths];
+		WorkerPool::getShared().enqueue( [pool, free, path] {
+			try {
+				ImageSourceRef source = loadImage( path );
+				source->load( ImageTargetRef( new DownscaleTarget( source, free, pool->mWidth, pool->mHeight ) ) );
+				free->mState.store( Frame::READY, memory_order_release );
+			} catch ( ... ) {
+				free->mState.store( Frame::FAILED, memory_order_release );
+			}
+		} );
+	}
+}
+
+void ImageSequence::releaseResources()
+{
+	UIElement::releaseResources();
+	for ( int i = 0; i < 2; i++ ) mTextures[i].reset();
+	// upload the target frame again once there's somewhere to put it
+	mHasFrame = false;
+	mShownIndex = -1;
+	if ( mUploadFrame ) {
+		mUploadFrame->mState.store( Frame::FREE, memory_order_release );
+		mUploadFrame = nullptr;
+	}
+}
+
+void ImageSequence::update()
+{
+	if ( mPool->mPaths.empty() ) return;
+
+	const int64_t target = getFrameAtTime( mPlaying ? getElapsedSeconds() - mStartTime : mPausedAt );
+
+	// pick the target frame if it's ready, and recycle anything that's too late to show
+	for ( unsigned int i = 0; i < mPool->mFrames.size(); i++ ) {
+		Frame *frame = mPool->mFrames[i].get();
+		if ( frame == mUploadFrame ) continue;
+		int state = frame->mState.load( memory_order_acquire );
+		if ( state == Frame::READY && frame->mIndex == target && target != mShownIndex ) {
+			// a frame picked but never uploaded was skipped too
+			if ( mUploadFrame ) mUploadFrame->mState.store( Frame::FREE, memory_order_release );
+			mUploadFrame = frame;
+
+			// everything between the last frame shown and this one missed its slot
+			if ( mShownIndex >= 0 && target > mShownIndex + 1 ) mDroppedFrames += target - mShownIndex - 1;
+			mShownIndex = target;
+			mShownFrames++;
+		} else if ( ( state == Frame::READY || state == Frame::FAILED ) && frame->mIndex <= target ) {
+			frame->mState.store( Frame::FREE, memory_order_release );
+		}
+	}
+
+	// decode ahead of what's on screen
+	schedule( target == mShownIndex ? target + 1 : target );
+}
+
+void ImageSequence::upload()
+{
+	if ( !mUploadFrame ) return;
+
+	// the textures are made on the first upload, which doesn't happen until the panel is shown
+	if ( !mTextures[0] ) {
+		gl::Texture::Format format;
+		format.setMinFilter( GL_LINEAR );
+		format.setMagFilter( GL_LINEAR );
+		for ( int i = 0; i < 2; i++ ) {
+			mTextures[i] = gl::Texture( mPool->mWidth, mPool->mHeight, format );
+		}
+	}
+
+	mCurrentTexture = 1 - mCurrentTexture;
+	mTextures[mCurrentTexture].bind();
+	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, mPool->mWidth, mPool->mHeight, GL_RGBA, GL_UNSIGNED_BYTE, &mUploadFrame->mPixels[0] );
+	mTextures[mCurrentTexture].unbind();
+	mHasFrame = true;
+	mUploadFrame->mState.store( Frame::FREE, memory_order_release );
+	mUploadFrame = nullptr;
+}
+
+void ImageSequence::draw()
+{
+	// draw the current frame
+	if ( mHasFrame ) {
+		gl::color( Color::white() );
+		gl::draw( mTextures[mCurrentTexture], getBounds() );
+	}
+
+	// draw the outer rect
+	gl::color( UIController::DEFAULT_STROKE_COLOR );
+	gl::drawStrokedRect( getBounds() );
+}
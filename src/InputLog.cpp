@@ -0,0 +1,273 @@
+#include "InputLog.h"
+#include "UIController.h"
+#include "UIElement.h"
+#include "VarInt.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+size_t InputCapture::DEFAULT_FLUSH_SIZE = 1 << 16;
+
+const double InputReplayer::AS_FAST_AS_POSSIBLE = 0.0;
+float InputReplayer::DEFAULT_TOLERANCE = 1.0e-6f;
+
+// file format: a 4 byte magic, the number of elements in the panel and their values, then one record per event:
+//   byte    record type
+//   varint  time delta since the previous record, in microseconds
+//   varint  zigzag x, varint zigzag y, for mouse records
+// and an END record with the values at the end of the capture. A block of values is a varint count, then for each
+// value a varint element id, a channel byte and the varint of the value's bits.
+static const char INPUT_MAGIC[4] = { 'M', 'U', 'I', 'I' };
+
+namespace {
+	enum RecordType { FRAME, MOUSE_DOWN, MOUSE_DOWN_RIGHT, MOUSE_UP, MOUSE_DRAG, END };
+
+	double elapsedMicroseconds( const chrono::steady_clock::time_point &aStart )
+	{
+		return chrono::duration<double, micro>( chrono::steady_clock::now() - aStart ).count();
+	}
+}
+
+// InputCapture
+InputCapture::InputCapture( UIController *aUIController, const string &aPath )
+	: mParent( aUIController ), mPreviousTime( 0 ), mNumEvents( 0 ), mStopped( false )
+{
+	mFile.open( aPath.c_str(), ios::binary | ios::trunc );
+	if ( !mFile ) throw InputLogExc( aPath );
+	mFile.write( INPUT_MAGIC, sizeof( INPUT_MAGIC ) );
+
+	// the starting values, so a replay starts from the same state
+	mBuffer.reserve( DEFAULT_FLUSH_SIZE + 32 );
+	writeVarint( mBuffer, mParent->getNumElements() );
+	writeValues();
+	mStartTime = chrono::steady_clock::now();
+}
+
+InputCapture::~InputCapture()
+{
+	stop();
+}
+
+InputCaptureRef InputCapture::create( UIController *aUIController, const string &aPath )
+{
+	return shared_ptr<InputCapture>( new InputCapture( aUIController, aPath ) );
+}
+
+void InputCapture::beginRecord( const uint8_t &aType )
+{
+	const int64_t time = chrono::duration_cast<chrono::microseconds>( chrono::steady_clock::now() - mStartTime ).count();
+	mBuffer.push_back( aType );
+	writeVarint( mBuffer, (uint64_t)( time - mPreviousTime ) );
+	mPreviousTime = time;
+	mNumEvents++;
+}
+
+void InputCapture::writePosition( const Vec2i &aPos )
+{
+	writeVarint( mBuffer, zigzagEncode( aPos.x ) );
+	writeVarint( mBuffer, zigzagEncode( aPos.y ) );
+	if ( mBuffer.size() >= DEFAULT_FLUSH_SIZE ) flush();
+}
+
+void InputCapture::writeValues()
+{
+	uint64_t count = 0;
+	for ( int i = 0; i < mParent->getNumElements(); i++ ) count += mParent->getElement( i )->getNumValues();
+	writeVarint( mBuffer, count );
+	for ( int i = 0; i < mParent->getNumElements(); i++ ) {
+		UIElementRef element = mParent->getElement( i );
+		for ( int channel = 0; channel < element->getNumValues(); channel++ ) {
+			writeVarint( mBuffer, (uint32_t)i );
+			mBuffer.push_back( (uint8_t)channel );
+			writeVarint( mBuffer, floatBits( element->getValue( channel ) ) );
+		}
+	}
+}
+
+void InputCapture::frame()
+{
+	beginRecord( FRAME );
+	if ( mBuffer.size() >= DEFAULT_FLUSH_SIZE ) flush();
+}
+
+void InputCapture::mouseDown( const Vec2i &aPos, const bool &aRight )
+{
+	beginRecord( aRight ? MOUSE_DOWN_RIGHT : MOUSE_DOWN );
+	writePosition( aPos );
+}
+
+void InputCapture::mouseUp( const Vec2i &aPos )
+{
+	beginRecord( MOUSE_UP );
+	writePosition( aPos );
+}
+
+void InputCapture::mouseDrag( const Vec2i &aPos )
+{
+	beginRecord( MOUSE_DRAG );
+	writePosition( aPos );
+}
+
+void InputCapture::stop()
+{
+	if ( mStopped )
+		return;
+	mStopped = true;
+
+	beginRecord( END );
+	writeValues();
+	flush();
+	mFile.close();
+}
+
+void InputCapture::flush()
+{
+	if ( mBuffer.empty() )
+		return;
+
+	mFile.write( (const char *)mBuffer.data(), mBuffer.size() );
+	mBuffer.clear();
+}
+
+// InputReplayer
+InputReplayer::InputReplayer( UIController *aUIController, const string &aPath )
+	: mParent( aUIController ), mHeaderSize( 0 ), mNumElements( 0 ), mReport( nullptr )
+{
+	// captures are small; read the whole thing so the replay's timings don't include disk reads
+	ifstream file( aPath.c_str(), ios::binary );
+	if ( !file ) throw InputLogExc( aPath );
+	mData.assign( istreambuf_iterator<char>( file ), istreambuf_iterator<char>() );
+
+	size_t position = sizeof( INPUT_MAGIC );
+	uint64_t numElements;
+	if ( mData.size() < position || memcmp( mData.data(), INPUT_MAGIC, sizeof( INPUT_MAGIC ) ) != 0 ||
+		!readVarint( mData.data(), mData.size(), position, numElements ) || !readValues( position, mInitialValues ) ) {
+		throw InputLogExc( aPath );
+	}
+	mNumElements = (uint32_t)numElements;
+	mHeaderSize = position;
+}
+
+bool InputReplayer::readValues( size_t &aPosition, vector<Value> &aValues ) const
+{
+	uint64_t count, id, bits;
+	if ( !readVarint( mData.data(), mData.size(), aPosition, count ) ) return false;
+	aValues.clear();
+	for ( uint64_t i = 0; i < count; i++ ) {
+		if ( !readVarint( mData.data(), mData.size(), aPosition, id ) || aPosition >= mData.size() ) return false;
+		Value value;
+		value.mElementId = (uint32_t)id;
+		value.mChannel = mData[aPosition++];
+		if ( !readVarint( mData.data(), mData.size(), aPosition, bits ) ) return false;
+		value.mValue = bitsFloat( (uint32_t)bits );
+		aValues.push_back( value );
+	}
+	return true;
+}
+
+void InputReplayer::valueChanged( const uint32_t &aElementId )
+{
+	if ( mReport && aElementId < mReport->mCallbackCounts.size() ) mReport->mCallbackCounts[aElementId]++;
+}
+
+InputReplayer::Report InputReplayer::run( const double &aSpeed )
+{
+	Report report;
+	report.mNumEvents = report.mNumFrames = 0;
+	report.mCallbackCounts.assign( mParent->getNumElements(), 0 );
+	report.mPanelMatches = mNumElements == (uint32_t)mParent->getNumElements();
+	report.mComplete = false;
+	mReport = &report;
+
+	for ( unsigned int i = 0; i < mInitialValues.size(); i++ ) {
+		UIElementRef element = mParent->getElement( mInitialValues[i].mElementId );
+		if ( element && mInitialValues[i].mChannel < element->getNumValues() ) element->setValue( mInitialValues[i].mChannel, mInitialValues[i].mValue );
+	}
+
+	const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	size_t position = mHeaderSize;
+	uint64_t time = 0, delta, x, y;
+	vector<Value> finalValues;
+	bool ended = false;
+	while ( !ended && position < mData.size() ) {
+		const uint8_t type = mData[position++];
+		if ( !readVarint( mData.data(), mData.size(), position, delta ) ) break;
+		time += delta;
+		if ( aSpeed > 0.0 ) {
+			this_thread::sleep_until( start + chrono::microseconds( (int64_t)( time / aSpeed ) ) );
+		}
+
+		if ( type == FRAME ) {
+			const chrono::steady_clock::time_point handled = chrono::steady_clock::now();
+			mParent->update();
+			report.mFrameLatency.add( (float)elapsedMicroseconds( handled ) );
+			report.mNumFrames++;
+		} else if ( type == END ) {
+			ended = report.mComplete = readValues( position, finalValues );
+		} else {
+			if ( !readVarint( mData.data(), mData.size(), position, x ) || !readVarint( mData.data(), mData.size(), position, y ) ) break;
+			const int button = type == MOUSE_DOWN_RIGHT ? MouseEvent::RIGHT_DOWN : MouseEvent::LEFT_DOWN;
+			MouseEvent event( mParent->getWindow(), button, zigzagDecode( (uint32_t)x ), zigzagDecode( (uint32_t)y ), button, 0.0f, 0 );
+
+			const chrono::steady_clock::time_point handled = chrono::steady_clock::now();
+			EventType eventType;
+			if ( type == MOUSE_UP ) {
+				mParent->mouseUp( event );
+				eventType = InputReplayer::MOUSE_UP;
+			} else if ( type == MOUSE_DRAG ) {
+				mParent->mouseDrag( event );
+				eventType = InputReplayer::MOUSE_DRAG;
+			} else {
+				mParent->mouseDown( event );
+				eventType = InputReplayer::MOUSE_DOWN;
+			}
+			report.mEventLatency[eventType].add( (float)elapsedMicroseconds( handled ) );
+			report.mNumEvents++;
+		}
+	}
+	report.mDuration = elapsedMicroseconds( start ) * 1.0e-6;
+	mReport = nullptr;
+
+	for ( unsigned int i = 0; i < finalValues.size(); i++ ) {
+		const Value &recorded = finalValues[i];
+		UIElementRef element = mParent->getElement( recorded.mElementId );
+		if ( !element || recorded.mChannel >= element->getNumValues() ) continue;
+		const float replayed = element->getValue( recorded.mChannel );
+		if ( fabs( replayed - recorded.mValue ) > DEFAULT_TOLERANCE * max( 1.0f, fabs( recorded.mValue ) ) ) {
+			Divergence divergence = { recorded.mElementId, recorded.mChannel, recorded.mValue, replayed };
+			report.mDivergences.push_back( divergence );
+		}
+	}
+	return report;
+}
+
+string InputReplayer::Report::toString() const
+{
+	static const char *names[NUM_EVENT_TYPES] = { "mouse down", "mouse up", "mouse drag" };
+	ostringstream out;
+	out << mNumEvents << " events, " << mNumFrames << " frames in " << mDuration << " s" << ( passed() ? "" : ", FAILED" ) << "\n";
+	for ( int i = 0; i < NUM_EVENT_TYPES; i++ ) {
+		const PercentileSketch &sketch = mEventLatency[i];
+		out << names[i] << ": " << sketch.getCount() << ", p50 " << sketch.getPercentile( 0.5f ) << " us, p99 " << sketch.getPercentile( 0.99f ) << " us, max " << sketch.getMax() << " us\n";
+	}
+	out << "update: p50 " << mFrameLatency.getPercentile( 0.5f ) << " us, p99 " << mFrameLatency.getPercentile( 0.99f ) << " us, max " << mFrameLatency.getMax() << " us\n";
+	out << "value changes:";
+	for ( unsigned int i = 0; i < mCallbackCounts.size(); i++ ) {
+		if ( mCallbackCounts[i] ) out << " " << i << ":" << mCallbackCounts[i];
+	}
+	out << "\n";
+	if ( !mPanelMatches ) out << "the panel has a different number of elements than the capture\n";
+	if ( !mComplete ) out << "the capture has no final values\n";
+	for ( unsigned int i = 0; i < mDivergences.size(); i++ ) {
+		const Divergence &divergence = mDivergences[i];
+		out << "element " << divergence.mElementId << " channel " << (int)divergence.mChannel << ": recorded " << divergence.mRecorded << ", replayed " << divergence.mReplayed << "\n";
+	}
+	return out.str();
+}
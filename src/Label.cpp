@@ -7,22 +7,24 @@ using namespace MinimalUI;
 
 int Label::DEFAULT_WIDTH = UIElement::DEFAULT_HEIGHT * 2 + UIController::DEFAULT_MARGIN_SMALL;
 
-Label::Label( UIController *aUIController, const string &aName, const string &aParamString ) : UIElement( aUIController, aName, aParamString )
+Label::Label( UIController *aUIController, const string &aName, const Params &aParams ) : UIElement( aUIController, aName, aParams )
 {
 	// initialize unique variables
 	mNarrow = hasParam( "narrow" ) ? getParam<bool>( "narrow" ) : false;
+	mStatic = hasParam( "cached" ) ? getParam<bool>( "cached" ) : true;
 
 	// set initial size and render name texture
 	int x = hasParam( "width" ) ? getParam<int>( "width" ) : Label::DEFAULT_WIDTH;
 	setSize( Vec2i( x, 0 ) );
 	renderNameTexture();
 	
-	// set actual size based on the height of the name texture, divided by 2 because we render it twice as large for retina displays
+	// set actual size based on the height of the name, measured so a hidden panel needn't rasterize it yet
 	int y;
+	float height = measureName().y;
 	if ( mNarrow ) {
-		y = math<float>::min( getNameTexture().getHeight() / 2, UIElement::DEFAULT_HEIGHT );
+		y = math<float>::min( height, UIElement::DEFAULT_HEIGHT );
 	} else {
-		y = math<float>::max( getNameTexture().getHeight() / 2, UIElement::DEFAULT_HEIGHT );
+		y = math<float>::max( height, UIElement::DEFAULT_HEIGHT );
 	}
 	setSize( Vec2i( mSize.x, y ) );
 
@@ -30,16 +32,13 @@ Label::Label( UIController *aUIController, const string &aName, const string &aP
 	setPositionAndBounds();
 }
 
-UIElementRef Label::create( UIController *aUIController, const string &aName, const string &aParamString )
+UIElementRef Label::create( UIController *aUIController, const string &aName, const Params &aParams )
 {
-	return shared_ptr<Label>( new Label( aUIController, aName, aParamString ) );
+	return shared_ptr<Label>( new Label( aUIController, aName, aParams ) );
 }
 
 void Label::draw()
 {
-	// draw the background
-	drawBackground();
-
 	// draw the label
 	drawLabel();
 }
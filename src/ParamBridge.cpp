@@ -0,0 +1,106 @@
+#include "ParamBridge.h"
+#include "UIController.h"
+#include "UIElement.h"
+#include "VarInt.h"
+
+#include <cstring>
+
+using namespace std;
+using namespace MinimalUI;
+
+uint32_t ParamBridge::DEFAULT_MAX_SLOTS = 1024;
+uint32_t ParamBridge::DEFAULT_QUEUE_SIZE = 4096;
+
+ParamBridge::ParamBridge( UIController *aUIController, const SharedMemoryRef &aMemory, const uint32_t &aMaxSlots, const uint32_t &aQueueSize )
+	: mParent( aUIController ), mMemory( aMemory )
+{
+	uint8_t *data = (uint8_t *)mMemory->getData();
+	mHeader = (ParamBridgeHeader *)data;
+	mSlots = (ParamBridgeSlot *)( data + sizeof( ParamBridgeHeader ) );
+	mQueue = (std::atomic<uint32_t> *)( data + sizeof( ParamBridgeHeader ) + aMaxSlots * sizeof( ParamBridgeSlot ) );
+
+	// the segment is zero-filled, which is a valid initial state for every atomic in it
+	mHeader->mMaxSlots = aMaxSlots;
+	mHeader->mQueueSize = aQueueSize;
+	mHeader->mVersion = PARAM_BRIDGE_VERSION;
+	atomic_thread_fence( memory_order_release );
+	mHeader->mMagic = PARAM_BRIDGE_MAGIC;
+
+	mPublished.reserve( aMaxSlots * PARAM_BRIDGE_MAX_VALUES );
+	mSlotElements.reserve( aMaxSlots );
+}
+
+ParamBridgeRef ParamBridge::create( UIController *aUIController, const string &aName, const uint32_t &aMaxSlots, const uint32_t &aQueueSize )
+{
+	// keep the queue size a power of two so indices can wrap freely
+	uint32_t queueSize = 2;
+	while ( queueSize < aQueueSize ) queueSize <<= 1;
+
+	size_t size = sizeof( ParamBridgeHeader ) + aMaxSlots * sizeof( ParamBridgeSlot ) + queueSize * sizeof( uint32_t );
+	SharedMemoryRef memory = SharedMemory::create( aName, size );
+	if ( !memory ) return ParamBridgeRef();
+	return ParamBridgeRef( new ParamBridge( aUIController, memory, aMaxSlots, queueSize ) );
+}
+
+void ParamBridge::publish()
+{
+	// give a slot to every element with bound values that doesn't have one yet
+	for ( int id = mSlotElements.empty() ? 0 : mSlotElements.back() + 1; id < mParent->getNumElements(); id++ ) {
+		UIElementRef element = mParent->getElement( id );
+		int numValues = min<int>( element->getNumValues(), PARAM_BRIDGE_MAX_VALUES );
+		if ( numValues == 0 ) continue;
+		if ( mSlotElements.size() == mHeader->mMaxSlots ) break;
+
+		uint32_t index = mSlotElements.size();
+		ParamBridgeSlot &slot = mSlots[index];
+		slot.mElementId = id;
+		slot.mNumValues = numValues;
+		strncpy( slot.mName, element->getName().c_str(), sizeof( slot.mName ) - 1 );
+		for ( int channel = 0; channel < numValues; channel++ ) {
+			float value = element->getValue( channel );
+			slot.mValueBits[channel].store( floatBits( value ), memory_order_relaxed );
+			mPublished.push_back( value );
+		}
+		for ( int channel = numValues; channel < (int)PARAM_BRIDGE_MAX_VALUES; channel++ ) {
+			mPublished.push_back( 0.0f );
+		}
+		mSlotElements.push_back( id );
+		mHeader->mNumSlots.store( index + 1, memory_order_release );
+		notify( index );
+	}
+
+	// republish whatever changed
+	for ( uint32_t index = 0; index < mSlotElements.size(); index++ ) {
+		UIElement *element = mParent->getElement( mSlotElements[index] ).get();
+		ParamBridgeSlot &slot = mSlots[index];
+		float *published = &mPublished[index * PARAM_BRIDGE_MAX_VALUES];
+
+		bool changed = false;
+		for ( uint32_t channel = 0; channel < slot.mNumValues; channel++ ) {
+			changed |= element->getValue( channel ) != published[channel];
+		}
+		if ( !changed ) continue;
+
+		uint32_t sequence = slot.mSequence.load( memory_order_relaxed );
+		slot.mSequence.store( sequence + 1, memory_order_relaxed );
+		atomic_thread_fence( memory_order_release );
+		for ( uint32_t channel = 0; channel < slot.mNumValues; channel++ ) {
+			published[channel] = element->getValue( channel );
+			slot.mValueBits[channel].store( floatBits( published[channel] ), memory_order_relaxed );
+		}
+		slot.mSequence.store( sequence + 2, memory_order_release );
+		notify( index );
+	}
+}
+
+void ParamBridge::notify( const uint32_t &aSlot )
+{
+	uint32_t head = mHeader->mQueueHead.load( memory_order_relaxed );
+	if ( head - mHeader->mQueueTail.load( memory_order_acquire ) >= mHeader->mQueueSize ) {
+		// the reader isn't keeping up; tell it to rescan instead of blocking
+		mHeader->mOverflow.store( 1, memory_order_release );
+		return;
+	}
+	mQueue[head & ( mHeader->mQueueSize - 1 )].store( aSlot, memory_order_relaxed );
+	mHeader->mQueueHead.store( head + 1, memory_order_release );
+}
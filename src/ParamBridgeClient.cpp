@@ -0,0 +1,98 @@
+#include "ParamBridge.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace MinimalUI;
+
+ParamBridgeClient::ParamBridgeClient( const SharedMemoryRef &aMemory )
+	: mMemory( aMemory )
+{
+	uint8_t *data = (uint8_t *)mMemory->getData();
+	mHeader = (ParamBridgeHeader *)data;
+	mSlots = (ParamBridgeSlot *)( data + sizeof( ParamBridgeHeader ) );
+	mQueue = (std::atomic<uint32_t> *)( data + sizeof( ParamBridgeHeader ) + mHeader->mMaxSlots * sizeof( ParamBridgeSlot ) );
+
+	// allocate everything up front so polling never does
+	mChanged.reserve( mHeader->mMaxSlots );
+	mSeen.resize( mHeader->mMaxSlots, false );
+}
+
+ParamBridgeClientRef ParamBridgeClient::open( const string &aName )
+{
+	SharedMemoryRef memory = SharedMemory::open( aName );
+	if ( !memory || memory->getSize() < sizeof( ParamBridgeHeader ) ) return ParamBridgeClientRef();
+
+	const ParamBridgeHeader *header = (const ParamBridgeHeader *)memory->getData();
+	if ( header->mMagic != PARAM_BRIDGE_MAGIC || header->mVersion != PARAM_BRIDGE_VERSION ) return ParamBridgeClientRef();
+
+	// the slots and queue are found from sizes in the segment itself, so they have to fit in what was mapped
+	const uint32_t queueSize = header->mQueueSize;
+	const uint64_t size = sizeof( ParamBridgeHeader ) + (uint64_t)header->mMaxSlots * sizeof( ParamBridgeSlot ) + (uint64_t)queueSize * sizeof( uint32_t );
+	if ( queueSize == 0 || ( queueSize & ( queueSize - 1 ) ) != 0 || memory->getSize() < size ) return ParamBridgeClientRef();
+	atomic_thread_fence( memory_order_acquire );
+	return ParamBridgeClientRef( new ParamBridgeClient( memory ) );
+}
+
+const vector<uint32_t> & ParamBridgeClient::poll()
+{
+	for ( size_t i = 0; i < mChanged.size(); i++ ) mSeen[mChanged[i]] = false;
+	mChanged.clear();
+
+	if ( mHeader->mOverflow.exchange( 0, memory_order_acquire ) ) {
+		// skip whatever is queued and report every slot
+		mHeader->mQueueTail.store( mHeader->mQueueHead.load( memory_order_acquire ), memory_order_release );
+		uint32_t numSlots = getNumSlots();
+		for ( uint32_t slot = 0; slot < numSlots; slot++ ) {
+			mChanged.push_back( slot );
+			mSeen[slot] = true;
+		}
+		return mChanged;
+	}
+
+	uint32_t tail = mHeader->mQueueTail.load( memory_order_relaxed );
+	const uint32_t head = mHeader->mQueueHead.load( memory_order_acquire );
+	for ( ; tail != head; tail++ ) {
+		uint32_t slot = mQueue[tail & ( mHeader->mQueueSize - 1 )].load( memory_order_relaxed );
+		if ( slot < mSeen.size() && !mSeen[slot] ) {
+			mSeen[slot] = true;
+			mChanged.push_back( slot );
+		}
+	}
+	mHeader->mQueueTail.store( tail, memory_order_release );
+	return mChanged;
+}
+
+int ParamBridgeClient::findSlot( const string &aName ) const
+{
+	int numSlots = getNumSlots();
+	for ( int slot = 0; slot < numSlots; slot++ ) {
+		if ( strncmp( mSlots[slot].mName, aName.c_str(), sizeof( mSlots[slot].mName ) ) == 0 ) return slot;
+	}
+	return -1;
+}
+
+int ParamBridgeClient::getValues( const int &aSlot, float *aValues ) const
+{
+	const ParamBridgeSlot &slot = mSlots[aSlot];
+	const uint32_t numValues = min<uint32_t>( slot.mNumValues, PARAM_BRIDGE_MAX_VALUES );
+	uint32_t before, after;
+	do {
+		before = slot.mSequence.load( memory_order_acquire );
+		for ( uint32_t channel = 0; channel < numValues; channel++ ) {
+			uint32_t bits = slot.mValueBits[channel].load( memory_order_relaxed );
+			memcpy( &aValues[channel], &bits, sizeof( float ) );
+		}
+		atomic_thread_fence( memory_order_acquire );
+		after = slot.mSequence.load( memory_order_relaxed );
+	} while ( ( before & 1 ) || before != after );
+	return numValues;
+}
+
+float ParamBridgeClient::getValue( const int &aSlot, const int &aChannel ) const
+{
+	float values[PARAM_BRIDGE_MAX_VALUES];
+	getValues( aSlot, values );
+	return values[aChannel];
+}
@@ -0,0 +1,143 @@
+#include "Params.h"
+
+#include "cinder/Json.h"
+
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace ci;
+using namespace std;
+using namespace MinimalUI;
+
+static const char *PARAM_NAMES[ParamSet::NUM_KEYS] = {
+	"group", "icon", "locked", "clear", "nameColor", "backgroundColor", "justification", "style", "backgroundImage", "cached",
+	"width", "height",
+	"min", "max", "minX", "maxX", "minY", "maxY", "foregroundColor", "handleVisible", "vertical", "readout", "precision", "units",
+	"pressed", "stateless", "exclusive", "callbackOnRelease", "continuous", "narrow", "density", "fps", "autoplay", "loop",
+	"prefetch", "capacity", "bins", "log", "decay", "window", "pointSize", "refresh", "graphMax", "colormap", "collapsed"
+};
+
+const char * ParamSet::getName( const Key &aKey )
+{
+	return PARAM_NAMES[aKey];
+}
+
+void ParamSet::set( const Key &aKey, const char *aValue )
+{
+	Value value = { false, 0.0, aValue, -1 };
+	// copy the string so the caller's buffer can go away; a setter called twice leaves the first copy unused
+	const size_t length = aValue ? strlen( aValue ) + 1 : 0;
+	if ( aValue && length <= size_t( MAX_TEXT - mTextSize ) ) {
+		memcpy( mText + mTextSize, aValue, length );
+		value.mText = mTextSize;
+		mTextSize += (int)length;
+	}
+	store( aKey, value );
+}
+
+Params::Params( const string &aJson )
+{
+	JsonTree json( aJson );
+	for ( JsonTree::ConstIter child = json.begin(); child != json.end(); ++child ) {
+		if ( child->getNodeType() != JsonTree::NODE_VALUE ) continue;
+		switch ( child->getValueType() ) {
+			case JsonTree::VALUE_BOOL:
+				set( child->getKey(), child->getValue<bool>() );
+				break;
+			case JsonTree::VALUE_STRING:
+				set( child->getKey(), child->getValue<string>() );
+				break;
+			default:
+				set( child->getKey(), child->getValue<double>() );
+				break;
+		}
+	}
+}
+
+Params::Params( const char *aJson )
+{
+	*this = Params( string( aJson ) );
+}
+
+Params::Params( const ParamSet &aParamSet )
+{
+	for ( int i = 0; i < ParamSet::NUM_KEYS; i++ ) {
+		const ParamSet::Key key = (ParamSet::Key)i;
+		if ( !aParamSet.has( key ) ) continue;
+		const ParamSet::Value &value = aParamSet.mValues[key];
+		if ( const char *text = aParamSet.getString( key ) ) {
+			set( ParamSet::getName( key ), string( text ) );
+		} else if ( value.mIsBool ) {
+			set( ParamSet::getName( key ), value.mNumber != 0.0 );
+		} else {
+			set( ParamSet::getName( key ), value.mNumber );
+		}
+	}
+}
+
+ColorA Params::getColor( const string &aName ) const
+{
+	map<string, Value>::const_iterator it = mValues.find( aName );
+	if ( it == mValues.end() ) return ColorA();
+
+	uint32_t hexValue = (uint32_t)it->second.mNumber;
+	if ( it->second.mIsString ) {
+		stringstream str( it->second.mString );
+		str >> std::hex >> hexValue;
+	}
+	return ColorA::hexA( hexValue );
+}
+
+void Params::set( const string &aName, const bool &aValue )
+{
+	Value &value = mValues[aName];
+	value.mIsString = false;
+	value.mNumber = aValue ? 1.0 : 0.0;
+	value.mString.clear();
+}
+
+void Params::set( const string &aName, const double &aValue )
+{
+	Value &value = mValues[aName];
+	value.mIsString = false;
+	value.mNumber = aValue;
+	value.mString.clear();
+}
+
+void Params::set( const string &aName, const string &aValue )
+{
+	Value &value = mValues[aName];
+	value.mIsString = true;
+	value.mNumber = 0.0;
+	value.mString = aValue;
+}
+
+void Params::read( const string &aName, string &aValue ) const
+{
+	map<string, Value>::const_iterator it = mValues.find( aName );
+	if ( it != mValues.end() ) aValue = it->second.mString;
+}
+
+string Params::toJson() const
+{
+	string result = "{";
+	for ( map<string, Value>::const_iterator it = mValues.begin(); it != mValues.end(); ++it ) {
+		if ( it != mValues.begin() ) result += ",";
+		result += " \"" + it->first + "\": ";
+		if ( it->second.mIsString ) {
+			result += "\"";
+			for ( size_t i = 0; i < it->second.mString.size(); i++ ) {
+				const char c = it->second.mString[i];
+				if ( c == '"' || c == '\\' ) result += '\\';
+				result += c;
+			}
+			result += "\"";
+		} else {
+			char number[32];
+			snprintf( number, sizeof( number ), "%.9g", it->second.mNumber );
+			result += number;
+		}
+	}
+	return result + " }";
+}
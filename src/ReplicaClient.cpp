@@ -0,0 +1,202 @@
+#include "Replication.h"
+#include "VarInt.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace MinimalUI;
+
+namespace {
+	// larger than any panel's snapshot; anything bigger is taken for a corrupt stream
+	const uint32_t MAX_MESSAGE_SIZE = 64 << 20;
+
+	bool readString( const uint8_t *aData, const size_t &aSize, size_t &aPosition, string &aString )
+	{
+		uint64_t length;
+		if ( !readVarint( aData, aSize, aPosition, length ) || length > aSize - aPosition ) return false;
+		aString.assign( (const char *)aData + aPosition, length );
+		aPosition += length;
+		return true;
+	}
+
+	bool readByte( const uint8_t *aData, const size_t &aSize, size_t &aPosition, uint8_t &aByte )
+	{
+		if ( aPosition >= aSize ) return false;
+		aByte = aData[aPosition++];
+		return true;
+	}
+
+	bool readZigzag( const uint8_t *aData, const size_t &aSize, size_t &aPosition, int32_t &aValue )
+	{
+		uint64_t value;
+		if ( !readVarint( aData, aSize, aPosition, value ) ) return false;
+		aValue = zigzagDecode( (uint32_t)value );
+		return true;
+	}
+
+	//! appends aCount samples, each sent as the difference of its bits from the previous one's, keeping the newest aCapacity
+	bool readSamples( const uint8_t *aData, const size_t &aSize, size_t &aPosition, const uint64_t &aCount, const uint32_t &aCapacity, vector<float> &aSamples )
+	{
+		if ( aCount > aCapacity ) return false;
+		uint32_t bits = aSamples.empty() ? 0 : floatBits( aSamples.back() );
+		for ( uint64_t i = 0; i < aCount; i++ ) {
+			int32_t difference;
+			if ( !readZigzag( aData, aSize, aPosition, difference ) ) return false;
+			bits += (uint32_t)difference;
+			aSamples.push_back( bitsFloat( bits ) );
+		}
+		if ( aSamples.size() > aCapacity ) aSamples.erase( aSamples.begin(), aSamples.end() - aCapacity );
+		return true;
+	}
+}
+
+ReplicaClient::ReplicaClient( const TcpSocketRef &aSocket )
+	: mSocket( aSocket ), mNumSnapshots( 0 ), mFrame( 0 ), mBytesReceived( 0 )
+{
+}
+
+ReplicaClientRef ReplicaClient::connect( const string &aAddress, const uint16_t &aPort )
+{
+	TcpSocketRef socket = TcpSocket::connect( aAddress, aPort );
+	if ( !socket ) return ReplicaClientRef();
+	return ReplicaClientRef( new ReplicaClient( socket ) );
+}
+
+const vector<uint32_t> & ReplicaClient::poll()
+{
+	for ( size_t i = 0; i < mChanged.size(); i++ ) mSeen[mChanged[i]] = false;
+	mChanged.clear();
+	if ( !mSocket ) return mChanged;
+
+	uint8_t chunk[65536];
+	for ( ;; ) {
+		const int received = mSocket->receive( chunk, sizeof( chunk ) );
+		if ( received < 0 ) {
+			mSocket.reset();
+			break;
+		}
+		if ( received == 0 ) break;
+		mBytesReceived += received;
+		mBuffer.insert( mBuffer.end(), chunk, chunk + received );
+	}
+
+	// every complete message, in order; a partial one waits for the rest
+	size_t position = 0;
+	while ( mBuffer.size() - position >= 4 ) {
+		const uint8_t *header = &mBuffer[position];
+		const uint32_t length = header[0] | ( header[1] << 8 ) | ( header[2] << 16 ) | ( (uint32_t)header[3] << 24 );
+		const bool complete = length <= mBuffer.size() - position - 4;
+		if ( length > MAX_MESSAGE_SIZE || ( complete && !readMessage( header + 4, length ) ) ) {
+			mSocket.reset();
+			position = mBuffer.size();
+			break;
+		}
+		if ( !complete ) break;
+		position += 4 + length;
+	}
+	mBuffer.erase( mBuffer.begin(), mBuffer.begin() + position );
+	return mChanged;
+}
+
+bool ReplicaClient::readMessage( const uint8_t *aData, const size_t &aSize )
+{
+	size_t position = 0;
+	uint8_t type;
+	uint64_t frame;
+	if ( !readByte( aData, aSize, position, type ) || !readVarint( aData, aSize, position, frame ) ) return false;
+
+	bool result = false;
+	if ( type == REPLICA_SNAPSHOT ) {
+		result = readSnapshot( aData, aSize, position );
+	} else if ( type == REPLICA_DELTA ) {
+		result = readDelta( aData, aSize, position );
+	}
+	if ( result ) mFrame = frame;
+	return result;
+}
+
+bool ReplicaClient::readSnapshot( const uint8_t *aData, const size_t &aSize, size_t &aPosition )
+{
+	if ( aSize - aPosition < 4 ) return false;
+	const uint32_t magic = aData[aPosition] | ( aData[aPosition + 1] << 8 ) | ( aData[aPosition + 2] << 16 ) | ( (uint32_t)aData[aPosition + 3] << 24 );
+	aPosition += 4;
+	uint64_t version, count;
+	if ( magic != REPLICATION_MAGIC || !readVarint( aData, aSize, aPosition, version ) || version != REPLICATION_VERSION ) return false;
+	if ( !readString( aData, aSize, aPosition, mPanelParams ) || !readVarint( aData, aSize, aPosition, count ) || count > aSize ) return false;
+
+	mElements.assign( count, Element() );
+	for ( uint32_t id = 0; id < count; id++ ) {
+		Element &element = mElements[id];
+		uint8_t numValues;
+		uint64_t capacity, sent;
+		if ( !readString( aData, aSize, aPosition, element.mName ) || !readString( aData, aSize, aPosition, element.mParams ) ) return false;
+		if ( !readByte( aData, aSize, aPosition, element.mKind ) ) return false;
+		for ( int i = 0; i < 4; i++ ) {
+			if ( !readZigzag( aData, aSize, aPosition, element.mBounds[i] ) ) return false;
+		}
+		if ( !readByte( aData, aSize, aPosition, element.mFlags ) || !readByte( aData, aSize, aPosition, numValues ) ) return false;
+		element.mValues.resize( numValues );
+		for ( int channel = 0; channel < numValues; channel++ ) {
+			uint64_t bits;
+			if ( !readVarint( aData, aSize, aPosition, bits ) ) return false;
+			element.mValues[channel] = bitsFloat( (uint32_t)bits );
+		}
+		if ( !readVarint( aData, aSize, aPosition, capacity ) || capacity > MAX_MESSAGE_SIZE || !readVarint( aData, aSize, aPosition, element.mSampleCount ) ) return false;
+		element.mSampleCapacity = (uint32_t)capacity;
+		if ( !readVarint( aData, aSize, aPosition, sent ) || !readSamples( aData, aSize, aPosition, sent, element.mSampleCapacity, element.mSamples ) ) return false;
+	}
+
+	mSeen.assign( count, false );
+	mChanged.clear();
+	for ( uint32_t id = 0; id < count; id++ ) changed( id );
+	mNumSnapshots++;
+	return true;
+}
+
+bool ReplicaClient::readDelta( const uint8_t *aData, const size_t &aSize, size_t &aPosition )
+{
+	// deltas only ever follow a snapshot
+	if ( !mNumSnapshots ) return false;
+
+	uint64_t count;
+	if ( !readVarint( aData, aSize, aPosition, count ) ) return false;
+	uint64_t id = 0;
+	for ( uint64_t i = 0; i < count; i++ ) {
+		uint64_t gap;
+		uint8_t mask;
+		if ( !readVarint( aData, aSize, aPosition, gap ) ) return false;
+		id += gap;
+		if ( id >= mElements.size() || !readByte( aData, aSize, aPosition, mask ) ) return false;
+
+		Element &element = mElements[id];
+		if ( mask & REPLICA_VALUES ) {
+			for ( size_t channel = 0; channel < element.mValues.size(); channel++ ) {
+				int32_t difference;
+				if ( !readZigzag( aData, aSize, aPosition, difference ) ) return false;
+				element.mValues[channel] = bitsFloat( floatBits( element.mValues[channel] ) + (uint32_t)difference );
+			}
+		}
+		if ( ( mask & REPLICA_FLAGS ) && !readByte( aData, aSize, aPosition, element.mFlags ) ) return false;
+		if ( mask & REPLICA_BOUNDS ) {
+			for ( int i = 0; i < 4; i++ ) {
+				if ( !readZigzag( aData, aSize, aPosition, element.mBounds[i] ) ) return false;
+			}
+		}
+		if ( mask & REPLICA_SAMPLES ) {
+			uint64_t added, sent;
+			if ( !readVarint( aData, aSize, aPosition, added ) || !readVarint( aData, aSize, aPosition, sent ) ) return false;
+			if ( !readSamples( aData, aSize, aPosition, sent, element.mSampleCapacity, element.mSamples ) ) return false;
+			element.mSampleCount += added;
+		}
+		changed( (uint32_t)id );
+		id++;
+	}
+	return true;
+}
+
+void ReplicaClient::changed( const uint32_t &aId )
+{
+	if ( mSeen[aId] ) return;
+	mSeen[aId] = true;
+	mChanged.push_back( aId );
+}
@@ -0,0 +1,110 @@
+#include "ReplicaPanel.h"
+#include "UIElement.h"
+#include "Button.h"
+#include "Graph.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+ReplicaPanel::ReplicaPanel( const ReplicaClientRef &aClient, WindowRef aWindow )
+	: mClient( aClient ), mWindow( aWindow ), mNumSnapshots( 0 )
+{
+}
+
+ReplicaPanelRef ReplicaPanel::create( const ReplicaClientRef &aClient, WindowRef aWindow )
+{
+	return shared_ptr<ReplicaPanel>( new ReplicaPanel( aClient, aWindow ) );
+}
+
+void ReplicaPanel::update()
+{
+	const vector<uint32_t> &changed = mClient->poll();
+	if ( mClient->getNumSnapshots() != mNumSnapshots ) {
+		rebuild();
+	} else {
+		const vector<ReplicaClient::Element> &elements = mClient->getElements();
+		for ( size_t i = 0; i < changed.size(); i++ ) {
+			// collapsing a section changes which elements there are
+			if ( ( ( elements[changed[i]].mFlags & REPLICA_HIDDEN ) != 0 ) != mHidden[changed[i]] ) {
+				rebuild();
+				break;
+			}
+			apply( changed[i] );
+		}
+	}
+	if ( !mController ) return;
+
+	mController->update();
+	// a graph plots its bound value when it updates; what it shows is replaced with the samples that were sent
+	const vector<ReplicaClient::Element> &elements = mClient->getElements();
+	for ( size_t id = 0; id < mElements.size(); id++ ) {
+		if ( mElements[id] && elements[id].mKind == REPLICA_GRAPH ) {
+			static_pointer_cast<MovingGraph>( mElements[id] )->setSamples( elements[id].mSamples );
+		}
+	}
+}
+
+void ReplicaPanel::draw()
+{
+	if ( mController ) mController->draw();
+}
+
+void ReplicaPanel::rebuild()
+{
+	mNumSnapshots = mClient->getNumSnapshots();
+
+	// the replica is updated on the main thread, by update()
+	Params panelParams( mClient->getPanelParams() );
+	panelParams.erase( "threaded" );
+	mController = UIController::create( panelParams.toJson(), mWindow );
+
+	const vector<ReplicaClient::Element> &elements = mClient->getElements();
+	mElements.assign( elements.size(), UIElementRef() );
+	mValues.assign( elements.size(), Vec2f::zero() );
+	mHidden.assign( elements.size(), false );
+	for ( size_t id = 0; id < elements.size(); id++ ) {
+		const ReplicaClient::Element &element = elements[id];
+		mHidden[id] = ( element.mFlags & REPLICA_HIDDEN ) != 0;
+		if ( mHidden[id] ) continue;
+
+		const Params params( element.mParams );
+		switch ( element.mKind ) {
+			case REPLICA_SLIDER:
+				mElements[id] = mController->addSlider( element.mName, &mValues[id].x, params );
+				break;
+			case REPLICA_SLIDER_2D:
+				mElements[id] = mController->addSlider2D( element.mName, &mValues[id], params );
+				break;
+			case REPLICA_BUTTON:
+				mElements[id] = mController->addButton( element.mName, []( bool ) { }, params );
+				break;
+			case REPLICA_GRAPH:
+				mElements[id] = mController->addMovingGraph( element.mName, &mValues[id].x, params );
+				break;
+			default:
+				mElements[id] = mController->addLabel( element.mName, params );
+				break;
+		}
+		apply( id );
+	}
+}
+
+void ReplicaPanel::apply( const uint32_t &aId )
+{
+	UIElementRef uiElement = mElements[aId];
+	if ( !uiElement ) return;
+
+	const ReplicaClient::Element &element = mClient->getElements()[aId];
+	if ( element.mValues.size() > 0 ) mValues[aId].x = element.mValues[0];
+	if ( element.mValues.size() > 1 ) mValues[aId].y = element.mValues[1];
+	uiElement->setLocked( ( element.mFlags & REPLICA_LOCKED ) != 0 );
+
+	const bool pressed = ( element.mFlags & REPLICA_PRESSED ) != 0;
+	if ( element.mKind == REPLICA_BUTTON ) {
+		static_pointer_cast<Button>( uiElement )->setPressed( pressed );
+	} else if ( element.mKind == REPLICA_GRAPH ) {
+		static_pointer_cast<MovingGraph>( uiElement )->setPressed( pressed );
+	}
+}
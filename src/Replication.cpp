@@ -0,0 +1,253 @@
+#include "Replication.h"
+#include "UIController.h"
+#include "UIElement.h"
+#include "VarInt.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace MinimalUI;
+
+size_t ReplicationServer::MAX_BACKLOG = 1 << 20;
+
+namespace {
+	void writeString( vector<uint8_t> &aBuffer, const string &aString )
+	{
+		writeVarint( aBuffer, aString.size() );
+		aBuffer.insert( aBuffer.end(), aString.begin(), aString.end() );
+	}
+
+	// each sample as the difference of its bits from the previous one's, which stays small for a signal that moves slowly
+	void writeSamples( vector<uint8_t> &aBuffer, const vector<float> &aSamples, const size_t &aCount, uint32_t aPreviousBits )
+	{
+		for ( size_t i = aSamples.size() - aCount; i < aSamples.size(); i++ ) {
+			const uint32_t bits = floatBits( aSamples[i] );
+			writeVarint( aBuffer, zigzagEncode( (int32_t)( bits - aPreviousBits ) ) );
+			aPreviousBits = bits;
+		}
+	}
+
+	uint8_t getKind( UIElement *aElement )
+	{
+		if ( aElement->getSampleCapacity() > 0 ) return REPLICA_GRAPH;
+		if ( aElement->getNumValues() == 2 ) return REPLICA_SLIDER_2D;
+		if ( aElement->getNumValues() == 1 ) return aElement->hasContinuousValues() ? REPLICA_SLIDER : REPLICA_BUTTON;
+		return REPLICA_OTHER;
+	}
+}
+
+ReplicationServer::ReplicationServer( UIController *aUIController, const TcpSocketRef &aListener )
+	: mParent( aUIController ), mListener( aListener ), mFrame( 0 ), mBytesSent( 0 ), mNumMessages( 0 )
+{
+}
+
+ReplicationServerRef ReplicationServer::create( UIController *aUIController, const uint16_t &aPort, const string &aAddress )
+{
+	TcpSocketRef listener = TcpSocket::listen( aAddress, aPort );
+	if ( !listener ) return ReplicationServerRef();
+	return ReplicationServerRef( new ReplicationServer( aUIController, listener ) );
+}
+
+void ReplicationServer::capture( const int &aId, ElementState &aState )
+{
+	UIElement *element = mParent->getElement( aId ).get();
+
+	aState.mValueBits.resize( min( element->getNumValues(), 255 ) );
+	for ( size_t channel = 0; channel < aState.mValueBits.size(); channel++ ) {
+		aState.mValueBits[channel] = floatBits( element->getValue( channel ) );
+	}
+	aState.mFlags = ( element->isPressed() ? REPLICA_PRESSED : 0 ) | ( element->isLocked() ? REPLICA_LOCKED : 0 ) | ( element->isHidden() ? REPLICA_HIDDEN : 0 );
+	const ci::Area bounds = element->getBounds();
+	aState.mBounds[0] = bounds.x1;
+	aState.mBounds[1] = bounds.y1;
+	aState.mBounds[2] = bounds.x2;
+	aState.mBounds[3] = bounds.y2;
+	aState.mSampleCount = element->getSampleCount();
+}
+
+void ReplicationServer::publish()
+{
+	mFrame++;
+
+	for ( TcpSocketRef socket = mListener->accept(); socket; socket = mListener->accept() ) {
+		Viewer viewer;
+		viewer.mSocket = socket;
+		viewer.mNeedsSnapshot = true;
+		mViewers.push_back( viewer );
+	}
+	if ( mViewers.empty() ) return;
+
+	// elements added since the last frame are only described by a snapshot
+	if ( (int)mSent.size() != mParent->getNumElements() ) {
+		const int first = mSent.size();
+		mSent.resize( mParent->getNumElements() );
+		for ( int id = first; id < (int)mSent.size(); id++ ) {
+			capture( id, mSent[id] );
+			mParent->getElement( id )->getSamples( mSamples );
+			mSent[id].mLastSampleBits = mSamples.empty() ? 0 : floatBits( mSamples.back() );
+		}
+		for ( size_t i = 0; i < mViewers.size(); i++ ) mViewers[i].mNeedsSnapshot = true;
+	}
+
+	// the delta brings mSent up to date, so a snapshot taken after it describes the same state
+	const bool changed = writeDelta( mDelta );
+	bool snapshotWritten = false;
+
+	for ( size_t i = 0; i < mViewers.size(); ) {
+		Viewer &viewer = mViewers[i];
+
+		// what didn't go out last frame goes first
+		if ( !viewer.mPending.empty() ) {
+			const int sent = viewer.mSocket->send( viewer.mPending.data(), viewer.mPending.size() );
+			if ( sent < 0 ) {
+				mViewers.erase( mViewers.begin() + i );
+				continue;
+			}
+			mBytesSent += sent;
+			viewer.mPending.erase( viewer.mPending.begin(), viewer.mPending.begin() + sent );
+		}
+
+		if ( viewer.mNeedsSnapshot ) {
+			// a snapshot has to start on a message boundary, so it waits for the backlog to drain
+			if ( viewer.mPending.empty() ) {
+				if ( !snapshotWritten ) {
+					writeSnapshot( mSnapshot );
+					snapshotWritten = true;
+				}
+				send( viewer, mSnapshot );
+				viewer.mNeedsSnapshot = false;
+			}
+		} else if ( changed ) {
+			// a viewer this far behind skips deltas until it can be sent a snapshot
+			if ( viewer.mPending.size() > MAX_BACKLOG ) {
+				viewer.mNeedsSnapshot = true;
+			} else {
+				send( viewer, mDelta );
+			}
+		}
+
+		if ( !viewer.mSocket ) {
+			mViewers.erase( mViewers.begin() + i );
+			continue;
+		}
+		i++;
+	}
+}
+
+void ReplicationServer::beginMessage( vector<uint8_t> &aMessage, const uint8_t &aType )
+{
+	aMessage.assign( 4, 0 );
+	aMessage.push_back( aType );
+	writeVarint( aMessage, mFrame );
+}
+
+void ReplicationServer::endMessage( vector<uint8_t> &aMessage )
+{
+	const uint32_t length = aMessage.size() - 4;
+	for ( int i = 0; i < 4; i++ ) aMessage[i] = (uint8_t)( length >> ( i * 8 ) );
+}
+
+void ReplicationServer::writeSnapshot( vector<uint8_t> &aMessage )
+{
+	beginMessage( aMessage, REPLICA_SNAPSHOT );
+	for ( int i = 0; i < 4; i++ ) aMessage.push_back( (uint8_t)( REPLICATION_MAGIC >> ( i * 8 ) ) );
+	writeVarint( aMessage, REPLICATION_VERSION );
+	writeString( aMessage, mParent->getParamString() );
+
+	writeVarint( aMessage, mSent.size() );
+	for ( int id = 0; id < (int)mSent.size(); id++ ) {
+		UIElement *element = mParent->getElement( id ).get();
+		const ElementState &state = mSent[id];
+		writeString( aMessage, element->getName() );
+		writeString( aMessage, element->getParams().toJson() );
+		aMessage.push_back( getKind( element ) );
+		for ( int i = 0; i < 4; i++ ) writeVarint( aMessage, zigzagEncode( state.mBounds[i] ) );
+		aMessage.push_back( state.mFlags );
+		aMessage.push_back( (uint8_t)state.mValueBits.size() );
+		for ( size_t channel = 0; channel < state.mValueBits.size(); channel++ ) writeVarint( aMessage, state.mValueBits[channel] );
+
+		element->getSamples( mSamples );
+		const size_t count = min<size_t>( mSamples.size(), element->getSampleCapacity() );
+		writeVarint( aMessage, element->getSampleCapacity() );
+		writeVarint( aMessage, state.mSampleCount );
+		writeVarint( aMessage, count );
+		writeSamples( aMessage, mSamples, count, 0 );
+	}
+	endMessage( aMessage );
+	mNumMessages++;
+}
+
+bool ReplicationServer::writeDelta( vector<uint8_t> &aMessage )
+{
+	beginMessage( aMessage, REPLICA_DELTA );
+	// the count isn't known until every element has been compared, so the changes go after a placeholder and the
+	// count is put in front of them at the end
+	const size_t countPosition = aMessage.size();
+	uint32_t count = 0;
+	int previous = -1;
+
+	for ( int id = 0; id < (int)mSent.size(); id++ ) {
+		ElementState &sent = mSent[id];
+		capture( id, mCurrent );
+
+		uint8_t mask = 0;
+		if ( mCurrent.mValueBits != sent.mValueBits ) mask |= REPLICA_VALUES;
+		if ( mCurrent.mFlags != sent.mFlags ) mask |= REPLICA_FLAGS;
+		if ( !equal( mCurrent.mBounds, mCurrent.mBounds + 4, sent.mBounds ) ) mask |= REPLICA_BOUNDS;
+		if ( mCurrent.mSampleCount != sent.mSampleCount ) mask |= REPLICA_SAMPLES;
+		if ( !mask ) continue;
+
+		writeVarint( aMessage, id - ( previous + 1 ) );
+		previous = id;
+		count++;
+		aMessage.push_back( mask );
+		if ( mask & REPLICA_VALUES ) {
+			for ( size_t channel = 0; channel < mCurrent.mValueBits.size(); channel++ ) {
+				writeVarint( aMessage, zigzagEncode( (int32_t)( mCurrent.mValueBits[channel] - sent.mValueBits[channel] ) ) );
+			}
+			sent.mValueBits = mCurrent.mValueBits;
+		}
+		if ( mask & REPLICA_FLAGS ) {
+			aMessage.push_back( mCurrent.mFlags );
+			sent.mFlags = mCurrent.mFlags;
+		}
+		if ( mask & REPLICA_BOUNDS ) {
+			for ( int i = 0; i < 4; i++ ) writeVarint( aMessage, zigzagEncode( mCurrent.mBounds[i] ) );
+			copy( mCurrent.mBounds, mCurrent.mBounds + 4, sent.mBounds );
+		}
+		if ( mask & REPLICA_SAMPLES ) {
+			// a graph that plotted more than it keeps since the last frame only sends what it kept
+			mParent->getElement( id )->getSamples( mSamples );
+			const uint64_t added = mCurrent.mSampleCount - sent.mSampleCount;
+			const size_t numSent = (size_t)min<uint64_t>( added, mSamples.size() );
+			writeVarint( aMessage, added );
+			writeVarint( aMessage, numSent );
+			writeSamples( aMessage, mSamples, numSent, sent.mLastSampleBits );
+			sent.mSampleCount = mCurrent.mSampleCount;
+			if ( !mSamples.empty() ) sent.mLastSampleBits = floatBits( mSamples.back() );
+		}
+	}
+	if ( !count ) return false;
+
+	vector<uint8_t> countBytes;
+	writeVarint( countBytes, count );
+	aMessage.insert( aMessage.begin() + countPosition, countBytes.begin(), countBytes.end() );
+	endMessage( aMessage );
+	mNumMessages++;
+	return true;
+}
+
+void ReplicationServer::send( Viewer &aViewer, const vector<uint8_t> &aMessage )
+{
+	size_t sent = 0;
+	if ( aViewer.mPending.empty() ) {
+		const int result = aViewer.mSocket->send( aMessage.data(), aMessage.size() );
+		if ( result < 0 ) {
+			aViewer.mSocket.reset();
+			return;
+		}
+		sent = result;
+		mBytesSent += sent;
+	}
+	aViewer.mPending.insert( aViewer.mPending.end(), aMessage.begin() + sent, aMessage.end() );
+}
@@ -0,0 +1,58 @@
+#include "Section.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+int Section::DEFAULT_WIDTH = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+int Section::DEFAULT_HEIGHT = UIElement::DEFAULT_HEIGHT * 2 / 3;
+
+Section::Section( UIController *aUIController, const string &aName, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
+{
+	// initialize unique variables
+	mCollapsed = hasParam( "collapsed" ) ? getParam<bool>( "collapsed" ) : false;
+
+	// set size and render name texture
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : Section::DEFAULT_WIDTH;
+	int y = hasParam( "height" ) ? getParam<int>( "height" ) : Section::DEFAULT_HEIGHT;
+	setSize( Vec2i( x, y ) );
+	renderNameTexture();
+
+	// set position and bounds
+	setPositionAndBounds();
+}
+
+UIElementRef Section::create( UIController *aUIController, const string &aName, const Params &aParams )
+{
+	return shared_ptr<Section>( new Section( aUIController, aName, aParams ) );
+}
+
+void Section::draw()
+{
+	// draw the expand / collapse indicator: a horizontal bar, plus a vertical one while collapsed
+	Vec2f center = Vec2f( getBounds().getX2() - getBounds().getHeight() / 2, getBounds().getY1() + getBounds().getHeight() / 2 );
+	float halfSize = getBounds().getHeight() / 5.0f;
+	gl::color( getNameColor() );
+	gl::drawLine( center - Vec2f( halfSize, 0.0f ), center + Vec2f( halfSize, 0.0f ) );
+	if ( mCollapsed ) {
+		gl::drawLine( center - Vec2f( 0.0f, halfSize ), center + Vec2f( 0.0f, halfSize ) );
+	}
+
+	// draw the label
+	drawLabel();
+}
+
+void Section::handleMouseUp( const Vec2i &aMousePos )
+{
+	toggle();
+}
+
+void Section::setCollapsed( const bool &aCollapsed )
+{
+	if ( aCollapsed != mCollapsed ) {
+		mCollapsed = aCollapsed;
+		getParent()->sectionToggled( this );
+	}
+}
@@ -0,0 +1,85 @@
+#include "SharedMemory.h"
+
+#if defined( _WIN32 )
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace MinimalUI;
+
+SharedMemory::SharedMemory( const string &aName, const bool &aOwner )
+	: mName( aName ), mOwner( aOwner ), mData( nullptr ), mSize( 0 )
+{
+#if defined( _WIN32 )
+	mHandle = nullptr;
+#else
+	mFd = -1;
+	// POSIX names must start with a slash
+	if ( mName.empty() || mName[0] != '/' ) mName = "/" + mName;
+#endif
+}
+
+SharedMemory::~SharedMemory()
+{
+#if defined( _WIN32 )
+	if ( mData ) UnmapViewOfFile( mData );
+	if ( mHandle ) CloseHandle( mHandle );
+#else
+	if ( mData ) munmap( mData, mSize );
+	if ( mFd >= 0 ) close( mFd );
+	if ( mOwner ) shm_unlink( mName.c_str() );
+#endif
+}
+
+SharedMemoryRef SharedMemory::create( const string &aName, const size_t &aSize )
+{
+	SharedMemoryRef memory( new SharedMemory( aName, true ) );
+	return memory->map( aSize, true ) ? memory : SharedMemoryRef();
+}
+
+SharedMemoryRef SharedMemory::open( const string &aName )
+{
+	SharedMemoryRef memory( new SharedMemory( aName, false ) );
+	return memory->map( 0, false ) ? memory : SharedMemoryRef();
+}
+
+bool SharedMemory::map( const size_t &aSize, const bool &aCreate )
+{
+#if defined( _WIN32 )
+	if ( aCreate ) {
+		mHandle = CreateFileMappingA( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)( (uint64_t)aSize >> 32 ), (DWORD)aSize, mName.c_str() );
+	} else {
+		mHandle = OpenFileMappingA( FILE_MAP_ALL_ACCESS, FALSE, mName.c_str() );
+	}
+	if ( !mHandle ) return false;
+
+	mData = MapViewOfFile( mHandle, FILE_MAP_ALL_ACCESS, 0, 0, aSize );
+	if ( !mData ) return false;
+
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery( mData, &info, sizeof( info ) );
+	mSize = aCreate ? aSize : info.RegionSize;
+#else
+	if ( aCreate ) {
+		shm_unlink( mName.c_str() );
+		mFd = shm_open( mName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+		if ( mFd < 0 || ftruncate( mFd, aSize ) != 0 ) return false;
+		mSize = aSize;
+	} else {
+		mFd = shm_open( mName.c_str(), O_RDWR, 0600 );
+		struct stat info;
+		if ( mFd < 0 || fstat( mFd, &info ) != 0 ) return false;
+		mSize = (size_t)info.st_size;
+	}
+
+	void *data = mmap( nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0 );
+	if ( data == MAP_FAILED ) return false;
+	mData = data;
+#endif
+	return true;
+}
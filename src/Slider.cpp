@@ -8,37 +8,39 @@ using namespace MinimalUI;
 int Slider::DEFAULT_HEIGHT = UIElement::DEFAULT_HEIGHT;
 int Slider::DEFAULT_WIDTH = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
 int Slider::DEFAULT_HANDLE_HALFWIDTH = 8;
+// a slider animated by the app or automation is drawn on every refresh, rather than baked into the layer each time
+int Slider::DEFAULT_SETTLE_UPDATES = 30;
 
 int Slider2D::DEFAULT_HEIGHT = 96;
 int Slider2D::DEFAULT_WIDTH = 96;
 int Slider2D::DEFAULT_HANDLE_HALFWIDTH = 4;
+int Slider2D::DEFAULT_SETTLE_UPDATES = 30;
 
-Slider::Slider( UIController *aUIController, const string &aName, float *aValueToLink, const string &aParamString )
-	: UIElement( aUIController, aName, aParamString )
+Slider::Slider( UIController *aUIController, const string &aName, float *aValueToLink, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
 {
 	// initialize unique variables
 	mLinkedValue = aValueToLink;
 	mDefaultValue = *aValueToLink;
 	mMin = hasParam( "min" ) ? getParam<float>( "min" ) : 0.0f;
 	mMax = hasParam( "max" ) ? getParam<float>( "max" ) : 1.0f;
+	mSmoothingIndex = -1;
+	mLastValue = *aValueToLink;
+	mUnsettledUpdates = 0;
+	mStatic = hasParam( "cached" ) ? getParam<bool>( "cached" ) : true;
 
 	// set colors
-	std::stringstream str;
-	string strValue;
-	uint32_t hexValue;
-	strValue = hasParam( "foregroundColor" ) ? getParam<string>( "foregroundColor" ) : "0xFF12424A"; // should be same as DEFAULT_STROKE_COLOR
-	str << strValue;
-	str >> std::hex >> hexValue;
-	setForegroundColor( ColorA::hexA( hexValue ) );
-
-	strValue = hasParam( "backgroundColor" ) ? getParam<string>( "backgroundColor" ) : "0xFF000000"; // should be same as DEFAULT_BACKGROUND_COLOR
-	str.clear();
-	str << strValue;
-	str >> std::hex >> hexValue;
-	setBackgroundColor( ColorA::hexA( hexValue ) );
+	setForegroundColor( getColorParam( "foregroundColor", ColorA::hexA( 0xFF12424A ) ) ); // should be same as DEFAULT_STROKE_COLOR
+	setBackgroundColor( getColorParam( "backgroundColor", ColorA::hexA( 0xFF000000 ) ) ); // should be same as DEFAULT_BACKGROUND_COLOR
 
 	mHandleVisible  = hasParam( "handleVisible" ) ? getParam<bool>( "handleVisible" ) : true; 
 	mVertical  = hasParam( "vertical" ) ? getParam<bool>( "vertical" ) : false; 
+
+	// optional readout of the value, refreshed only when its digits change
+	if ( hasParam( "readout" ) && getParam<bool>( "readout" ) ) {
+		mReadoutAtlas = aUIController->getGlyphAtlas( "smallLabel" );
+		mReadout.setup( hasParam( "precision" ) ? getParam<int>( "precision" ) : 2, hasParam( "units" ) ? getParam<string>( "units" ) : "" );
+	}
 	// set size and render name texture
 	int x = hasParam( "width" ) ? getParam<int>( "width" ) : Slider::DEFAULT_WIDTH;
 	int y = Slider::DEFAULT_HEIGHT;
@@ -48,6 +50,12 @@ Slider::Slider( UIController *aUIController, const string &aName, float *aValueT
 	// set position and bounds
 	setPositionAndBounds();
 
+	// set screen min, max and value
+	boundsChanged();
+}
+
+void Slider::boundsChanged()
+{
 	// set screen min and max
 	if ( mVertical )
 	{
@@ -64,24 +72,13 @@ Slider::Slider( UIController *aUIController, const string &aName, float *aValueT
 	update();
 }
 
-UIElementRef Slider::create( UIController *aUIController, const string &aName, float *aValueToLink, const string &aParamString )
+UIElementRef Slider::create( UIController *aUIController, const string &aName, float *aValueToLink, const Params &aParams )
 {
-	return shared_ptr<Slider>( new Slider( aUIController, aName, aValueToLink, aParamString ) );
+	return shared_ptr<Slider>( new Slider( aUIController, aName, aValueToLink, aParams ) );
 }
 
 void Slider::draw()
 {
-	// draw the solid rect
-	if ( isLocked() ) {
-		gl::color( UIController::DEFAULT_STROKE_COLOR );
-	} else {
-		gl::color( getBackgroundColor() );
-	}
-	gl::drawSolidRect( getBounds() );
-
-	// draw the background
-	drawBackground();
-
 	// draw the outer rect
 	if ( isActive() ) {
 		gl::color( UIController::ACTIVE_STROKE_COLOR );
@@ -114,12 +111,32 @@ void Slider::draw()
 		gl::drawStrokedRect( Rectf( handleStart, handleEnd ) );
 		gl::drawSolidRect( Rectf( handleStart, handleEnd ) );
 	}
+
+	// queue the readout, right-aligned and vertically centered
+	if ( mReadoutAtlas ) {
+		const float scale = 1.0f;
+		const Rectf bounds = getBounds();
+		const float x = bounds.getX2() - toPixels( (float)UIController::DEFAULT_MARGIN_SMALL ) - mReadoutAtlas->measure( mReadout.getText(), scale );
+		const float y = bounds.getY1() + ( bounds.getHeight() - mReadoutAtlas->getLineHeight( scale ) ) / 2;
+		mReadoutAtlas->add( mReadout.getText(), Vec2f( x, y ), scale, getNameColor() );
+	}
+
 	// draw the label
 	drawLabel();
 }
 
 void Slider::update()
 {
+	// the app may write the linked value itself, rather than through the slider
+	if ( *mLinkedValue != mLastValue ) {
+		mLastValue = *mLinkedValue;
+		if ( mSmoothingIndex >= 0 ) mSmoothingEngine->setTarget( mSmoothingIndex, mLastValue );
+		// drawn over the cached layer until the value has settled
+		mUnsettledUpdates = DEFAULT_SETTLE_UPDATES;
+	} else if ( mUnsettledUpdates > 0 ) {
+		mUnsettledUpdates--;
+	}
+
 	if ( mVertical )
 	{
 		mValue = lmap<float>(*mLinkedValue, mMin, mMax, mScreenMin, mScreenMax );
@@ -128,13 +145,16 @@ void Slider::update()
 	{
 		mValue = lmap<float>(*mLinkedValue, mMin, mMax, mScreenMin, mScreenMax );
 	}
+
+	if ( mReadoutAtlas ) mReadout.update( mLinkedValue, 1 );
 }
 
 void Slider::handleMouseDown( const Vec2i &aMousePos, const bool isRight )
 {
 	if ( isRight )
 	{
-		*mLinkedValue = mDefaultValue;		
+		*mLinkedValue = mDefaultValue;
+		publishValue();
 	}
 	else 
 	{
@@ -161,6 +181,12 @@ void Slider::handleMouseDrag( const Vec2i &aMousePos )
 	}
 }
 
+void Slider::handleExternalValue( const int &aChannel, const float &aValue )
+{
+	*mLinkedValue = lerp<float>( mMin, mMax, math<float>::clamp( aValue, 0.0f, 1.0f ) );
+	publishValue();
+}
+
 void Slider::updatePosition( const int &aPos )
 {
 	mValue = aPos;
@@ -171,16 +197,32 @@ void Slider::updatePosition( const int &aPos )
 	else
 	{
 		*mLinkedValue = lmap<float>(mValue, mScreenMin, mScreenMax, mMin, mMax );
-	}		
+	}
+	publishValue();
+}
+
+void Slider::setSmoothing( const SmoothingEngineRef &aEngine, const SmoothingEngine::Ramp &aRamp, const double &aTime )
+{
+	mSmoothingEngine = aEngine;
+	mSmoothingIndex = aEngine ? aEngine->addParameter( *mLinkedValue, aRamp, aTime ) : -1;
+}
+
+void Slider::publishValue()
+{
+	notifyValueChanged( 0, *mLinkedValue );
+	if ( mSmoothingIndex >= 0 ) mSmoothingEngine->setTarget( mSmoothingIndex, *mLinkedValue );
 }
 
 // Slider2D
-Slider2D::Slider2D( UIController *aUIController, const string &aName, Vec2f *aValueToLink, const string &aParamString )
-	: UIElement( aUIController, aName, aParamString )
+Slider2D::Slider2D( UIController *aUIController, const string &aName, Vec2f *aValueToLink, const Params &aParams )
+	: UIElement( aUIController, aName, aParams )
 {
 	// initialize unique variables
 	mLinkedValue = aValueToLink;
 	mDefaultValue = Vec2f( (*mLinkedValue).x, (*mLinkedValue).y );
+	mLastValue = mDefaultValue;
+	mUnsettledUpdates = 0;
+	mStatic = hasParam( "cached" ) ? getParam<bool>( "cached" ) : true;
 	float minX = hasParam( "minX" ) ? getParam<float>( "minX" ) : 0.0f;
 	float maxX = hasParam( "maxX" ) ? getParam<float>( "maxX" ) : 1.0f;
 	float minY = hasParam( "minY" ) ? getParam<float>( "minY" ) : 0.0f;
@@ -188,6 +230,12 @@ Slider2D::Slider2D( UIController *aUIController, const string &aName, Vec2f *aVa
 	mMin = Vec2f( minX, minY );
 	mMax = Vec2f( maxX, maxY );
 
+	// optional readout of the value, refreshed only when its digits change
+	if ( hasParam( "readout" ) && getParam<bool>( "readout" ) ) {
+		mReadoutAtlas = aUIController->getGlyphAtlas( "smallLabel" );
+		mReadout.setup( hasParam( "precision" ) ? getParam<int>( "precision" ) : 2, hasParam( "units" ) ? getParam<string>( "units" ) : "" );
+	}
+
 	// set size and render name texture
 	int x = hasParam( "width" ) ? getParam<int>( "width" ) : Slider2D::DEFAULT_WIDTH;
 	int y = Slider2D::DEFAULT_HEIGHT;
@@ -197,6 +245,12 @@ Slider2D::Slider2D( UIController *aUIController, const string &aName, Vec2f *aVa
 	// set position and bounds
 	setPositionAndBounds();
 
+	// set screen min, max and value
+	boundsChanged();
+}
+
+void Slider2D::boundsChanged()
+{
 	// set screen min and max
 	Vec2i offset = Vec2i( Slider2D::DEFAULT_HANDLE_HALFWIDTH, Slider2D::DEFAULT_HANDLE_HALFWIDTH );
 	mScreenMin = mPosition + offset;
@@ -206,9 +260,9 @@ Slider2D::Slider2D( UIController *aUIController, const string &aName, Vec2f *aVa
 	update();
 }
 
-UIElementRef Slider2D::create( UIController *aUIController, const string &aName, Vec2f *aValueToLink, const string &aParamString )
+UIElementRef Slider2D::create( UIController *aUIController, const string &aName, Vec2f *aValueToLink, const Params &aParams )
 {
-	return shared_ptr<Slider2D>( new Slider2D( aUIController, aName, aValueToLink, aParamString ) );
+	return shared_ptr<Slider2D>( new Slider2D( aUIController, aName, aValueToLink, aParams ) );
 }
 
 void Slider2D::draw()
@@ -216,9 +270,6 @@ void Slider2D::draw()
 	// draw the outer rect
 	gl::color( UIController::DEFAULT_STROKE_COLOR );
 	gl::drawStrokedRect( getBounds() );
-	gl::drawSolidRect( getBounds() );
-	// draw the background
-	drawBackground();
 
 	// draw the indicator lines
 	gl::color( UIController::ACTIVE_STROKE_COLOR );
@@ -231,13 +282,31 @@ void Slider2D::draw()
 	Vec2f handleEnd = toPixels( mValue + offset );
 	gl::drawStrokedRect( Rectf( handleStart, handleEnd ) );
 	gl::drawSolidRect( Rectf( handleStart, handleEnd ) );
+
+	// queue the readout in the lower left corner
+	if ( mReadoutAtlas ) {
+		const float scale = 1.0f;
+		const float margin = toPixels( (float)UIController::DEFAULT_MARGIN_SMALL );
+		const Vec2f position( getBounds().getX1() + margin, getBounds().getY2() - margin - mReadoutAtlas->getLineHeight( scale ) );
+		mReadoutAtlas->add( mReadout.getText(), position, scale, getNameColor() );
+	}
 }
 
 void Slider2D::update()
 {
+	if ( *mLinkedValue != mLastValue ) {
+		mLastValue = *mLinkedValue;
+		// drawn over the cached layer until the value has settled
+		mUnsettledUpdates = DEFAULT_SETTLE_UPDATES;
+	} else if ( mUnsettledUpdates > 0 ) {
+		mUnsettledUpdates--;
+	}
+
 	Vec2i offset = Vec2i( Slider2D::DEFAULT_HANDLE_HALFWIDTH, Slider2D::DEFAULT_HANDLE_HALFWIDTH );
 	mValue.x = lmap<float>((*mLinkedValue).x, mMin.x, mMax.x, mPosition.x + offset.x, mBounds.getX2() - offset.x );
 	mValue.y = lmap<float>((*mLinkedValue).y, mMin.y, mMax.y, mBounds.getY2() - offset.y, mPosition.y + offset.y );
+
+	if ( mReadoutAtlas ) mReadout.update( &mLinkedValue->x, 2 );
 }
 
 void Slider2D::handleMouseDown( const Vec2i &aMousePos, const bool isRight )
@@ -245,7 +314,9 @@ void Slider2D::handleMouseDown( const Vec2i &aMousePos, const bool isRight )
 	if ( isRight )
 	{
 		(*mLinkedValue).x = mDefaultValue.x;
-		(*mLinkedValue).y = mDefaultValue.y;		
+		(*mLinkedValue).y = mDefaultValue.y;
+		notifyValueChanged( 0, (*mLinkedValue).x );
+		notifyValueChanged( 1, (*mLinkedValue).y );
 	}
 	else updatePosition( aMousePos );
 }
@@ -258,24 +329,34 @@ void Slider2D::handleMouseDrag( const Vec2i &aMousePos )
 	updatePosition( newPos );
 }
 
+void Slider2D::handleExternalValue( const int &aChannel, const float &aValue )
+{
+	const float t = math<float>::clamp( aValue, 0.0f, 1.0f );
+	if ( aChannel == 0 ) (*mLinkedValue).x = lerp<float>( mMin.x, mMax.x, t );
+	else (*mLinkedValue).y = lerp<float>( mMin.y, mMax.y, t );
+	notifyValueChanged( aChannel, getValue( aChannel ) );
+}
+
 void Slider2D::updatePosition( const Vec2i &aPos )
 {
 	mValue = aPos;
 	(*mLinkedValue).x = lmap<float>(mValue.x, mScreenMin.x, mScreenMax.x, mMin.x, mMax.x );
 	(*mLinkedValue).y = lmap<float>(mValue.y, mScreenMin.y, mScreenMax.y, mMax.y, mMin.y );
+	notifyValueChanged( 0, (*mLinkedValue).x );
+	notifyValueChanged( 1, (*mLinkedValue).y );
 }
 
 // SliderCallback
-SliderCallback::SliderCallback( UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const string &aParamString )
-: Slider( aUIController, aName, aValueToLink, aParamString )
+SliderCallback::SliderCallback( UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const Params &aParams )
+: Slider( aUIController, aName, aValueToLink, aParams )
 {
 	// initialize unique variables
 	addEventHandler( aEventHandler );
 }
 
-UIElementRef SliderCallback::create( UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const string &aParamString )
+UIElementRef SliderCallback::create( UIController *aUIController, const string &aName, float *aValueToLink, const std::function<void()>& aEventHandler, const Params &aParams )
 {
-	return shared_ptr<SliderCallback>( new SliderCallback( aUIController, aName, aValueToLink, aEventHandler, aParamString ) );
+	return shared_ptr<SliderCallback>( new SliderCallback( aUIController, aName, aValueToLink, aEventHandler, aParams ) );
 }
 
 void SliderCallback::addEventHandler( const std::function<void()>& aEventHandler )
@@ -297,6 +378,7 @@ void SliderCallback::handleMouseDown( const Vec2i &aMousePos, const bool isRight
 	if ( isRight )
 	{
 		*mLinkedValue = mDefaultValue;
+		publishValue();
 	}
 	else
 	{
@@ -310,3 +392,15 @@ void SliderCallback::handleMouseDown( const Vec2i &aMousePos, const bool isRight
 		}
 	}
 }
+
+void SliderCallback::handleExternalValue( const int &aChannel, const float &aValue )
+{
+	Slider::handleExternalValue( aChannel, aValue );
+	callEventHandlers();
+}
+
+void SliderCallback::setValue( const int &aChannel, const float &aValue )
+{
+	Slider::setValue( aChannel, aValue );
+	callEventHandlers();
+}
@@ -0,0 +1,152 @@
+#include "SmoothingEngine.h"
+#include "Simd.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace MinimalUI;
+
+int SmoothingEngine::DEFAULT_MAX_PARAMETERS = 1024;
+int SmoothingEngine::DEFAULT_MAX_BLOCK_SIZE = 512;
+double SmoothingEngine::DEFAULT_RAMP_TIME = 0.02;
+
+// how close to its target a ramp gets before it's snapped there, relative to the target; keeps one pole ramps toward
+// 0 from decaying into denormals
+static const float SNAP_TOLERANCE = 1.0e-6f;
+
+SmoothingEngine::SmoothingEngine( const double &aSampleRate, const int &aMaxParameters, const int &aMaxBlockSize )
+	: mSampleRate( aSampleRate ), mMaxParameters( aMaxParameters ), mMaxBlockSize( ( aMaxBlockSize + 3 ) & ~3 ),
+	mNumParameters( 0 ), mNumActive( 0 ), mTargets( aMaxParameters ), mRamps( aMaxParameters ), mRampSamples( aMaxParameters )
+{
+	// padding lanes hold still at 0
+	const size_t padded = ( aMaxParameters + 3 ) & ~3;
+	mCurrent.assign( padded, 0.0f );
+	mA.assign( padded, 1.0f );
+	mB.assign( padded, 0.0f );
+	mTarget.assign( padded, 0.0f );
+	mDirection.assign( padded, 0.0f );
+	mSnap.assign( padded, 0.0f );
+	mOutput.assign( padded * mMaxBlockSize, 0.0f );
+	mResting.assign( padded / 4, false );
+}
+
+SmoothingEngineRef SmoothingEngine::create( const double &aSampleRate, const int &aMaxParameters, const int &aMaxBlockSize )
+{
+	return shared_ptr<SmoothingEngine>( new SmoothingEngine( aSampleRate, aMaxParameters, aMaxBlockSize ) );
+}
+
+int SmoothingEngine::addParameter( const float &aValue, const Ramp &aRamp, const double &aTime )
+{
+	const int index = mNumParameters.load( memory_order_relaxed );
+	if ( index >= mMaxParameters ) return -1;
+
+	mTargets[index].store( aValue, memory_order_relaxed );
+	mRamps[index] = aRamp;
+	mRampSamples[index] = (float)max( aTime * mSampleRate, 1.0 );
+	mNumParameters.store( index + 1, memory_order_release );
+	return index;
+}
+
+void SmoothingEngine::retarget( const int &aIndex, const float &aTarget )
+{
+	const float current = mCurrent[aIndex];
+	const float samples = mRampSamples[aIndex];
+	Ramp ramp = mRamps[aIndex];
+	if ( ramp == EXPONENTIAL && !( current * aTarget > 0.0f ) ) ramp = LINEAR;
+
+	switch ( ramp ) {
+		case LINEAR:
+			mA[aIndex] = 1.0f;
+			mB[aIndex] = mDirection[aIndex] = ( aTarget - current ) / samples;
+			break;
+		case ONE_POLE:
+			mA[aIndex] = expf( -1.0f / samples );
+			mB[aIndex] = ( 1.0f - mA[aIndex] ) * aTarget;
+			mDirection[aIndex] = 0.0f;
+			break;
+		case EXPONENTIAL:
+			mA[aIndex] = powf( aTarget / current, 1.0f / samples );
+			mB[aIndex] = 0.0f;
+			mDirection[aIndex] = aTarget - current;
+			break;
+	}
+	mTarget[aIndex] = aTarget;
+	mSnap[aIndex] = SNAP_TOLERANCE * max( fabsf( aTarget ), 1.0f );
+}
+
+void SmoothingEngine::process( const int &aNumSamples )
+{
+	const int numSamples = min( aNumSamples, mMaxBlockSize );
+	const int numParameters = mNumParameters.load( memory_order_acquire );
+
+	// parameters added since the last block start where they are
+	for ( ; mNumActive < numParameters; mNumActive++ ) {
+		mCurrent[mNumActive] = mTarget[mNumActive] = mTargets[mNumActive].load( memory_order_relaxed );
+		mResting[mNumActive / 4] = false;
+	}
+	for ( int i = 0; i < numParameters; i++ ) {
+		const float target = mTargets[i].load( memory_order_relaxed );
+		if ( target != mTarget[i] ) retarget( i, target );
+	}
+
+	for ( int i = 0; i < numParameters; i += 4 ) {
+		// most parameters are at rest most of the time; their output is filled once, when they get there
+		if ( mCurrent[i] == mTarget[i] && mCurrent[i + 1] == mTarget[i + 1] && mCurrent[i + 2] == mTarget[i + 2] && mCurrent[i + 3] == mTarget[i + 3] ) {
+			if ( !mResting[i / 4] ) {
+				for ( int lane = 0; lane < 4; lane++ ) fill( mOutput.begin() + ( i + lane ) * mMaxBlockSize, mOutput.begin() + ( i + lane + 1 ) * mMaxBlockSize, mTarget[i + lane] );
+				mResting[i / 4] = true;
+			}
+			continue;
+		}
+		mResting[i / 4] = false;
+
+		float *out[4] = { &mOutput[i * mMaxBlockSize], &mOutput[( i + 1 ) * mMaxBlockSize], &mOutput[( i + 2 ) * mMaxBlockSize], &mOutput[( i + 3 ) * mMaxBlockSize] };
+#if defined( MINIMALUI_SSE2 )
+		// four parameters per vector, four samples at a time, transposed so each parameter's ramp is stored contiguously.
+		// The four samples are each computed from the last one of the previous step, with the recurrence unrolled
+		// (y + k = a^k y + b (1 + a + ... + a^(k-1))), so the dependency chain is one step per four samples. Ramps
+		// approach their targets monotonically, so stopping each sample independently gives the same result.
+		__m128 y = _mm_loadu_ps( &mCurrent[i] );
+		const __m128 target = _mm_loadu_ps( &mTarget[i] ), direction = _mm_loadu_ps( &mDirection[i] ), snap = _mm_loadu_ps( &mSnap[i] );
+		const __m128 zero = _mm_setzero_ps(), absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+		__m128 a[4], b[4];
+		a[0] = _mm_loadu_ps( &mA[i] );
+		b[0] = _mm_loadu_ps( &mB[i] );
+		for ( int k = 1; k < 4; k++ ) {
+			a[k] = _mm_mul_ps( a[k - 1], a[0] );
+			b[k] = _mm_add_ps( _mm_mul_ps( a[0], b[k - 1] ), b[0] );
+		}
+		__m128 samples[4];
+		for ( int n = 0; n < numSamples; n += 4 ) {
+			for ( int k = 0; k < 4; k++ ) {
+				const __m128 next = _mm_add_ps( _mm_mul_ps( a[k], y ), b[k] );
+				const __m128 remaining = _mm_sub_ps( target, next );
+				const __m128 done = _mm_or_ps( _mm_cmplt_ps( _mm_mul_ps( remaining, direction ), zero ), _mm_cmple_ps( _mm_and_ps( remaining, absMask ), snap ) );
+				samples[k] = _mm_or_ps( _mm_and_ps( done, target ), _mm_andnot_ps( done, next ) );
+			}
+			// a block that isn't a multiple of four stores a few values past its end, which the buffers have room for
+			y = samples[min( numSamples - n, 4 ) - 1];
+			_MM_TRANSPOSE4_PS( samples[0], samples[1], samples[2], samples[3] );
+			_mm_storeu_ps( out[0] + n, samples[0] );
+			_mm_storeu_ps( out[1] + n, samples[1] );
+			_mm_storeu_ps( out[2] + n, samples[2] );
+			_mm_storeu_ps( out[3] + n, samples[3] );
+		}
+		_mm_storeu_ps( &mCurrent[i], y );
+#else
+		for ( int lane = 0; lane < 4; lane++ ) {
+			const int index = i + lane;
+			const float a = mA[index], b = mB[index], target = mTarget[index], direction = mDirection[index], snap = mSnap[index];
+			float y = mCurrent[index];
+			for ( int n = 0; n < numSamples; n++ ) {
+				y = a * y + b;
+				const float remaining = target - y;
+				if ( remaining * direction < 0.0f || fabsf( remaining ) <= snap ) y = target;
+				out[lane][n] = y;
+			}
+			mCurrent[index] = y;
+		}
+#endif
+	}
+}
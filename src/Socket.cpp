@@ -0,0 +1,141 @@
+#include "Socket.h"
+
+#if defined( _WIN32 )
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	#pragma comment( lib, "ws2_32.lib" )
+	typedef int socklen_t;
+#else
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+
+#include <cstring>
+
+using namespace std;
+using namespace MinimalUI;
+
+namespace {
+#if defined( _WIN32 )
+	const intptr_t INVALID_HANDLE = (intptr_t)INVALID_SOCKET;
+
+	bool startup()
+	{
+		static bool started = false;
+		if ( !started ) {
+			WSADATA data;
+			started = WSAStartup( MAKEWORD( 2, 2 ), &data ) == 0;
+		}
+		return started;
+	}
+
+	bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+	void closeHandle( const intptr_t &aHandle ) { closesocket( (SOCKET)aHandle ); }
+	void setNonBlocking( const intptr_t &aHandle ) { u_long on = 1; ioctlsocket( (SOCKET)aHandle, FIONBIO, &on ); }
+#else
+	const intptr_t INVALID_HANDLE = -1;
+
+	bool startup() { return true; }
+	bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+	void closeHandle( const intptr_t &aHandle ) { close( (int)aHandle ); }
+	void setNonBlocking( const intptr_t &aHandle ) { fcntl( (int)aHandle, F_SETFL, fcntl( (int)aHandle, F_GETFL, 0 ) | O_NONBLOCK ); }
+#endif
+
+	bool makeAddress( const string &aAddress, const uint16_t &aPort, sockaddr_in &aResult )
+	{
+		memset( &aResult, 0, sizeof( aResult ) );
+		aResult.sin_family = AF_INET;
+		aResult.sin_port = htons( aPort );
+		return inet_pton( AF_INET, aAddress.c_str(), &aResult.sin_addr ) == 1;
+	}
+
+	void configure( const intptr_t &aHandle )
+	{
+		setNonBlocking( aHandle );
+		// one message per frame; don't let Nagle hold it back waiting for the next
+		int on = 1;
+		setsockopt( aHandle, IPPROTO_TCP, TCP_NODELAY, (const char *)&on, sizeof( on ) );
+#if defined( SO_NOSIGPIPE )
+		// a viewer going away shouldn't kill the panel's process
+		setsockopt( aHandle, SOL_SOCKET, SO_NOSIGPIPE, (const char *)&on, sizeof( on ) );
+#endif
+	}
+}
+
+TcpSocket::TcpSocket( const intptr_t &aHandle )
+	: mHandle( aHandle )
+{
+}
+
+TcpSocket::~TcpSocket()
+{
+	if ( mHandle != INVALID_HANDLE ) closeHandle( mHandle );
+}
+
+TcpSocketRef TcpSocket::listen( const string &aAddress, const uint16_t &aPort )
+{
+	sockaddr_in address;
+	if ( !startup() || !makeAddress( aAddress, aPort, address ) ) return TcpSocketRef();
+
+	TcpSocketRef result( new TcpSocket( (intptr_t)::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP ) ) );
+	if ( result->mHandle == INVALID_HANDLE ) return TcpSocketRef();
+
+	int on = 1;
+	setsockopt( result->mHandle, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof( on ) );
+	if ( ::bind( result->mHandle, (const sockaddr *)&address, sizeof( address ) ) != 0 || ::listen( result->mHandle, 8 ) != 0 ) return TcpSocketRef();
+	setNonBlocking( result->mHandle );
+	return result;
+}
+
+TcpSocketRef TcpSocket::connect( const string &aAddress, const uint16_t &aPort )
+{
+	sockaddr_in address;
+	if ( !startup() || !makeAddress( aAddress, aPort, address ) ) return TcpSocketRef();
+
+	TcpSocketRef result( new TcpSocket( (intptr_t)::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP ) ) );
+	if ( result->mHandle == INVALID_HANDLE || ::connect( result->mHandle, (const sockaddr *)&address, sizeof( address ) ) != 0 ) return TcpSocketRef();
+	configure( result->mHandle );
+	return result;
+}
+
+TcpSocketRef TcpSocket::accept()
+{
+	const intptr_t handle = (intptr_t)::accept( mHandle, nullptr, nullptr );
+	if ( handle == INVALID_HANDLE ) return TcpSocketRef();
+
+	configure( handle );
+	return TcpSocketRef( new TcpSocket( handle ) );
+}
+
+int TcpSocket::send( const uint8_t *aData, const size_t &aSize )
+{
+#if defined( MSG_NOSIGNAL )
+	const int flags = MSG_NOSIGNAL;
+#else
+	const int flags = 0;
+#endif
+	const int sent = (int)::send( mHandle, (const char *)aData, (int)aSize, flags );
+	if ( sent >= 0 ) return sent;
+	return wouldBlock() ? 0 : -1;
+}
+
+int TcpSocket::receive( uint8_t *aData, const size_t &aSize )
+{
+	const int received = (int)::recv( mHandle, (char *)aData, (int)aSize, 0 );
+	if ( received > 0 ) return received;
+	if ( received == 0 ) return -1;
+	return wouldBlock() ? 0 : -1;
+}
+
+uint16_t TcpSocket::getPort() const
+{
+	sockaddr_in address;
+	socklen_t length = sizeof( address );
+	if ( getsockname( mHandle, (sockaddr *)&address, &length ) != 0 ) return 0;
+	return ntohs( address.sin_port );
+}
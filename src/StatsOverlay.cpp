@@ -0,0 +1,140 @@
+#include "StatsOverlay.h"
+
+#include <cstring>
+
+#if defined( _WIN32 )
+	#include <windows.h>
+	#include <psapi.h>
+	#pragma comment( lib, "psapi.lib" )
+#elif defined( __APPLE__ )
+	#include <mach/mach.h>
+#else
+	#include <cstdio>
+	#include <unistd.h>
+#endif
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+int StatsOverlay::DEFAULT_WIDTH = UIController::DEFAULT_PANEL_WIDTH - UIController::DEFAULT_MARGIN_LARGE * 2;
+// samples between updates, which come every DEFAULT_UPDATE_FREQUENCY frames, or every step of a threaded panel
+size_t StatsOverlay::DEFAULT_QUEUE_SIZE = 256;
+
+StatsOverlay::StatsOverlay( UIController *aUIController, const string &aName, const Params &aParams )
+	: UIElement( aUIController, aName, aParams ), mSamples( DEFAULT_QUEUE_SIZE )
+{
+	// initialize unique variables
+	mWindow = hasParam( "window" ) ? getParam<double>( "window" ) : 10.0;
+	mRefresh = hasParam( "refresh" ) ? getParam<double>( "refresh" ) : 0.25;
+	mFrameTime = mUpdateTime = mDrawTime = 0.0f;
+	mWindowStart = mLastRefresh = getElapsedSeconds();
+	for ( int i = 0; i < NUM_LINES; i++ ) mLines[i][0] = 0;
+	mAtlas = aUIController->getGlyphAtlas( "smallLabel" );
+
+	// set size
+	int x = hasParam( "width" ) ? getParam<int>( "width" ) : StatsOverlay::DEFAULT_WIDTH;
+	// measured with a single text box, so a hidden overlay doesn't rasterize the atlas before its first draw
+	const float lineHeight = TextBox().font( aUIController->getFont( "smallLabel" ) ).text( "0" ).measure().y / aUIController->getRenderScale();
+	int y = (int)( lineHeight * NUM_LINES ) + UIController::DEFAULT_MARGIN_SMALL;
+	setSize( Vec2i( x, y ) );
+
+	// set position and bounds
+	setPositionAndBounds();
+}
+
+UIElementRef StatsOverlay::create( UIController *aUIController, const string &aName, const Params &aParams )
+{
+	return shared_ptr<StatsOverlay>( new StatsOverlay( aUIController, aName, aParams ) );
+}
+
+size_t StatsOverlay::getProcessMemory()
+{
+#if defined( _WIN32 )
+	PROCESS_MEMORY_COUNTERS counters;
+	if ( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) return counters.WorkingSetSize;
+	return 0;
+#elif defined( __APPLE__ )
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if ( task_info( mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count ) == KERN_SUCCESS ) return info.resident_size;
+	return 0;
+#else
+	FILE *file = fopen( "/proc/self/statm", "r" );
+	if ( !file ) return 0;
+	long pages = 0, resident = 0;
+	int read = fscanf( file, "%ld %ld", &pages, &resident );
+	fclose( file );
+	return read == 2 ? (size_t)resident * (size_t)sysconf( _SC_PAGESIZE ) : 0;
+#endif
+}
+
+void StatsOverlay::addSample( const float &aFrameTime, const float &aUpdateTime, const float &aDrawTime )
+{
+	Sample sample = { aFrameTime, aUpdateTime, aDrawTime };
+	mSamples.push( sample );
+}
+
+// appends a label and a value to a line, returning the new end
+static char * appendValue( char *aOut, const char *aLabel, const float &aValue, const int &aPrecision )
+{
+	size_t length = strlen( aLabel );
+	memcpy( aOut, aLabel, length );
+	aOut += length;
+	return aOut + formatFloat( aOut, aValue, aPrecision );
+}
+
+void StatsOverlay::update()
+{
+	Sample sample;
+	while ( mSamples.pop( sample ) ) {
+		mFrameTime = sample.mFrameTime;
+		mUpdateTime = sample.mUpdateTime;
+		mDrawTime = sample.mDrawTime;
+		mCurrent.add( sample.mFrameTime );
+	}
+
+	double now = getElapsedSeconds();
+	if ( now - mWindowStart >= mWindow ) {
+		mPrevious = mCurrent;
+		mCurrent.reset();
+		mWindowStart = now;
+	}
+	if ( now - mLastRefresh < mRefresh ) return;
+	mLastRefresh = now;
+
+	mReport = mPrevious;
+	mReport.merge( mCurrent );
+
+	char *out = appendValue( mLines[0], "frame ", mFrameTime, 1 );
+	out = appendValue( out, " ms  max ", mReport.getMax(), 1 );
+	*out = 0;
+
+	out = appendValue( mLines[1], "p50 ", mReport.getPercentile( 0.5f ), 1 );
+	out = appendValue( out, "  p95 ", mReport.getPercentile( 0.95f ), 1 );
+	out = appendValue( out, "  p99 ", mReport.getPercentile( 0.99f ), 1 );
+	*out = 0;
+
+	out = appendValue( mLines[2], "ui ", mUpdateTime, 2 );
+	out = appendValue( out, " + ", mDrawTime, 2 );
+	out = appendValue( out, " ms  mem ", getProcessMemory() / ( 1024.0f * 1024.0f ), 0 );
+	memcpy( out, " MB", 4 );
+
+	// texture memory and binds for background images, which stay at one or two per panel while they fit on a page
+	const TextureAtlas::Stats stats = getParent()->getTextureAtlas()->getStats();
+	out = appendValue( mLines[3], "atlas ", (float)stats.mNumPages, 0 );
+	out = appendValue( out, " pages ", stats.mGpuBytes / ( 1024.0f * 1024.0f ), 1 );
+	out = appendValue( out, " MB  ", (float)getParent()->getBackgroundBinds(), 0 );
+	memcpy( out, " binds", 7 );
+}
+
+void StatsOverlay::draw()
+{
+	// draw the readout
+	const float scale = 1.0f;
+	const Vec2f position = getBounds().getUL();
+	for ( int i = 0; i < NUM_LINES; i++ ) {
+		mAtlas->add( mLines[i], position + Vec2f( 0.0f, mAtlas->getLineHeight( scale ) * i ), scale, getNameColor() );
+	}
+}
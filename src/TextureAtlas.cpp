@@ -0,0 +1,266 @@
+#include "TextureAtlas.h"
+#include "WorkerPool.h"
+
+#include "cinder/app/AppNative.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+namespace {
+	// images start on this boundary, and are extruded by PADDING, so mip levels up to log2 of both stay clean
+	const int ALIGNMENT = 4;
+	const int MAX_MIP_LEVEL = 2;
+
+	int alignUp( const int &aValue )
+	{
+		return ( aValue + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+	}
+}
+
+TextureAtlas::TextureAtlas( const int &aPageSize )
+	: mPageSize( alignUp( aPageSize ) ), mNumRegions( 0 ), mNumBinds( 0 )
+{
+}
+
+TextureAtlasRef TextureAtlas::create( const int &aPageSize )
+{
+	return shared_ptr<TextureAtlas>( new TextureAtlas( aPageSize ) );
+}
+
+TextureAtlas::Region TextureAtlas::get( const string &aKey ) const
+{
+	map<string, Region>::const_iterator it = mRegions.find( aKey );
+	return it != mRegions.end() ? it->second : Region();
+}
+
+TextureAtlas::Region TextureAtlas::add( ImageSourceRef aImage, const string &aKey )
+{
+	if ( !aKey.empty() ) {
+		Region region = get( aKey );
+		if ( region ) return region;
+	}
+	return add( Surface( aImage ), aKey );
+}
+
+TextureAtlas::Region TextureAtlas::add( const Surface &aSurface, const string &aKey )
+{
+	if ( !aKey.empty() ) {
+		Region region = get( aKey );
+		if ( region ) return region;
+	}
+	Region region;
+	const Vec2i size = aSurface.getSize();
+	if ( size.x <= 0 || size.y <= 0 ) return region;
+
+	// find room on an existing page, or start a new one; an image larger than a page gets a page of its own
+	const Vec2i cell( alignUp( size.x + PADDING * 2 ), alignUp( size.y + PADDING * 2 ) );
+	Vec2i position;
+	int page = -1;
+	for ( int i = 0; i < (int)mPages.size() && page < 0; i++ ) {
+		if ( allocate( mPages[i], cell, &position ) ) page = i;
+	}
+	if ( page < 0 ) {
+		page = addPage( Vec2i( math<int>::max( cell.x, mPageSize ), math<int>::max( cell.y, mPageSize ) ) );
+		allocate( mPages[page], cell, &position );
+	}
+
+	// copy the image, then extrude its edges into the padding: rows first, then whole columns, which fills the corners
+	Surface &surface = mPages[page].mSurface;
+	const Area area( position + Vec2i( PADDING, PADDING ), position + Vec2i( PADDING, PADDING ) + size );
+	surface.copyFrom( aSurface, aSurface.getBounds(), area.getUL() );
+	for ( int k = 1; k <= PADDING; k++ ) {
+		surface.copyFrom( surface, Area( area.x1, area.y1, area.x2, area.y1 + 1 ), Vec2i( 0, -k ) );
+		surface.copyFrom( surface, Area( area.x1, area.y2 - 1, area.x2, area.y2 ), Vec2i( 0, k ) );
+	}
+	for ( int k = 1; k <= PADDING; k++ ) {
+		surface.copyFrom( surface, Area( area.x1, area.y1 - PADDING, area.x1 + 1, area.y2 + PADDING ), Vec2i( -k, 0 ) );
+		surface.copyFrom( surface, Area( area.x2 - 1, area.y1 - PADDING, area.x2, area.y2 + PADDING ), Vec2i( k, 0 ) );
+	}
+	mPages[page].mUsedPixels += size.x * size.y;
+	mPages[page].mDirty = true;
+
+	const float u = 1.0f / surface.getWidth(), v = 1.0f / surface.getHeight();
+	region.mPage = page;
+	region.mTexCoords = Rectf( area.x1 * u, area.y1 * v, area.x2 * u, area.y2 * v );
+	region.mSize = size;
+	mNumRegions++;
+	if ( !aKey.empty() ) mRegions[aKey] = region;
+	return region;
+}
+
+bool TextureAtlas::allocate( Page &aPage, const Vec2i &aSize, Vec2i *aPosition )
+{
+	const int width = aPage.mSurface.getWidth(), height = aPage.mSurface.getHeight();
+
+	// the shelf that wastes the least height
+	Shelf *best = nullptr;
+	for ( unsigned int i = 0; i < aPage.mShelves.size(); i++ ) {
+		Shelf &shelf = aPage.mShelves[i];
+		if ( shelf.mHeight >= aSize.y && shelf.mX + aSize.x <= width && ( !best || shelf.mHeight < best->mHeight ) ) {
+			best = &shelf;
+		}
+	}
+	if ( !best ) {
+		if ( aPage.mTop + aSize.y > height || aSize.x > width ) return false;
+		Shelf shelf = { aPage.mTop, aSize.y, 0 };
+		aPage.mShelves.push_back( shelf );
+		aPage.mTop += aSize.y;
+		best = &aPage.mShelves.back();
+	}
+	*aPosition = Vec2i( best->mX, best->mY );
+	best->mX += aSize.x;
+	return true;
+}
+
+int TextureAtlas::addPage( const Vec2i &aSize )
+{
+	Page page;
+	page.mSurface = Surface( aSize.x, aSize.y, true );
+	for ( int y = 0; y < aSize.y; y++ ) {
+		memset( page.mSurface.getData() + y * page.mSurface.getRowBytes(), 0, aSize.x * page.mSurface.getPixelInc() );
+	}
+	page.mTop = 0;
+	page.mUsedPixels = 0;
+	page.mDirty = true;
+	mPages.push_back( page );
+	return (int)mPages.size() - 1;
+}
+
+void TextureAtlas::bindPage( Page &aPage )
+{
+	if ( aPage.mDirty ) {
+		// pages change only while images are loading, so upload the whole page again rather than patching mip levels
+		gl::Texture::Format format;
+		format.enableMipmapping( true );
+		format.setMinFilter( GL_LINEAR_MIPMAP_LINEAR );
+		format.setMagFilter( GL_LINEAR );
+		aPage.mTexture = gl::Texture( aPage.mSurface, format );
+		aPage.mTexture.bind();
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, MAX_MIP_LEVEL );
+		aPage.mDirty = false;
+	}
+	aPage.mTexture.enableAndBind();
+	mNumBinds++;
+}
+
+void TextureAtlas::draw( const Region &aRegion, const Rectf &aRect, const ColorA &aColor )
+{
+	if ( !aRegion ) return;
+
+	const Rectf &t = aRegion.mTexCoords;
+	const float vertices[8] = { aRect.x1, aRect.y1, aRect.x2, aRect.y1, aRect.x2, aRect.y2, aRect.x1, aRect.y2 };
+	const float texCoords[8] = { t.x1, t.y1, t.x2, t.y1, t.x2, t.y2, t.x1, t.y2 };
+	mVertices.insert( mVertices.end(), vertices, vertices + 8 );
+	mTexCoords.insert( mTexCoords.end(), texCoords, texCoords + 8 );
+	for ( int i = 0; i < 4; i++ ) {
+		const float color[4] = { aColor.r, aColor.g, aColor.b, aColor.a };
+		mColors.insert( mColors.end(), color, color + 4 );
+	}
+
+	if ( mBatches.empty() || mBatches.back().mPage != aRegion.mPage ) {
+		Batch batch = { aRegion.mPage, (int)mVertices.size() / 8 - 1, 0 };
+		mBatches.push_back( batch );
+	}
+	mBatches.back().mCount++;
+}
+
+void TextureAtlas::flush()
+{
+	if ( mBatches.empty() ) return;
+
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+	glVertexPointer( 2, GL_FLOAT, 0, &mVertices[0] );
+	glTexCoordPointer( 2, GL_FLOAT, 0, &mTexCoords[0] );
+	glColorPointer( 4, GL_FLOAT, 0, &mColors[0] );
+	for ( unsigned int i = 0; i < mBatches.size(); i++ ) {
+		bindPage( mPages[mBatches[i].mPage] );
+		glDrawArrays( GL_QUADS, mBatches[i].mFirst * 4, mBatches[i].mCount * 4 );
+	}
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+	const gl::Texture &last = mPages[mBatches.back().mPage].mTexture;
+	last.unbind();
+	last.disable();
+
+	// keep the capacity for the next frame
+	mVertices.clear();
+	mTexCoords.clear();
+	mColors.clear();
+	mBatches.clear();
+}
+
+TextureAtlas::Stats TextureAtlas::getStats() const
+{
+	Stats stats;
+	stats.mNumPages = (int)mPages.size();
+	stats.mNumRegions = mNumRegions;
+	stats.mGpuBytes = 0;
+	stats.mCpuBytes = 0;
+	stats.mNumBinds = mNumBinds;
+	double area = 0.0, used = 0.0;
+	for ( unsigned int i = 0; i < mPages.size(); i++ ) {
+		const Surface &surface = mPages[i].mSurface;
+		const size_t pixels = (size_t)surface.getWidth() * surface.getHeight();
+		// the mip chain adds a third
+		stats.mGpuBytes += pixels * 4 * 4 / 3;
+		stats.mCpuBytes += (size_t)surface.getRowBytes() * surface.getHeight();
+		area += (double)pixels;
+		used += mPages[i].mUsedPixels;
+	}
+	stats.mOccupancy = area > 0.0 ? (float)( used / area ) : 0.0f;
+	return stats;
+}
+
+void PendingImage::prewarm()
+{
+	if ( !*this || mDecoded ) return;
+	shared_ptr<Decoded> decoded( new Decoded );
+	mDecoded = decoded;
+	const string assetPath = mAssetPath;
+	ImageSourceRef source = mSource;
+	WorkerPool::getShared().enqueue( [decoded, assetPath, source] {
+		int queued = Decoded::QUEUED;
+		if ( decoded->mState.compare_exchange_strong( queued, Decoded::DECODING ) ) decode( *decoded, assetPath, source );
+	} );
+}
+
+void PendingImage::decode( Decoded &aDecoded, const string &aAssetPath, ImageSourceRef aSource )
+{
+	try {
+		aDecoded.mSurface = Surface( aSource ? aSource : loadImage( loadAsset( aAssetPath ) ) );
+	} catch ( ... ) {
+		aDecoded.mError = current_exception();
+	}
+	aDecoded.mState.store( Decoded::DONE, memory_order_release );
+}
+
+TextureAtlas::Region PendingImage::pack( TextureAtlas &aAtlas )
+{
+	TextureAtlas::Region region = aAtlas.get( mAssetPath );
+	if ( !region && *this ) {
+		if ( !mDecoded ) mDecoded.reset( new Decoded );
+
+		// claim the decode if the worker hasn't, otherwise wait for it to finish
+		int queued = Decoded::QUEUED;
+		if ( mDecoded->mState.compare_exchange_strong( queued, Decoded::DECODING ) ) {
+			decode( *mDecoded, mAssetPath, mSource );
+		}
+		while ( mDecoded->mState.load( memory_order_acquire ) != Decoded::DONE ) this_thread::yield();
+
+		shared_ptr<Decoded> decoded = mDecoded;
+		const string key = mAssetPath;
+		*this = PendingImage();
+		if ( decoded->mError ) rethrow_exception( decoded->mError );
+		return aAtlas.add( decoded->mSurface, key );
+	}
+	*this = PendingImage();
+	return region;
+}
@@ -4,7 +4,14 @@
 #include "Button.h"
 #include "Label.h"
 #include "Image.h"
+#include "ImageSequence.h"
 #include "Graph.h"
+#include "Heatmap.h"
+#include "StatsOverlay.h"
+#include "UIManager.h"
+#include "Section.h"
+
+#include "cinder/Json.h"
 
 using namespace ci;
 using namespace ci::app;
@@ -13,18 +20,29 @@ using namespace MinimalUI;
 
 class FontStyleExc;
 
+namespace {
+	// adds the time until it goes out of scope to a total, in milliseconds
+	struct ScopedTimer {
+		ScopedTimer( float &aTotal ) : mTotal( aTotal ), mStart( chrono::steady_clock::now() ) { }
+		~ScopedTimer() { mTotal += chrono::duration<float, milli>( chrono::steady_clock::now() - mStart ).count(); }
+		float &mTotal;
+		chrono::steady_clock::time_point mStart;
+	};
+}
+
 int UIController::DEFAULT_PANEL_WIDTH = 216;
 int UIController::DEFAULT_MARGIN_LARGE = 10;
 int UIController::DEFAULT_MARGIN_SMALL = 4;
 int UIController::DEFAULT_UPDATE_FREQUENCY = 2;
-int UIController::DEFAULT_FBO_WIDTH = 2048;
+int UIController::DEFAULT_TILE_SIZE = 512;
+double UIController::EXTERNAL_GESTURE_TIMEOUT = 0.5;
 ci::ColorA UIController::DEFAULT_STROKE_COLOR = ci::ColorA( 0.07f, 0.26f, 0.29f, 1.0f );
 ci::ColorA UIController::ACTIVE_STROKE_COLOR = ci::ColorA( 0.19f, 0.66f, 0.71f, 1.0f );
 ci::ColorA UIController::DEFAULT_NAME_COLOR = ci::ColorA( 0.14f, 0.49f, 0.54f, 1.0f );
 ci::ColorA UIController::DEFAULT_BACKGROUND_COLOR = ci::ColorA( 0.0f, 0.0f, 0.0f, 1.0f );
 
-UIController::UIController( app::WindowRef aWindow, const string &aParamString )
-	: mWindow( aWindow ), mParamString( aParamString )
+UIController::UIController( app::WindowRef aWindow, const string &aParamString, UIManager *aManager )
+	: mWindow( aWindow ), mManager( aManager ), mParamString( aParamString ), mGeneration( 0 ), mModelInput( 1024 )
 {
 	JsonTree params( mParamString );
 	mVisible = params.hasChild( "visible" ) ? params["visible"].getValue<bool>() : true;
@@ -85,25 +103,86 @@ UIController::UIController( app::WindowRef aWindow, const string &aParamString )
 		UIController::DEFAULT_BACKGROUND_COLOR = ColorA::hexA( hexValue );
 	}
 
+	// text and the tiles are rendered at the window's content scale, which changes when it moves to another display
+	mRenderScale = mWindow->getContentScale();
+	mTileColumns = mTileRows = 0;
+	mTileIndexDirty = true;
+	mCbDisplayChange = mWindow->getSignalDisplayChange().connect( std::bind( &UIController::displayChanged, this ) );
+
 	resize();
 
-	mCbMouseDown = mWindow->getSignalMouseDown().connect( mDepth + 99, std::bind( &UIController::mouseDown, this, std::placeholders::_1 ) );
+	// a manager does hit testing across all of its panels and owns the fonts
+	if ( !mManager ) {
+		mCbMouseDown = mWindow->getSignalMouseDown().connect( mDepth, std::bind( &UIController::mouseDown, this, std::placeholders::_1 ) );
+		mCbMouseUp = mWindow->getSignalMouseUp().connect( mDepth, std::bind( &UIController::mouseUp, this, std::placeholders::_1 ) );
+		mCbMouseDrag = mWindow->getSignalMouseDrag().connect( mDepth, std::bind( &UIController::mouseDrag, this, std::placeholders::_1 ) );
+		mCbTouchesBegan = mWindow->getSignalTouchesBegan().connect( mDepth, [this]( TouchEvent &event ) { touchesBegan( event ); } );
+		mCbTouchesMoved = mWindow->getSignalTouchesMoved().connect( mDepth, [this]( TouchEvent &event ) { touchesMoved( event ); } );
+		mCbTouchesEnded = mWindow->getSignalTouchesEnded().connect( mDepth, [this]( TouchEvent &event ) { touchesEnded( event ); } );
 
-	// set default fonts
-	setFont( "label", Font( "Arial", 16 * 2 ) );
-	setFont( "smallLabel", Font( "Arial", 12 * 2 ) );
-	setFont( "icon", Font( "Arial", 22 * 2 ) );
-	setFont( "header", Font( "Arial", 48 * 2 ) );
-	setFont( "body", Font( "Arial", 19 * 2 ) );
-	setFont( "footer", Font( "Arial Italic", 14 * 2 ) );
+		// set default fonts, in points
+		setFont( "label", Font( "Arial", 16 ) );
+		setFont( "smallLabel", Font( "Arial", 12 ) );
+		setFont( "icon", Font( "Arial", 22 ) );
+		setFont( "header", Font( "Arial", 48 ) );
+		setFont( "body", Font( "Arial", 19 ) );
+		setFont( "footer", Font( "Arial Italic", 14 ) );
+	}
 
 	mInsertPosition = Vec2i( mMarginLarge, mMarginLarge );
+	mLayoutDirty = false;
+
+	mFrameTime = mUpdateTime = mDrawTime = mLastUpdateTime = mLastDrawTime = 0.0f;
+	mLastFrame = chrono::steady_clock::now();
+	mStatsOverlay = nullptr;
+
+	// undo history, bounded to the given number of bytes of compressed entries
+	size_t undoMemory = params.hasChild( "undoMemory" ) ? params["undoMemory"].getValue<int>() : UndoJournal::DEFAULT_MEMORY_BUDGET;
+	mUndoJournal = UndoJournal::create( undoMemory );
+	mGestures.resize( MAX_TOUCHES + 1 );
+	for ( unsigned int i = 0; i < mGestures.size(); i++ ) {
+		mGestures[i].mElement = nullptr;
+		mGestures[i].mValues.reserve( 16 );
+	}
+
+	for ( int i = 0; i < MAX_TOUCHES; i++ ) mTouches[i].mElement = nullptr;
+	mIndexColumns = mIndexRows = 0;
+	mIndexDirty = true;
+
+	mExternalEvents.reserve( 64 );
+	mExternalGestures.reserve( 16 );
+	mExternalRefresh = false;
+	mInputReplayer = nullptr;
 
 	mFboNumSamples = params.hasChild( "fboNumSamples" ) ? params["fboNumSamples"].getValue<int>() : 0;
+	mBackgroundBinds = 0;
 	if (params.hasChild("backgroundImage")) {
-		mBackgroundTexture = gl::Texture(loadImage(loadAsset(params["backgroundImage"].getValue<string>())));
+		mPendingBackground = PendingImage(params["backgroundImage"].getValue<string>());
+	}
+
+	// a hidden panel creates its tiles, name textures and images when it's first shown, and can give them back after
+	// "idleRelease" seconds hidden
+	mIdleRelease = params.hasChild( "idleRelease" ) ? params["idleRelease"].getValue<double>() : 0.0;
+	mHiddenSince = getElapsedSeconds();
+	mMaterialized = mNameTexturesReleased = false;
+	if ( mVisible ) materialize();
+
+	mThreaded = params.hasChild( "threaded" ) ? params["threaded"].getValue<bool>() : false;
+	mStepRequested = mStopping = mSynchronous = false;
+	mRenderedGeneration = 0;
+	if ( mThreaded ) mModelThread = thread( &UIController::modelThread, this );
+}
+
+UIController::~UIController()
+{
+	if ( mModelThread.joinable() ) {
+		{
+			lock_guard<mutex> lock( mStepMutex );
+			mStopping = true;
+		}
+		mStepCondition.notify_one();
+		mModelThread.join();
 	}
-	setupFbo();
 }
 
 UIControllerRef UIController::create( const string &aParamString, app::WindowRef aWindow )
@@ -125,175 +204,1309 @@ void UIController::resize()
 		mPosition = Vec2i( mX, mY );
 	}
 	mBounds = Area( Vec2i::zero(), size );
+
+	// the tiles only need to cover the panel
+	if ( !mTiles.empty() && getPixelSize() != mPixelSize ) setupTiles();
+}
+
+Vec2i UIController::getPixelSize() const
+{
+	int width = (int)ceilf( mBounds.getWidth() * mRenderScale );
+	int height = (int)ceilf( mBounds.getHeight() * mRenderScale );
+	return Vec2i( math<int>::max( width, 1 ), math<int>::max( height, 1 ) );
+}
+
+void UIController::displayChanged()
+{
+	float scale = mWindow->getContentScale();
+	if ( scale == mRenderScale ) return;
+	mRenderScale = scale;
+
+	// fonts and glyphs are rasterized again at the new scale; name textures follow the next time they're drawn
+	mScaledFonts.clear();
+	if ( mManager ) {
+		mManager->displayChanged();
+	} else {
+		for ( map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.begin(); it != mGlyphAtlases.end(); ++it ) {
+			it->second->setFont( getFont( it->first ) );
+		}
+	}
+	if ( mMaterialized ) setupTiles();
 }
 
 void UIController::mouseDown( MouseEvent &event )
 {
+	if ( mInputCapture && !onModelThread() ) mInputCapture->mouseDown( event.getPos(), event.isRight() );
+	if ( queueInput( ModelInput::MOUSE_DOWN, event.getPos(), 0, event.isRight() ) ) {
+		if ( mVisible && contains( event.getPos() ) ) event.setHandled();
+		return;
+	}
 	if ( mVisible ) {
-		if ( (mBounds + mPosition).contains( event.getPos() ) || mForceInteraction )
+		// topmost (last added) element first
+		for ( int i = (int)mVisibleElements.size() - 1; i >= 0; i-- ) {
+			if ( mVisibleElements[i]->mouseDown( event ) ) break;
+		}
+
+		if ( contains( event.getPos() ) )
 		{
 			event.setHandled();
 		}
 	}
 }
 
+void UIController::mouseUp( MouseEvent &event )
+{
+	if ( mInputCapture && !onModelThread() ) mInputCapture->mouseUp( event.getPos() );
+	if ( queueInput( ModelInput::MOUSE_UP, event.getPos(), 0, false ) ) return;
+	for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+		mVisibleElements[i]->mouseUp( event );
+	}
+}
+
+void UIController::mouseDrag( MouseEvent &event )
+{
+	if ( mInputCapture && !onModelThread() ) mInputCapture->mouseDrag( event.getPos() );
+	if ( queueInput( ModelInput::MOUSE_DRAG, event.getPos(), 0, false ) ) return;
+	for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+		mVisibleElements[i]->mouseDrag( event );
+	}
+}
+
+void UIController::touchesBegan( TouchEvent &event )
+{
+	dispatchTouches( event.getTouches(), &UIController::touchesBegan );
+}
+
+void UIController::touchesMoved( TouchEvent &event )
+{
+	dispatchTouches( event.getTouches(), &UIController::touchesMoved );
+}
+
+void UIController::touchesEnded( TouchEvent &event )
+{
+	dispatchTouches( event.getTouches(), &UIController::touchesEnded );
+}
+
+void UIController::dispatchTouches( const vector<TouchEvent::Touch> &aTouches, TouchHandler aHandler )
+{
+	// converted a batch at a time, on the stack
+	TouchPoint batch[MAX_TOUCHES];
+	for ( size_t first = 0; first < aTouches.size(); first += MAX_TOUCHES ) {
+		const size_t count = math<size_t>::min( aTouches.size() - first, (size_t)MAX_TOUCHES );
+		for ( size_t i = 0; i < count; i++ ) {
+			batch[i].mId = aTouches[first + i].getId();
+			batch[i].mPos = aTouches[first + i].getPos();
+		}
+		( this->*aHandler )( batch, count );
+	}
+}
+
+void UIController::touchesBegan( const TouchPoint *aTouches, const size_t &aCount )
+{
+	if ( mThreaded && !onModelThread() ) {
+		for ( size_t i = 0; i < aCount; i++ ) queueInput( ModelInput::TOUCHES_BEGAN, aTouches[i].mPos, aTouches[i].mId, false );
+		return;
+	}
+	if ( !mVisible ) return;
+
+	UIElement *hits[MAX_TOUCHES];
+	for ( size_t first = 0; first < aCount; first += MAX_TOUCHES ) {
+		const size_t count = math<size_t>::min( aCount - first, (size_t)MAX_TOUCHES );
+		hitTest( aTouches + first, count, hits );
+		for ( size_t i = 0; i < count; i++ ) {
+			// an element follows one touch, or the mouse, at a time
+			UIElement *element = hits[i];
+			if ( !element || element->isLocked() || element->isActive() ) continue;
+			TouchCapture *capture = nullptr;
+			for ( int j = 0; j < MAX_TOUCHES && !capture; j++ ) {
+				if ( !mTouches[j].mElement ) capture = &mTouches[j];
+			}
+			if ( !capture ) return;
+			capture->mId = aTouches[first + i].mId;
+			capture->mElement = element;
+			element->touchBegan( Vec2i( aTouches[first + i].mPos ) - mPosition );
+		}
+	}
+}
+
+void UIController::touchesMoved( const TouchPoint *aTouches, const size_t &aCount )
+{
+	if ( mThreaded && !onModelThread() ) {
+		for ( size_t i = 0; i < aCount; i++ ) queueInput( ModelInput::TOUCHES_MOVED, aTouches[i].mPos, aTouches[i].mId, false );
+		return;
+	}
+	for ( size_t i = 0; i < aCount; i++ ) {
+		for ( int j = 0; j < MAX_TOUCHES; j++ ) {
+			if ( mTouches[j].mElement && mTouches[j].mId == aTouches[i].mId ) {
+				mTouches[j].mElement->touchMoved( Vec2i( aTouches[i].mPos ) - mPosition );
+				break;
+			}
+		}
+	}
+}
+
+void UIController::touchesEnded( const TouchPoint *aTouches, const size_t &aCount )
+{
+	if ( mThreaded && !onModelThread() ) {
+		for ( size_t i = 0; i < aCount; i++ ) queueInput( ModelInput::TOUCHES_ENDED, aTouches[i].mPos, aTouches[i].mId, false );
+		return;
+	}
+	for ( size_t i = 0; i < aCount; i++ ) {
+		for ( int j = 0; j < MAX_TOUCHES; j++ ) {
+			if ( mTouches[j].mElement && mTouches[j].mId == aTouches[i].mId ) {
+				UIElement *element = mTouches[j].mElement;
+				mTouches[j].mElement = nullptr;
+				element->touchEnded( Vec2i( aTouches[i].mPos ) - mPosition );
+				break;
+			}
+		}
+	}
+}
+
+UIElement* UIController::getTouchedElement( const uint32_t &aId ) const
+{
+	for ( int i = 0; i < MAX_TOUCHES; i++ ) {
+		if ( mTouches[i].mElement && mTouches[i].mId == aId ) return mTouches[i].mElement;
+	}
+	return nullptr;
+}
+
+int UIController::getNumTouches() const
+{
+	int count = 0;
+	for ( int i = 0; i < MAX_TOUCHES; i++ ) {
+		if ( mTouches[i].mElement ) count++;
+	}
+	return count;
+}
+
+void UIController::buildTouchIndex()
+{
+	mIndexDirty = false;
+
+	// the grid covers every visible element, which can run past the panel's bounds
+	Vec2i extent( 0, 0 );
+	for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+		const Area &bounds = mVisibleElements[i]->mBounds;
+		extent.x = math<int>::max( extent.x, bounds.x2 );
+		extent.y = math<int>::max( extent.y, bounds.y2 );
+	}
+	mIndexColumns = extent.x / TOUCH_CELL_SIZE + 1;
+	mIndexRows = extent.y / TOUCH_CELL_SIZE + 1;
+
+	// count the elements in each cell, then place them, in order, so later (topmost) elements come last in a cell
+	mIndexStarts.assign( mIndexColumns * mIndexRows + 1, 0 );
+	for ( int pass = 0; pass < 2; pass++ ) {
+		for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+			const Area &bounds = mVisibleElements[i]->mBounds;
+			const int x1 = math<int>::clamp( bounds.x1 / TOUCH_CELL_SIZE, 0, mIndexColumns - 1 );
+			const int y1 = math<int>::clamp( bounds.y1 / TOUCH_CELL_SIZE, 0, mIndexRows - 1 );
+			const int x2 = math<int>::clamp( bounds.x2 / TOUCH_CELL_SIZE, 0, mIndexColumns - 1 );
+			const int y2 = math<int>::clamp( bounds.y2 / TOUCH_CELL_SIZE, 0, mIndexRows - 1 );
+			for ( int y = y1; y <= y2; y++ ) {
+				for ( int x = x1; x <= x2; x++ ) {
+					if ( pass == 0 ) {
+						mIndexStarts[y * mIndexColumns + x + 1]++;
+					} else {
+						mIndexElements[mIndexStarts[y * mIndexColumns + x]++] = i;
+					}
+				}
+			}
+		}
+		if ( pass == 0 ) {
+			for ( unsigned int c = 1; c < mIndexStarts.size(); c++ ) mIndexStarts[c] += mIndexStarts[c - 1];
+			mIndexElements.resize( mIndexStarts.back() );
+		} else {
+			// placing advanced each start to the next cell's; shift them back
+			for ( int c = (int)mIndexStarts.size() - 1; c > 0; c-- ) mIndexStarts[c] = mIndexStarts[c - 1];
+			mIndexStarts[0] = 0;
+		}
+	}
+}
+
+void UIController::hitTest( const TouchPoint *aTouches, const size_t &aCount, UIElement **aElements )
+{
+	if ( mIndexDirty ) buildTouchIndex();
+
+	for ( size_t i = 0; i < aCount; i++ ) {
+		aElements[i] = nullptr;
+		const Vec2i pos = Vec2i( aTouches[i].mPos ) - mPosition;
+		if ( pos.x < 0 || pos.y < 0 ) continue;
+		const int x = pos.x / TOUCH_CELL_SIZE, y = pos.y / TOUCH_CELL_SIZE;
+		if ( x >= mIndexColumns || y >= mIndexRows ) continue;
+		const int cell = y * mIndexColumns + x;
+		for ( int k = mIndexStarts[cell + 1] - 1; k >= mIndexStarts[cell]; k-- ) {
+			UIElement *element = mVisibleElements[mIndexElements[k]];
+			if ( element->mBounds.contains( pos ) ) {
+				aElements[i] = element;
+				break;
+			}
+		}
+	}
+}
+
 void UIController::drawBackground()
 {
 	gl::pushMatrices();
 	gl::color(Color::white());
 
 	// draw the background texture if it's defined
-	if (mBackgroundTexture) gl::draw(mBackgroundTexture, mBounds);
+	if (mBackgroundRegion) {
+		getTextureAtlas()->draw(mBackgroundRegion, Rectf(toPixels(mBounds)));
+		getTextureAtlas()->flush();
+	}
+	else if (mBackgroundTexture) {
+		gl::draw(mBackgroundTexture, mBounds);
+		mBackgroundBinds++;
+	}
 
 	gl::popMatrices();
 }
 
+void UIController::drawElementBackgrounds(const vector<int> &aElements)
+{
+	// every element's fill goes in one draw, and then every background image in one bind per atlas page; elements
+	// don't overlap, so this looks the same as each element drawing its own before its content
+	mFillVertices.clear();
+	mFillColors.clear();
+	for (unsigned int i = 0; i < aElements.size(); i++) {
+		const UIElement *element = mVisibleElements[aElements[i]];
+		const ColorA color = element->getFillColor();
+		if (color.a <= 0.0f) continue;
+		const Rectf rect(element->getBounds());
+		const float vertices[8] = { rect.x1, rect.y1, rect.x2, rect.y1, rect.x2, rect.y2, rect.x1, rect.y2 };
+		mFillVertices.insert(mFillVertices.end(), vertices, vertices + 8);
+		for (int j = 0; j < 4; j++) {
+			const float c[4] = { color.r, color.g, color.b, color.a };
+			mFillColors.insert(mFillColors.end(), c, c + 4);
+		}
+	}
+	if (!mFillVertices.empty()) {
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, 0, &mFillVertices[0]);
+		glColorPointer(4, GL_FLOAT, 0, &mFillColors[0]);
+		glDrawArrays(GL_QUADS, 0, mFillVertices.size() / 2);
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+	}
+
+	TextureAtlasRef atlas = getTextureAtlas();
+	gl::color(Color::white());
+	for (unsigned int i = 0; i < aElements.size(); i++) {
+		UIElement *element = mVisibleElements[aElements[i]];
+		if (element->getBackgroundRegion()) {
+			atlas->draw(element->getBackgroundRegion(), Rectf(element->getBounds()));
+		}
+		else if (element->getBackgroundTexture()) {
+			gl::draw(element->getBackgroundTexture(), element->getBounds());
+			mBackgroundBinds++;
+		}
+	}
+	atlas->flush();
+}
+
 void UIController::draw()
 {
 	if (!mVisible)
 		return;
 
-		// save state
-		gl::pushMatrices();
-		glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_LINE_BIT | GL_CURRENT_BIT);
+	// save state
+	gl::pushMatrices();
+	glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_LINE_BIT | GL_CURRENT_BIT);
 
-		// disable depth read (otherwise any 3d drawing done after this will be obscured by the FBO; not exactly sure why)
-		gl::disableDepthRead();
+	// disable depth read (otherwise any 3d drawing done after this will be obscured by the FBO; not exactly sure why)
+	gl::disableDepthRead();
 
-	// optimization
-	if (getElapsedFrames() % DEFAULT_UPDATE_FREQUENCY == 0) {
+	render();
 
-		// start drawing to the Fbo
-		mFbo.bindFramebuffer();
+	// reset the matrices, for whichever of the panel's windows is being drawn
+	gl::setViewport( toPixels( app::getWindow()->getBounds() ) );
+	gl::setMatricesWindow( toPixels( app::getWindow()->getSize() ) );
 
-		gl::lineWidth(toPixels(2.0f));
-		gl::enable(GL_LINE_SMOOTH);
-		gl::enableAlphaBlending();
-		glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	composite();
 
-		// clear and set viewport and matrices
-		gl::clear(ColorA(0.0f, 0.0f, 0.0f, 0.0f));
-		gl::setViewport(toPixels(mBounds + mPosition));
-		gl::setMatricesWindow(toPixels(mBounds.getSize()), false);
+	// restore state
+	glPopAttrib();
+	gl::popMatrices();
+}
+
+void UIController::render()
+{
+	// once per refresh, in the context the tiles belong to; mirrors share their textures
+	if ( app::getWindow() != mWindow ) return;
+
+	ScopedTimer timer( mDrawTime );
+
+	if ( mThreaded ) {
+		// the model is only drawn between steps; tiles with elements on them are refreshed only when a step has
+		// finished since the last time, and otherwise composited as they are
+		unique_lock<mutex> lock( mModelMutex, try_to_lock );
+		if ( !lock.owns_lock() ) return;
+		const uint64_t generation = mGeneration;
+		const bool refresh = generation != mRenderedGeneration && ( getElapsedFrames() % DEFAULT_UPDATE_FREQUENCY == 0 || mExternalRefresh );
+		if ( refresh ) {
+			mRenderedGeneration = generation;
+			mExternalRefresh = false;
+		}
+		renderTiles( refresh );
+		return;
+	}
+
+	if ( mLayoutDirty ) layout();
+
+	// optimization; external input skips it, so a fader doesn't lag a frame behind on screen
+	const bool refresh = getElapsedFrames() % DEFAULT_UPDATE_FREQUENCY == 0 || mExternalRefresh;
+	mExternalRefresh = false;
+	renderTiles( refresh );
+}
+
+void UIController::renderTiles( const bool &aRefresh )
+{
+	// on the main thread, between steps
+	if ( mNameTexturesReleased ) {
+		mNameTexturesReleased = false;
+		for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+			mUIElements[i]->releaseDeferredNameTexture();
+		}
+	}
+	if ( mTileIndexDirty ) buildTileIndex();
+	if ( aRefresh ) updateLayers();
 
-		// draw backing panel
-		gl::color(mPanelColor);
-		gl::drawSolidRect(toPixels(mBounds));
+	// only what's on screen is drawn; tiles off screen that would have been refreshed are drawn when they're back
+	const Area points = getVisibleArea();
+	const Area visible( (int)floorf( points.x1 * mRenderScale ), (int)floorf( points.y1 * mRenderScale ), (int)ceilf( points.x2 * mRenderScale ), (int)ceilf( points.y2 * mRenderScale ) );
 
-		// draw the background
-		drawBackground();
+	bool uploaded = false;
+	for ( unsigned int i = 0; i < mTiles.size(); i++ ) {
+		Tile &tile = mTiles[i];
+		const bool dynamic = hasDynamicElements( tile );
+		const bool changed = aRefresh && dynamic;
+		if ( !tile.mArea.intersects( visible ) ) {
+			if ( changed ) tile.mOutdated = true;
+			continue;
+		}
+		if ( !tile.mStale && !tile.mOutdated && !changed ) continue;
 
-		// draw elements
-		for (unsigned int i = 0; i < mUIElements.size(); i++) {
-			mUIElements[i]->draw();
+		if ( !uploaded ) {
+			// GL work the last update prepared
+			for ( unsigned int j = 0; j < mVisibleElements.size(); j++ ) {
+				mVisibleElements[j]->upload();
+			}
+			mBackgroundBinds = 0;
+			uploaded = true;
 		}
+		if ( tile.mStale ) bakeTile( tile, dynamic );
+		if ( dynamic ) composeTile( tile );
+		tile.mStale = tile.mOutdated = false;
+	}
+}
+
+void UIController::beginTile( gl::Fbo &aFbo, const Tile &aTile, const bool &aClear )
+{
+	if ( !aFbo ) aFbo = gl::Fbo( aTile.mArea.getWidth(), aTile.mArea.getHeight(), mFormat );
+
+	// start drawing to the tile
+	aFbo.bindFramebuffer();
+
+	gl::lineWidth(toPixels(2.0f));
+	gl::enable(GL_LINE_SMOOTH);
+	gl::enableAlphaBlending();
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	// clear and set viewport and matrices, with the tile's corner of the panel at the origin
+	if (aClear) gl::clear(ColorA(0.0f, 0.0f, 0.0f, 0.0f));
+	gl::setViewport(Area(Vec2i::zero(), aFbo.getSize()));
+	gl::setMatricesWindow(aFbo.getSize(), false);
+	gl::translate(Vec2f(-aTile.mArea.x1, -aTile.mArea.y1));
+}
+
+void UIController::bakeTile( Tile &aTile, const bool &aDynamic )
+{
+	// a tile with nothing dynamic on it is just its cached layer
+	if ( !aDynamic ) aTile.mLayerFbo.reset();
+	gl::Fbo &fbo = aDynamic ? aTile.mLayerFbo : aTile.mFbo;
+	beginTile( fbo, aTile, true );
+
+	// draw backing panel
+	gl::color(mPanelColor);
+	gl::drawSolidRect(toPixels(mBounds));
 
-		// finish drawing to the Fbo
-		mFbo.unbindFramebuffer();
+	// draw the background, then the static elements
+	const int atlasBinds = getTextureAtlas()->getStats().mNumBinds;
+	drawBackground();
+	mBackgroundBinds += getTextureAtlas()->getStats().mNumBinds - atlasBinds;
+	drawTileElements( aTile, true );
+
+	// finish drawing to the tile
+	fbo.unbindFramebuffer();
+
+	// a multisampled Fbo is resolved now, while its own window's context is current, rather than by the first window
+	// to composite it
+	if ( !aDynamic ) fbo.getTexture();
+}
+
+void UIController::composeTile( Tile &aTile )
+{
+	// the cached layer is copied as it is, multisampled or not, then the dynamic elements are drawn over it
+	if ( !aTile.mFbo ) aTile.mFbo = gl::Fbo( aTile.mArea.getWidth(), aTile.mArea.getHeight(), mFormat );
+	const Area area( Vec2i::zero(), aTile.mArea.getSize() );
+	aTile.mLayerFbo.blitTo( aTile.mFbo, area, area );
+
+	beginTile( aTile.mFbo, aTile, false );
+	drawTileElements( aTile, false );
+	aTile.mFbo.unbindFramebuffer();
+	aTile.mFbo.getTexture();
+}
+
+void UIController::drawTileElements( const Tile &aTile, const bool &aStatic )
+{
+	mLayerElements.clear();
+	for ( unsigned int i = 0; i < aTile.mElements.size(); i++ ) {
+		if ( mStaticElements[aTile.mElements[i]] == aStatic ) mLayerElements.push_back( aTile.mElements[i] );
+	}
+
+	// the elements' fills and background images, then the elements
+	const int atlasBinds = getTextureAtlas()->getStats().mNumBinds;
+	drawElementBackgrounds(mLayerElements);
+	mBackgroundBinds += getTextureAtlas()->getStats().mNumBinds - atlasBinds;
+	for (unsigned int i = 0; i < mLayerElements.size(); i++) {
+		mVisibleElements[mLayerElements[i]]->draw();
+	}
+
+	// then the text they queued, one batch per font
+	flushGlyphAtlases();
+}
+
+bool UIController::hasDynamicElements( const Tile &aTile ) const
+{
+	for ( unsigned int i = 0; i < aTile.mElements.size(); i++ ) {
+		if ( !mStaticElements[aTile.mElements[i]] ) return true;
+	}
+	return false;
+}
+
+Area UIController::getTileRange( const Area &aBounds ) const
+{
+	// strokes are centered on an element's edge, so they reach a little past its bounds
+	const int margin = (int)ceilf( 2.0f * mRenderScale );
+	return Area( math<int>::clamp( ( aBounds.x1 - margin ) / DEFAULT_TILE_SIZE, 0, mTileColumns - 1 ),
+		math<int>::clamp( ( aBounds.y1 - margin ) / DEFAULT_TILE_SIZE, 0, mTileRows - 1 ),
+		math<int>::clamp( ( aBounds.x2 + margin ) / DEFAULT_TILE_SIZE, 0, mTileColumns - 1 ),
+		math<int>::clamp( ( aBounds.y2 + margin ) / DEFAULT_TILE_SIZE, 0, mTileRows - 1 ) );
+}
+
+void UIController::buildTileIndex()
+{
+	mTileIndexDirty = false;
+	invalidateLayers();
+	for ( unsigned int i = 0; i < mTiles.size(); i++ ) {
+		mTiles[i].mElements.clear();
 	}
-	// reset the matrices and blending
-	gl::setViewport( toPixels( getWindow()->getBounds() ) );
-	gl::setMatricesWindow( toPixels( getWindow()->getSize() ) );
+
+	mStaticElements.resize( mVisibleElements.size() );
+	for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+		mStaticElements[i] = mVisibleElements[i]->isStatic();
+		mVisibleElements[i]->mLayerDirty = false;
+	}
+	if ( mTiles.empty() ) return;
+
+	for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+		const Area range = getTileRange( mVisibleElements[i]->getBounds() );
+		for ( int y = range.y1; y <= range.y2; y++ ) {
+			for ( int x = range.x1; x <= range.x2; x++ ) {
+				mTiles[y * mTileColumns + x].mElements.push_back( i );
+			}
+		}
+	}
+}
+
+void UIController::updateLayers()
+{
+	for ( unsigned int i = 0; i < mVisibleElements.size(); i++ ) {
+		UIElement *element = mVisibleElements[i];
+		const bool isStatic = element->isStatic();
+		// an element that became dynamic has to come out of the cached layer, one that became static has to go in
+		if ( isStatic != mStaticElements[i] || ( isStatic && element->mLayerDirty ) ) {
+			mStaticElements[i] = isStatic;
+			if ( mTiles.empty() ) continue;
+			const Area range = getTileRange( element->getBounds() );
+			for ( int y = range.y1; y <= range.y2; y++ ) {
+				for ( int x = range.x1; x <= range.x2; x++ ) {
+					mTiles[y * mTileColumns + x].mStale = true;
+				}
+			}
+		}
+		element->mLayerDirty = false;
+	}
+}
+
+void UIController::invalidateLayers()
+{
+	for ( unsigned int i = 0; i < mTiles.size(); i++ ) {
+		mTiles[i].mStale = true;
+	}
+}
+
+void UIController::fontChanged()
+{
+	// drawLabel() rasterizes a cleared name again as it bakes the layer; hidden elements render theirs when shown
+	{
+		unique_lock<mutex> lock = lockModelIfThreaded();
+		for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+			if ( mUIElements[i]->getNameTexture() ) mUIElements[i]->setNameTexture( gl::Texture() );
+		}
+	}
+	invalidateLayers();
+}
+
+Area UIController::getVisibleArea() const
+{
+	// in the panel's own window
+	const Area window = mWindow->getBounds();
+	int x1 = math<int>::max( window.x1 - mPosition.x, 0 ), y1 = math<int>::max( window.y1 - mPosition.y, 0 );
+	int x2 = math<int>::min( window.x2 - mPosition.x, mBounds.x2 ), y2 = math<int>::min( window.y2 - mPosition.y, mBounds.y2 );
+
+	// and in each mirror, mapped back through its destination
+	for ( unsigned int i = 0; i < mMirrors.size(); i++ ) {
+		const Rectf destination = getDestination( mMirrors[i]->mWindow );
+		const Area bounds = mMirrors[i]->mWindow->getBounds();
+		const Vec2f ul = fromMirror( *mMirrors[i], Vec2f( math<float>::max( bounds.x1, destination.x1 ), math<float>::max( bounds.y1, destination.y1 ) ) ) - Vec2f( mPosition );
+		const Vec2f lr = fromMirror( *mMirrors[i], Vec2f( math<float>::min( bounds.x2, destination.x2 ), math<float>::min( bounds.y2, destination.y2 ) ) ) - Vec2f( mPosition );
+		if ( lr.x <= ul.x || lr.y <= ul.y ) continue;
+		if ( x2 <= x1 || y2 <= y1 ) {
+			x1 = (int)floorf( ul.x ); y1 = (int)floorf( ul.y ); x2 = (int)ceilf( lr.x ); y2 = (int)ceilf( lr.y );
+		} else {
+			x1 = math<int>::min( x1, (int)floorf( ul.x ) ); y1 = math<int>::min( y1, (int)floorf( ul.y ) );
+			x2 = math<int>::max( x2, (int)ceilf( lr.x ) ); y2 = math<int>::max( y2, (int)ceilf( lr.y ) );
+		}
+	}
+	return Area( x1, y1, x2, y2 );
+}
+
+void UIController::composite()
+{
+	ScopedTimer timer( mDrawTime );
+
+	// reset the blending
 	gl::enableAlphaBlending( true );
 
 	// if forcing interaction, draw an overlay over the whole window
+	const WindowRef window = app::getWindow();
 	if ( mForceInteraction ) {
 		gl::color(ColorA( 0.0f, 0.0f, 0.0f, 0.5f * mAlpha));
-		gl::drawSolidRect( toPixels( getWindow()->getBounds() ) );
+		gl::drawSolidRect( toPixels( window->getBounds() ) );
 	}
 
-	// draw the FBO to the screen
+	// draw the tiles to the screen, each where its part of the panel goes; tiles that were never on screen aren't there
 	gl::color( ColorA( mAlpha, mAlpha, mAlpha, mAlpha ) );
-	gl::draw( mFbo.getTexture() );
+	const Rectf destination = getDestination( window );
+	const float scaleX = destination.getWidth() / mPixelSize.x, scaleY = destination.getHeight() / mPixelSize.y;
+	for ( unsigned int i = 0; i < mTiles.size(); i++ ) {
+		Tile &tile = mTiles[i];
+		if ( !tile.mFbo ) continue;
+		const Rectf rect( destination.x1 + tile.mArea.x1 * scaleX, destination.y1 + tile.mArea.y1 * scaleY, destination.x1 + tile.mArea.x2 * scaleX, destination.y1 + tile.mArea.y2 * scaleY );
+		gl::draw( tile.mFbo.getTexture(), toPixels( rect ) );
+	}
 	gl::disableAlphaBlending();
-	
-	// restore state
-	glPopAttrib();
-	gl::popMatrices();
+}
+
+void UIController::addWindow( WindowRef aWindow, const Rectf &aDestination )
+{
+	if ( aWindow == mWindow ) return;
+	removeWindow( aWindow );
+
+	unique_ptr<Mirror> mirror( new Mirror );
+	mirror->mWindow = aWindow;
+	mirror->mDestination = aDestination;
+	const Mirror *m = mirror.get();
+	mirror->mCbMouseDown = aWindow->getSignalMouseDown().connect( mDepth, [this, m]( MouseEvent &event ) { mirrorMouse( *m, event, &UIController::mouseDown ); } );
+	mirror->mCbMouseUp = aWindow->getSignalMouseUp().connect( mDepth, [this, m]( MouseEvent &event ) { mirrorMouse( *m, event, &UIController::mouseUp ); } );
+	mirror->mCbMouseDrag = aWindow->getSignalMouseDrag().connect( mDepth, [this, m]( MouseEvent &event ) { mirrorMouse( *m, event, &UIController::mouseDrag ); } );
+	mirror->mCbTouchesBegan = aWindow->getSignalTouchesBegan().connect( mDepth, [this, m]( TouchEvent &event ) { mirrorTouches( *m, event, &UIController::touchesBegan ); } );
+	mirror->mCbTouchesMoved = aWindow->getSignalTouchesMoved().connect( mDepth, [this, m]( TouchEvent &event ) { mirrorTouches( *m, event, &UIController::touchesMoved ); } );
+	mirror->mCbTouchesEnded = aWindow->getSignalTouchesEnded().connect( mDepth, [this, m]( TouchEvent &event ) { mirrorTouches( *m, event, &UIController::touchesEnded ); } );
+	mirror->mCbClose = aWindow->getSignalClose().connect( [this, aWindow]() { removeWindow( aWindow ); } );
+	mMirrors.push_back( std::move( mirror ) );
+}
+
+void UIController::removeWindow( WindowRef aWindow )
+{
+	for ( unsigned int i = 0; i < mMirrors.size(); i++ ) {
+		if ( mMirrors[i]->mWindow == aWindow ) {
+			mMirrors.erase( mMirrors.begin() + i );
+			return;
+		}
+	}
+}
+
+void UIController::setWindowDestination( WindowRef aWindow, const Rectf &aDestination )
+{
+	for ( unsigned int i = 0; i < mMirrors.size(); i++ ) {
+		if ( mMirrors[i]->mWindow == aWindow ) mMirrors[i]->mDestination = aDestination;
+	}
+}
+
+Rectf UIController::getDestination( const WindowRef &aWindow ) const
+{
+	for ( unsigned int i = 0; i < mMirrors.size(); i++ ) {
+		if ( mMirrors[i]->mWindow == aWindow && mMirrors[i]->mDestination.getWidth() > 0.0f && mMirrors[i]->mDestination.getHeight() > 0.0f ) return mMirrors[i]->mDestination;
+	}
+	return Rectf( mBounds + mPosition );
+}
+
+Vec2f UIController::fromMirror( const Mirror &aMirror, const Vec2f &aPos ) const
+{
+	const Rectf destination = getDestination( aMirror.mWindow );
+	const float x = ( aPos.x - destination.x1 ) * mBounds.getWidth() / destination.getWidth();
+	const float y = ( aPos.y - destination.y1 ) * mBounds.getHeight() / destination.getHeight();
+	return Vec2f( x, y ) + Vec2f( mPosition );
+}
+
+void UIController::mirrorMouse( const Mirror &aMirror, MouseEvent &event, void ( UIController::*aHandler )( MouseEvent & ) )
+{
+	// the panel sees the event as if it happened at the same place on the panel in its own window
+	MouseEvent mapped( event );
+	mapped.setPos( Vec2i( fromMirror( aMirror, Vec2f( event.getPos() ) ) ) );
+	( this->*aHandler )( mapped );
+	if ( mapped.isHandled() ) event.setHandled();
+}
+
+void UIController::mirrorTouches( const Mirror &aMirror, TouchEvent &event, TouchHandler aHandler )
+{
+	const vector<TouchEvent::Touch> &touches = event.getTouches();
+	TouchPoint batch[MAX_TOUCHES];
+	for ( size_t first = 0; first < touches.size(); first += MAX_TOUCHES ) {
+		const size_t count = math<size_t>::min( touches.size() - first, (size_t)MAX_TOUCHES );
+		for ( size_t i = 0; i < count; i++ ) {
+			batch[i].mId = touches[first + i].getId();
+			batch[i].mPos = fromMirror( aMirror, touches[first + i].getPos() );
+		}
+		( this->*aHandler )( batch, count );
+	}
 }
 
 void UIController::update()
 {
-	if ( !mVisible )
+	// the previous frame's timings are complete now
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	mFrameTime = chrono::duration<float, milli>( now - mLastFrame ).count();
+	mLastFrame = now;
+	mLastUpdateTime = mUpdateTime;
+	mLastDrawTime = mDrawTime;
+	if ( mStatsOverlay ) {
+		mStatsOverlay->addSample( mFrameTime, mLastUpdateTime, mLastDrawTime );
+	}
+	mUpdateTime = mDrawTime = 0.0f;
+	ScopedTimer timer( mUpdateTime );
+
+	if ( mInputCapture ) mInputCapture->frame();
+
+	// GL resources are released here, on the main thread, between steps
+	if ( !mVisible && mMaterialized && mIdleRelease > 0.0 && getElapsedSeconds() - mHiddenSince >= mIdleRelease ) {
+		unique_lock<mutex> lock( mModelMutex, defer_lock );
+		if ( !mThreaded || mSynchronous || lock.try_lock() ) releaseResources();
+	}
+
+	if ( mThreaded && !mSynchronous ) {
+		// a step still running when the next frame starts is followed by one more, not one per frame it missed
+		{
+			lock_guard<mutex> lock( mStepMutex );
+			mStepRequested = true;
+		}
+		mStepCondition.notify_one();
 		return;
+	}
+	step();
+}
+
+void UIController::step()
+{
+	// hardware controllers first, so their values are seen by everything below this frame
+	applyExternalInput();
+
+	// automation events are applied here, even while hidden: on the main thread, or a threaded panel's model thread
+	if ( mPlayer ) {
+		mPlayer->update();
+	}
+
+	// other processes and remote viewers need values whether or not the panel is visible
+	if ( mBridge ) {
+		mBridge->publish();
+	}
+	if ( mReplication ) {
+		mReplication->publish();
+	}
+
+	if ( !mVisible ) return;
+
+	if ( mLayoutDirty ) layout();
+
+	// the model thread has the time to update every step
+	if ( mThreaded || getElapsedFrames() % DEFAULT_UPDATE_FREQUENCY == 0 || mExternalRefresh ) {
+		for (unsigned int i = 0; i < mVisibleElements.size(); i++) {
+			mVisibleElements[i]->update();
+		}
+	}
+}
+
+void UIController::modelThread()
+{
+	for ( ;; ) {
+		{
+			unique_lock<mutex> lock( mStepMutex );
+			mStepCondition.wait( lock, [this] { return mStepRequested || mStopping; } );
+			if ( mStopping ) return;
+			mStepRequested = false;
+		}
+		{
+			lock_guard<mutex> lock( mModelMutex );
+			processInput();
+			step();
+		}
+		mGeneration++;
+	}
+}
+
+bool UIController::queueInput( const ModelInput::Type &aType, const Vec2f &aPos, const uint32_t &aId, const bool &aRight )
+{
+	if ( !mThreaded || mSynchronous || onModelThread() ) return false;
+	// dropped if the model has fallen that far behind
+	ModelInput input = { aType, aPos, aId, aRight };
+	mModelInput.push( input );
+	return true;
+}
+
+unique_lock<mutex> UIController::lockModelIfThreaded()
+{
+	unique_lock<mutex> lock( mModelMutex, defer_lock );
+	if ( mThreaded && !mSynchronous && !onModelThread() ) lock.lock();
+	return lock;
+}
 
-	if ( getElapsedFrames() % DEFAULT_UPDATE_FREQUENCY == 0 ) {
-		for (unsigned int i = 0; i < mUIElements.size(); i++) {
-			mUIElements[i]->update();
+void UIController::processInput()
+{
+	// consecutive touches of one kind are handed on together, as the batch they most likely arrived in
+	const TouchHandler began = &UIController::touchesBegan, moved = &UIController::touchesMoved, ended = &UIController::touchesEnded;
+	TouchPoint batch[MAX_TOUCHES];
+	size_t count = 0;
+	TouchHandler handler = nullptr;
+	ModelInput input;
+	for ( ;; ) {
+		const bool more = mModelInput.pop( input );
+		TouchHandler next = nullptr;
+		if ( more && input.mType == ModelInput::TOUCHES_BEGAN ) next = began;
+		else if ( more && input.mType == ModelInput::TOUCHES_MOVED ) next = moved;
+		else if ( more && input.mType == ModelInput::TOUCHES_ENDED ) next = ended;
+		if ( count > 0 && ( next != handler || count == MAX_TOUCHES ) ) {
+			( this->*handler )( batch, count );
+			count = 0;
+		}
+		if ( !more ) break;
+
+		if ( next ) {
+			handler = next;
+			batch[count].mId = input.mId;
+			batch[count].mPos = input.mPos;
+			count++;
+			continue;
 		}
+		const int button = input.mRight ? MouseEvent::RIGHT_DOWN : MouseEvent::LEFT_DOWN;
+		MouseEvent event( mWindow, button, (int)input.mPos.x, (int)input.mPos.y, button, 0.0f, 0 );
+		if ( input.mType == ModelInput::MOUSE_DOWN ) mouseDown( event );
+		else if ( input.mType == ModelInput::MOUSE_UP ) mouseUp( event );
+		else mouseDrag( event );
 	}
 }
 
 void UIController::show()
 {
-	mVisible = true;
+	// a threaded panel's step reads mVisible and its elements, so both change between steps
+	{
+		unique_lock<mutex> lock = lockModelIfThreaded();
+		materialize();
+		mVisible = true;
+	}
 	timeline().apply( &mAlpha, 1.0f, 0.25f );
 }
 
 void UIController::hide()
 {
-	timeline().apply( &mAlpha, 0.0f, 0.25f ).finishFn( [&]{ mVisible = false; } );
+	timeline().apply( &mAlpha, 0.0f, 0.25f ).finishFn( [&] {
+		unique_lock<mutex> lock = lockModelIfThreaded();
+		mVisible = false;
+		mHiddenSince = getElapsedSeconds();
+	} );
+}
+
+void UIController::materialize()
+{
+	if ( mMaterialized ) return;
+	mMaterialized = true;
+
+	setupTiles();
+	if ( mPendingBackground ) mBackgroundRegion = mPendingBackground.pack( *getTextureAtlas() );
+	for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+		mUIElements[i]->materialize();
+	}
+}
+
+void UIController::prewarm()
+{
+	if ( mMaterialized ) return;
+	mPendingBackground.prewarm();
+	for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+		mUIElements[i]->prewarm();
+	}
+}
+
+void UIController::releaseResources()
+{
+	if ( !mMaterialized ) return;
+	mMaterialized = false;
+
+	// images stay in the atlas, which is shared and packed once; everything else is made again on show()
+	mTiles.clear();
+	for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+		mUIElements[i]->releaseResources();
+	}
+}
+
+void UIController::startRecording( const string &aPath )
+{
+	AutomationRecorderRef recorder = AutomationRecorder::create( aPath );
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	mRecorder = recorder;
+}
+
+void UIController::stopRecording()
+{
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	if ( mRecorder ) {
+		mRecorder->stop();
+		mRecorder.reset();
+	}
+}
+
+void UIController::startInputCapture( const string &aPath )
+{
+	stopInputCapture();
+	mInputCapture = InputCapture::create( this, aPath );
+}
+
+void UIController::stopInputCapture()
+{
+	if ( mInputCapture ) {
+		mInputCapture->stop();
+		mInputCapture.reset();
+	}
+}
+
+InputReplayer::Report UIController::replayInput( const string &aPath, const double &aSpeed )
+{
+	// don't capture the replay itself
+	stopInputCapture();
+	InputReplayer replayer( this, aPath );
+
+	// a threaded panel's model is stepped on this thread for the replay, so input is handled when it's replayed,
+	// rather than queued, and the final values are read after the last step
+	unique_lock<mutex> lock( mModelMutex, defer_lock );
+	if ( mThreaded ) {
+		lock.lock();
+		processInput();
+		mSynchronous = true;
+	}
+	mInputReplayer = &replayer;
+	InputReplayer::Report report = replayer.run( aSpeed );
+	mInputReplayer = nullptr;
+	if ( mThreaded ) {
+		mSynchronous = false;
+		mGeneration++;
+	}
+	return report;
+}
+
+void UIController::startPlayback( const string &aPath, const double &aRate )
+{
+	stopPlayback();
+	AutomationPlayerRef player = AutomationPlayer::create( this, aPath );
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	mPlayer = player;
+	mPlayer->start( aRate );
+}
+
+void UIController::stopPlayback()
+{
+	// the player's events are applied by step(), so it's only swapped out between steps
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	if ( mPlayer ) {
+		mPlayer->stop();
+		// what's left is applied now, unless that would make the main thread a second reader of the player's queue
+		if ( !mThreaded || !lock.owns_lock() ) mPlayer->update();
+		mPlayer.reset();
+	}
+}
+
+bool UIController::startBridge( const string &aName )
+{
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	mBridge = ParamBridge::create( this, aName );
+	return (bool)mBridge;
+}
+
+void UIController::stopBridge()
+{
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	mBridge.reset();
+}
+
+bool UIController::startReplication( const uint16_t &aPort, const string &aAddress )
+{
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	mReplication = ReplicationServer::create( this, aPort, aAddress );
+	return (bool)mReplication;
+}
+
+void UIController::stopReplication()
+{
+	unique_lock<mutex> lock = lockModelIfThreaded();
+	mReplication.reset();
+}
+
+void UIController::valueChanged( UIElement *aElement, const int &aChannel, const float &aValue )
+{
+	if ( mRecorder ) {
+		mRecorder->record( aElement->getId(), aChannel, aValue );
+	}
+	if ( mInputReplayer ) {
+		mInputReplayer->valueChanged( aElement->getId() );
+	}
+}
+
+void UIController::beginGesture( UIElement *aElement )
+{
+	endGesture( aElement );
+	Gesture *gesture = nullptr;
+	for ( unsigned int i = 0; i < mGestures.size() && !gesture; i++ ) {
+		if ( !mGestures[i].mElement ) gesture = &mGestures[i];
+	}
+	if ( !gesture ) return;
+	gesture->mElement = aElement;
+	gesture->mValues.clear();
+
+	// exclusive button groups change their siblings too, so capture the whole group
+	const string &group = aElement->getGroup();
+	for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+		UIElement *element = mUIElements[i].get();
+		if ( element != aElement && ( group.empty() || element->getGroup() != group ) ) continue;
+		for ( int channel = 0; channel < element->getNumValues(); channel++ ) {
+			UndoJournal::Entry entry;
+			entry.mElementId = element->getId();
+			entry.mChannel = channel;
+			entry.mStepStart = false;
+			entry.mBefore = element->getValue( channel );
+			entry.mAfter = entry.mBefore;
+			gesture->mValues.push_back( entry );
+		}
+	}
+}
+
+void UIController::endGesture( UIElement *aElement )
+{
+	Gesture *gesture = nullptr;
+	for ( unsigned int i = 0; i < mGestures.size() && !gesture; i++ ) {
+		if ( mGestures[i].mElement == aElement ) gesture = &mGestures[i];
+	}
+	if ( !gesture )
+		return;
+
+	// each gesture is its own undo step, even when several overlap
+	bool stepStart = true;
+	for ( unsigned int i = 0; i < gesture->mValues.size(); i++ ) {
+		UndoJournal::Entry &entry = gesture->mValues[i];
+		entry.mAfter = mUIElements[entry.mElementId]->getValue( entry.mChannel );
+		if ( entry.mAfter != entry.mBefore ) {
+			entry.mStepStart = stepStart;
+			stepStart = false;
+			mUndoJournal->push( entry );
+		}
+	}
+	gesture->mElement = nullptr;
+	gesture->mValues.clear();
 }
 
-UIElementRef UIController::addSlider( const string &aName, float *aValueToLink, const string &aParamString )
+ExternalInputRef UIController::getExternalInput()
 {
-	UIElementRef sliderRef = Slider::create( this, aName, aValueToLink, aParamString );
+	if ( !mExternalInput ) mExternalInput = ExternalInput::create();
+	return mExternalInput;
+}
+
+void UIController::applyExternalInput()
+{
+	if ( !mExternalInput ) return;
+
+	// a fader sends far more often than we update and only its latest position matters, but every button press counts
+	mExternalEvents.clear();
+	ExternalInputEvent event;
+	while ( mExternalInput->pop( event ) ) {
+		UIElementRef element = getElement( event.mElementId );
+		if ( !element || event.mChannel >= element->getNumValues() ) continue;
+		bool merged = false;
+		if ( element->hasContinuousValues() ) {
+			for ( unsigned int i = 0; i < mExternalEvents.size() && !merged; i++ ) {
+				if ( mExternalEvents[i].mElementId == event.mElementId && mExternalEvents[i].mChannel == event.mChannel ) {
+					mExternalEvents[i].mValue = event.mValue;
+					merged = true;
+				}
+			}
+		}
+		if ( !merged ) mExternalEvents.push_back( event );
+	}
+
+	// applied like the mouse: each button press is an undo step, and so is each fader movement, once it stops
+	const double now = getElapsedSeconds();
+	for ( unsigned int i = 0; i < mExternalEvents.size(); i++ ) {
+		const ExternalInputEvent &input = mExternalEvents[i];
+		UIElement *element = mUIElements[input.mElementId].get();
+		// the mouse or a touch holding the element wins
+		if ( element->isLocked() || element->isActive() ) continue;
+		if ( element->hasContinuousValues() ) {
+			ExternalGesture *gesture = nullptr;
+			for ( unsigned int j = 0; j < mExternalGestures.size() && !gesture; j++ ) {
+				if ( mExternalGestures[j].mElement == element ) gesture = &mExternalGestures[j];
+			}
+			if ( !gesture ) {
+				beginGesture( element );
+				ExternalGesture started = { element, now };
+				mExternalGestures.push_back( started );
+			} else {
+				gesture->mLastInput = now;
+			}
+			element->handleExternalValue( input.mChannel, input.mValue );
+		} else {
+			beginGesture( element );
+			element->handleExternalValue( input.mChannel, input.mValue );
+			endGesture( element );
+		}
+		mExternalRefresh = true;
+	}
+
+	for ( unsigned int i = 0; i < mExternalGestures.size(); ) {
+		UIElement *element = mExternalGestures[i].mElement;
+		if ( element->isActive() ) {
+			// the mouse or a touch took over the element, and its gesture replaced ours
+			mExternalGestures.erase( mExternalGestures.begin() + i );
+		} else if ( now - mExternalGestures[i].mLastInput >= EXTERNAL_GESTURE_TIMEOUT ) {
+			endGesture( element );
+			mExternalGestures.erase( mExternalGestures.begin() + i );
+		} else {
+			i++;
+		}
+	}
+}
+
+void UIController::applyJournalEntry( const UndoJournal::Entry &aEntry, const bool &aUndo )
+{
+	UIElementRef element = getElement( aEntry.mElementId );
+	if ( element ) {
+		float value = aUndo ? aEntry.mBefore : aEntry.mAfter;
+		element->setValue( aEntry.mChannel, value );
+		valueChanged( element.get(), aEntry.mChannel, value );
+	}
+}
+
+bool UIController::undo()
+{
+	return mUndoJournal->undo( std::bind( &UIController::applyJournalEntry, this, std::placeholders::_1, true ) );
+}
+
+bool UIController::redo()
+{
+	return mUndoJournal->redo( std::bind( &UIController::applyJournalEntry, this, std::placeholders::_1, false ) );
+}
+
+void UIController::addElement( const UIElementRef &aElement )
+{
+	aElement->setSection( mSectionStack.empty() ? nullptr : mSectionStack.back() );
+	mUIElements.push_back( aElement );
+	addLayoutOp( LayoutOp::ELEMENT, aElement.get(), Vec2i::zero() );
+
+	if ( aElement->isHidden() ) {
+		// it was positioned as if it were visible; move everything after it back up
+		aElement->releaseNameTexture();
+		mLayoutDirty = true;
+	} else {
+		mVisibleElements.push_back( aElement.get() );
+		mIndexDirty = mTileIndexDirty = true;
+	}
+}
+
+void UIController::addLayoutOp( const LayoutOp::Type &aType, UIElement *aElement, const Vec2i &aOffset )
+{
+	LayoutOp op;
+	op.mType = aType;
+	op.mSection = mSectionStack.empty() ? nullptr : mSectionStack.back();
+	op.mElement = aElement;
+	op.mOffset = aOffset;
+	mLayoutOps.push_back( op );
+}
+
+void UIController::addSeparator()
+{
+	addLayoutOp( LayoutOp::SEPARATOR, nullptr, Vec2i::zero() );
+	mInsertPosition.x = mMarginLarge;
+	mInsertPosition.y += mMarginLarge;
+}
+
+void UIController::offsetInsertPosition( const Vec2i &offset )
+{
+	addLayoutOp( LayoutOp::OFFSET, nullptr, offset );
+	mInsertPosition += offset;
+}
+
+void UIController::resetInsertPosition( const int &offsetY )
+{
+	addLayoutOp( LayoutOp::RESET, nullptr, Vec2i( 0, offsetY ) );
+	mInsertPosition = Vec2i( mMarginLarge, mInsertPosition.y + offsetY );
+}
+
+void UIController::advanceInsertPosition( const Vec2i &aSize, const bool &aClear )
+{
+	if ( aClear ) {
+		mInsertPosition = Vec2i( mMarginLarge, mInsertPosition.y + aSize.y + DEFAULT_MARGIN_SMALL );
+	} else {
+		mInsertPosition += Vec2i( aSize.x + DEFAULT_MARGIN_SMALL, 0 );
+	}
+}
+
+UIElementRef UIController::addSection( const string &aName, const Params &aParams )
+{
+	UIElementRef sectionRef = Section::create( this, aName, aParams );
+	addElement( sectionRef );
+	mSectionStack.push_back( static_cast<Section *>( sectionRef.get() ) );
+	return sectionRef;
+}
+
+void UIController::endSection()
+{
+	if ( !mSectionStack.empty() ) mSectionStack.pop_back();
+}
+
+void UIController::sectionToggled( Section *aSection )
+{
+	// only the toggled subtree pays for text rendering; everything else is just moved
+	for ( unsigned int i = 0; i < mUIElements.size(); i++ ) {
+		UIElement *element = mUIElements[i].get();
+		bool inSubtree = false;
+		for ( Section *section = element->getSection(); section; section = section->getSection() ) {
+			if ( section == aSection ) { inSubtree = true; break; }
+		}
+		if ( !inSubtree ) continue;
+
+		if ( aSection->isCollapsed() ) {
+			element->releaseNameTexture();
+		} else if ( !element->isHidden() ) {
+			element->renderNameTexture();
+		}
+	}
+
+	// defer the layout, since this is called while elements are being iterated
+	mLayoutDirty = true;
+}
+
+void UIController::layout()
+{
+	mInsertPosition = Vec2i( mMarginLarge, mMarginLarge );
+	mVisibleElements.clear();
+	mIndexDirty = mTileIndexDirty = true;
+
+	for ( unsigned int i = 0; i < mLayoutOps.size(); i++ ) {
+		const LayoutOp &op = mLayoutOps[i];
+		bool hidden = false;
+		for ( Section *section = op.mSection; section; section = section->getSection() ) {
+			if ( section->isCollapsed() ) { hidden = true; break; }
+		}
+		if ( hidden ) continue;
+
+		switch ( op.mType ) {
+			case LayoutOp::ELEMENT:
+				op.mElement->relayout();
+				mVisibleElements.push_back( op.mElement );
+				break;
+			case LayoutOp::SEPARATOR:
+				mInsertPosition.x = mMarginLarge;
+				mInsertPosition.y += mMarginLarge;
+				break;
+			case LayoutOp::OFFSET:
+				mInsertPosition += op.mOffset;
+				break;
+			case LayoutOp::RESET:
+				mInsertPosition = Vec2i( mMarginLarge, mInsertPosition.y + op.mOffset.y );
+				break;
+		}
+	}
+	mLayoutDirty = false;
+}
+
+UIElementRef UIController::addSlider( const string &aName, float *aValueToLink, const Params &aParams )
+{
+	UIElementRef sliderRef = Slider::create( this, aName, aValueToLink, aParams );
 	addElement( sliderRef );
 	return sliderRef;
 }
 
-UIElementRef UIController::addButton( const string &aName, const function<void( bool )> &aEventHandler, const string &aParamString )
+UIElementRef UIController::addButton( const string &aName, const function<void( bool )> &aEventHandler, const Params &aParams )
 {
-	UIElementRef buttonRef = Button::create( this, aName, aEventHandler, aParamString );
+	UIElementRef buttonRef = Button::create( this, aName, aEventHandler, aParams );
 	addElement( buttonRef );
 	return buttonRef;
 }
 
-UIElementRef UIController::addLinkedButton( const string &aName, const function<void( bool )> &aEventHandler, bool *aLinkedState, const string &aParamString )
+UIElementRef UIController::addLinkedButton( const string &aName, const function<void( bool )> &aEventHandler, bool *aLinkedState, const Params &aParams )
 {
-	UIElementRef linkedButtonRef = LinkedButton::create( this, aName, aEventHandler, aLinkedState, aParamString );
+	UIElementRef linkedButtonRef = LinkedButton::create( this, aName, aEventHandler, aLinkedState, aParams );
 	addElement( linkedButtonRef );
 	return linkedButtonRef;
 }
 
-UIElementRef UIController::addLabel( const string &aName, const string &aParamString )
+UIElementRef UIController::addLabel( const string &aName, const Params &aParams )
 {
-	UIElementRef labelRef = Label::create( this, aName, aParamString );
+	UIElementRef labelRef = Label::create( this, aName, aParams );
 	addElement( labelRef );
 	return labelRef;
 }
 
-UIElementRef UIController::addImage( const string &aName, ImageSourceRef aImage, const string &aParamString )
+UIElementRef UIController::addImage( const string &aName, ImageSourceRef aImage, const Params &aParams )
 {
-	UIElementRef imageRef = Image::create( this, aName, aImage, aParamString );
+	UIElementRef imageRef = Image::create( this, aName, aImage, aParams );
 	addElement( imageRef );
 	return imageRef;
 }
 
-UIElementRef UIController::addSlider2D( const string &aName, Vec2f *aValueToLink, const string &aParamString )
+UIElementRef UIController::addSlider2D( const string &aName, Vec2f *aValueToLink, const Params &aParams )
 {
-	UIElementRef slider2DRef = Slider2D::create( this, aName, aValueToLink, aParamString );
+	UIElementRef slider2DRef = Slider2D::create( this, aName, aValueToLink, aParams );
 	addElement( slider2DRef );
 	return slider2DRef;
 }
 
-UIElementRef UIController::addSliderCallback( const std::string &aName, float *aValueToLink, const std::function<void ()> &aEventHandler, const std::string &aParamString )
+UIElementRef UIController::addSliderCallback( const std::string &aName, float *aValueToLink, const std::function<void ()> &aEventHandler, const Params &aParams )
 {
-	UIElementRef sliderCallbackRef = SliderCallback::create( this, aName, aValueToLink, aEventHandler, aParamString );
+	UIElementRef sliderCallbackRef = SliderCallback::create( this, aName, aValueToLink, aEventHandler, aParams );
 	addElement( sliderCallbackRef );
 	return sliderCallbackRef;
 }
 
-UIElementRef UIController::addToggleSlider( const string &aSliderName, float *aValueToLink, const string &aButtonName, const function<void (bool)> &aEventHandler, const string &aSliderParamString, const string &aButtonParamString )
+UIElementRef UIController::addToggleSlider( const string &aSliderName, float *aValueToLink, const string &aButtonName, const function<void (bool)> &aEventHandler, const Params &aSliderParams, const Params &aButtonParams )
 {
 	// create the slider
-	UIElementRef toggleSliderRef = Slider::create( this, aSliderName, aValueToLink, aSliderParamString );
+	UIElementRef toggleSliderRef = Slider::create( this, aSliderName, aValueToLink, aSliderParams );
 
 	// add the slider to the controller
 	addElement( toggleSliderRef );
 
 	// create the button
-	UIElementRef newButtonRef = Button::create( this, aButtonName, aEventHandler, aButtonParamString );
+	UIElementRef newButtonRef = Button::create( this, aButtonName, aEventHandler, aButtonParams );
 
 	// add an additional event handler to link the button to the slider
 	std::shared_ptr<class Button> newButton = std::static_pointer_cast<class Button>(newButtonRef);
@@ -305,22 +1518,69 @@ UIElementRef UIController::addToggleSlider( const string &aSliderName, float *aV
 }
 
 // without event handler
-UIElementRef UIController::addMovingGraph(const string &aName, float *aValueToLink, const string &aParamString)
+UIElementRef UIController::addImageSequence( const string &aName, const vector<string> &aPaths, const Params &aParams )
 {
-	UIElementRef movingGraphRef = MovingGraph::create(this, aName, aValueToLink, aParamString);
+	UIElementRef imageSequenceRef = ImageSequence::create( this, aName, aPaths, aParams );
+	addElement( imageSequenceRef );
+	return imageSequenceRef;
+}
+
+UIElementRef UIController::addMovingGraph(const string &aName, float *aValueToLink, const Params &aParams)
+{
+	UIElementRef movingGraphRef = MovingGraph::create(this, aName, aValueToLink, aParams);
 	addElement(movingGraphRef);
 	return movingGraphRef;
 }
 
 // with event handler
 // note: this would be an overloaded addMovingGraph function for consistency, were it not for a visual studio compiler defect (see http://cplusplus.github.io/LWG/lwg-active.html#2132)
-UIElementRef UIController::addMovingGraphButton(const string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const string &aParamString)
+UIElementRef UIController::addMovingGraphButton(const string &aName, float *aValueToLink, const std::function<void(bool)>& aEventHandler, const Params &aParams)
 {
-	UIElementRef movingGraphRef = MovingGraph::create(this, aName, aValueToLink, aEventHandler, aParamString);
+	UIElementRef movingGraphRef = MovingGraph::create(this, aName, aValueToLink, aEventHandler, aParams);
 	addElement(movingGraphRef);
 	return movingGraphRef;
 }
 
+UIElementRef UIController::addMultiGraph( const string &aName, const Params &aParams )
+{
+	UIElementRef multiGraphRef = MultiGraph::create( this, aName, aParams );
+	addElement( multiGraphRef );
+	return multiGraphRef;
+}
+
+UIElementRef UIController::addHistogram( const string &aName, const Params &aParams )
+{
+	UIElementRef histogramRef = Histogram::create( this, aName, aParams );
+	addElement( histogramRef );
+	return histogramRef;
+}
+
+UIElementRef UIController::addScatterPlot( const string &aName, const Params &aParams )
+{
+	UIElementRef scatterPlotRef = ScatterPlot::create( this, aName, aParams );
+	addElement( scatterPlotRef );
+	return scatterPlotRef;
+}
+
+UIElementRef UIController::addStatsOverlay( const string &aName, const Params &aParams )
+{
+	UIElementRef statsRef = StatsOverlay::create( this, aName, aParams );
+	addElement( statsRef );
+	mStatsOverlay = static_cast<StatsOverlay *>( statsRef.get() );
+
+	// the frame time graph is a plain MovingGraph, linked to the overlay's latest sample
+	const int width = statsRef->hasParam( "width" ) ? statsRef->getParam<int>( "width" ) : mWidth - mMarginLarge * 2;
+	addMovingGraph( aName, mStatsOverlay->getFrameTimeLink(), MovingGraphParams().min( 0.0 ).max( statsRef->hasParam( "graphMax" ) ? statsRef->getParam<double>( "graphMax" ) : 50.0 ).width( width ) );
+	return statsRef;
+}
+
+UIElementRef UIController::addHeatmap( const string &aName, const Params &aParams )
+{
+	UIElementRef heatmapRef = Heatmap::create( this, aName, aParams );
+	addElement( heatmapRef );
+	return heatmapRef;
+}
+
 void UIController::releaseGroup( const string &aGroup )
 {
 	for (unsigned int i = 0; i < mUIElements.size(); i++) {
@@ -362,6 +1622,23 @@ void UIController::setPressedByGroup( const std::string &aGroup, const bool &pre
 }
 
 Font UIController::getFont( const string &aStyle )
+{
+	if ( mManager ) {
+		return mManager->getFont( aStyle );
+	}
+
+	// fonts are set in points, and rasterized at the render scale
+	map<string, Font>::const_iterator it = mScaledFonts.find( aStyle );
+	if ( it != mScaledFonts.end() ) {
+		return it->second;
+	}
+	Font base = getBaseFont( aStyle );
+	Font scaled( base.getName(), base.getSize() * mRenderScale );
+	mScaledFonts[aStyle] = scaled;
+	return scaled;
+}
+
+Font UIController::getBaseFont( const string &aStyle ) const
 {
 	if ( aStyle == "label" ) {
 		return mLabelFont;
@@ -382,7 +1659,10 @@ Font UIController::getFont( const string &aStyle )
 
 void UIController::setFont( const string &aStyle, const ci::Font &aFont )
 {
-	if ( aStyle == "label" ) {
+	mScaledFonts.erase( aStyle );
+	if ( mManager ) {
+		mManager->setFont( aStyle, aFont );
+	} else if ( aStyle == "label" ) {
 		mLabelFont = aFont;
 	} else if ( aStyle == "icon" ) {
 		mIconFont = aFont;
@@ -397,14 +1677,81 @@ void UIController::setFont( const string &aStyle, const ci::Font &aFont )
 	} else {
 		throw FontStyleExc( aStyle );
 	}
+	if ( !mManager ) {
+		// readouts and overlays draw through the style's glyph atlas
+		map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.find( aStyle );
+		if ( it != mGlyphAtlases.end() ) it->second->setFont( getFont( aStyle ) );
+		// the manager does this for every panel it has
+		fontChanged();
+	}
+}
+
+GlyphAtlasRef UIController::getGlyphAtlas( const string &aStyle )
+{
+	if ( mManager ) {
+		return mManager->getGlyphAtlas( aStyle );
+	}
+	map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.find( aStyle );
+	if ( it != mGlyphAtlases.end() ) {
+		return it->second;
+	}
+	GlyphAtlasRef atlas = GlyphAtlas::create( getFont( aStyle ) );
+	mGlyphAtlases[aStyle] = atlas;
+	return atlas;
+}
+
+void UIController::flushGlyphAtlases()
+{
+	if ( mManager ) {
+		mManager->flushGlyphAtlases();
+		return;
+	}
+	for ( map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.begin(); it != mGlyphAtlases.end(); ++it ) {
+		it->second->flush();
+	}
 }
 
-void UIController::setupFbo()
+gl::Texture UIController::loadTexture( const string &aAssetPath )
+{
+	if ( mManager ) {
+		return mManager->loadTexture( aAssetPath );
+	}
+	return gl::Texture( loadImage( loadAsset( aAssetPath ) ) );
+}
+
+TextureAtlasRef UIController::getTextureAtlas()
+{
+	if ( mManager ) {
+		return mManager->getTextureAtlas();
+	}
+	if ( !mTextureAtlas ) mTextureAtlas = TextureAtlas::create();
+	return mTextureAtlas;
+}
+
+TextureAtlas::Region UIController::loadTextureRegion( const string &aAssetPath )
+{
+	TextureAtlasRef atlas = getTextureAtlas();
+	TextureAtlas::Region region = atlas->get( aAssetPath );
+	if ( !region ) region = atlas->add( loadImage( loadAsset( aAssetPath ) ), aAssetPath );
+	return region;
+}
+
+void UIController::setupTiles()
 {
 	mFormat.enableDepthBuffer( false );
 	mFormat.setSamples( mFboNumSamples );
-	mFbo = gl::Fbo( DEFAULT_FBO_WIDTH, DEFAULT_FBO_WIDTH, mFormat );
-	mFbo.bindFramebuffer();
-	gl::clear( ColorA( 0.0f, 0.0f, 0.0f, 0.0f ) );
-	mFbo.unbindFramebuffer();
+	mPixelSize = getPixelSize();
+	mTileColumns = ( mPixelSize.x + DEFAULT_TILE_SIZE - 1 ) / DEFAULT_TILE_SIZE;
+	mTileRows = ( mPixelSize.y + DEFAULT_TILE_SIZE - 1 ) / DEFAULT_TILE_SIZE;
+
+	mTiles.assign( mTileColumns * mTileRows, Tile() );
+	for ( int y = 0; y < mTileRows; y++ ) {
+		for ( int x = 0; x < mTileColumns; x++ ) {
+			Tile &tile = mTiles[y * mTileColumns + x];
+			tile.mArea = Area( x * DEFAULT_TILE_SIZE, y * DEFAULT_TILE_SIZE, math<int>::min( ( x + 1 ) * DEFAULT_TILE_SIZE, mPixelSize.x ), math<int>::min( ( y + 1 ) * DEFAULT_TILE_SIZE, mPixelSize.y ) );
+			tile.mStale = true;
+			tile.mOutdated = false;
+		}
+	}
+	mTileIndexDirty = true;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "UIElement.h"
 #include "UIController.h"
+#include "Section.h"
 
 using namespace ci;
 using namespace ci::app;
@@ -8,51 +9,25 @@ using namespace MinimalUI;
 
 int UIElement::DEFAULT_HEIGHT = 36;
 
-UIElement::UIElement( UIController *aUIController, const std::string &aName, const std::string &aParamString )
-	: mParent( aUIController ), mName( aName ), mParams( ci::JsonTree( aParamString ) )
+UIElement::UIElement( UIController *aUIController, const std::string &aName, const Params &aParams )
+	: mParent( aUIController ), mName( aName ), mParams( aParams )
 {
-	// attach mouse callbacks
-	mCbMouseDown = mParent->getWindow()->getSignalMouseDown().connect( mParent->getDepth(), std::bind( &UIElement::mouseDown, this, std::placeholders::_1 ) );
-	mCbMouseUp = mParent->getWindow()->getSignalMouseUp().connect( mParent->getDepth(), std::bind( &UIElement::mouseUp, this, std::placeholders::_1 ) );
-	mCbMouseDrag = mParent->getWindow()->getSignalMouseDrag().connect( mParent->getDepth(), std::bind( &UIElement::mouseDrag, this, std::placeholders::_1 ) );
-
 	// initialize some variables
+	mId = mParent->getNumElements();
+	mSection = nullptr;
 	mActive = false;
+	mTouched = false;
 
 	// parse params that are common to all UIElements
 	mGroup = hasParam( "group" ) ? getParam<string>( "group" ) : "";
 	mIcon = hasParam( "icon" ) ? getParam<bool>( "icon" ) : false;
 	mLocked = hasParam( "locked" ) ? getParam<bool>( "locked" ) : false;
 	mClear = hasParam( "clear" ) ? getParam<bool>( "clear" ) : true;
+	mStatic = hasParam( "cached" ) ? getParam<bool>( "cached" ) : false;
+	mLayerDirty = false;
 
-	// JSON doesn't support hex literals...
-	// TODO: there's got to be a better way to do this, esp considering I need hex versions of default values set above...
-	std::stringstream str;
-	string strValue;
-	uint32_t hexValue;
-	if ( hasParam( "nameColor" ) )
-	{
-		strValue = getParam<string>( "nameColor" ); 
-		str << strValue;
-		str >> std::hex >> hexValue;
-		mNameColor = ColorA::hexA( hexValue );
-	}
-	else
-	{
-		mNameColor = UIController::DEFAULT_NAME_COLOR;
-	}
-	if ( hasParam( "backgroundColor" ) )
-	{
-		strValue = getParam<string>( "backgroundColor" ); 
-		str.clear();
-		str << strValue;
-		str >> std::hex >> hexValue;
-		mBackgroundColor = ColorA::hexA( hexValue );
-	}
-	else
-	{
-		mBackgroundColor = UIController::DEFAULT_BACKGROUND_COLOR;
-	}
+	mNameColor = getColorParam( "nameColor", UIController::DEFAULT_NAME_COLOR );
+	mBackgroundColor = getColorParam( "backgroundColor", UIController::DEFAULT_BACKGROUND_COLOR );
 
 	if ( hasParam( "justification" ) ) {
 		string justification = getParam<string>( "justification" );
@@ -67,26 +42,33 @@ UIElement::UIElement( UIController *aUIController, const std::string &aName, con
 		mAlignment = TextBox::CENTER;
 	}
 
+	// the font itself is looked up when the name is rendered, at the panel's current scale
 	if ( hasParam( "style" ) ) {
-		mFont = mParent->getFont( getParam<string>( "style" ) );
+		mFontStyle = getParam<string>( "style" );
 	} else if ( mIcon ) {
-		mFont = mParent->getFont( "icon" );
+		mFontStyle = "icon";
 	} else {
-		mFont = mParent->getFont( "label" );
+		mFontStyle = "label";
 	}
+	mNameTextureScale = 0.0f;
+	mNameTextureWanted = mNameTextureDirty = mNameTextureReleased = false;
 
 	if ( hasParam( "backgroundImage" ) ) {
-		mBackgroundTexture = gl::Texture( loadImage( loadAsset( getParam<string>( "backgroundImage" ) ) ) );
+		setBackgroundImage( PendingImage( getParam<string>( "backgroundImage" ) ) );
 	}
 }
 
 void UIElement::offsetInsertPosition()
 {
-	if ( mClear ) {
-		mParent->resetInsertPosition( mBounds.getHeight() + UIController::DEFAULT_MARGIN_SMALL );
-	} else {
-		mParent->offsetInsertPosition( Vec2i( mBounds.getWidth() + UIController::DEFAULT_MARGIN_SMALL, 0 ) );
+	mParent->advanceInsertPosition( mBounds.getSize(), mClear );
+}
+
+bool UIElement::isHidden() const
+{
+	for ( Section *section = mSection; section; section = section->getSection() ) {
+		if ( section->isCollapsed() ) return true;
 	}
+	return false;
 }
 
 void UIElement::setPositionAndBounds()
@@ -98,61 +80,125 @@ void UIElement::setPositionAndBounds()
 	offsetInsertPosition();
 }
 
-void UIElement::mouseDown( MouseEvent &event )
+bool UIElement::mouseDown( MouseEvent &event )
 {
-	if ( mParent->isVisible() && !mLocked && mBounds.contains( event.getPos() - mParent->getPosition() ) ) {
+	if ( mParent->isVisible() && !mLocked && !mTouched && mBounds.contains( event.getPos() - mParent->getPosition() ) ) {
 		mActive = true;
+		mParent->beginGesture( this );
 		handleMouseDown( event.getPos() - mParent->getPosition(), event.isRight() );
 		event.setHandled();
+		return true;
 	}
+	return false;
 }
 
 void UIElement::mouseUp( MouseEvent &event )
 {
-	if ( mParent->isVisible() && !mLocked && mActive ) {
+	if ( mParent->isVisible() && !mLocked && mActive && !mTouched ) {
 		mActive = false;
 		handleMouseUp( event.getPos() - mParent->getPosition() );
+		mParent->endGesture( this );
 		//		event.setHandled(); // maybe?
 	}
 }
 
 void UIElement::mouseDrag( MouseEvent &event )
 {
-	if ( mParent->isVisible() && !mLocked && mActive ) {
+	if ( mParent->isVisible() && !mLocked && mActive && !mTouched ) {
 		handleMouseDrag( event.getPos() - mParent->getPosition() );
 	}
 }
 
+void UIElement::touchBegan( const Vec2i &aPos )
+{
+	mActive = true;
+	mTouched = true;
+	mParent->beginGesture( this );
+	handleMouseDown( aPos, false );
+}
+
+void UIElement::touchMoved( const Vec2i &aPos )
+{
+	handleMouseDrag( aPos );
+}
+
+void UIElement::touchEnded( const Vec2i &aPos )
+{
+	mActive = false;
+	mTouched = false;
+	handleMouseUp( aPos );
+	mParent->endGesture( this );
+}
+
+void UIElement::notifyValueChanged( const int &aChannel, const float &aValue )
+{
+	mParent->valueChanged( this, aChannel, aValue );
+}
+
+void UIElement::setBackgroundImage( const PendingImage &aImage )
+{
+	mPendingBackground = aImage;
+	if ( mParent->isMaterialized() ) mBackgroundRegion = mPendingBackground.pack( *mParent->getTextureAtlas() );
+}
+
+void UIElement::materialize()
+{
+	if ( mPendingBackground ) mBackgroundRegion = mPendingBackground.pack( *mParent->getTextureAtlas() );
+	if ( mNameTextureWanted && !mNameTexture && !isHidden() ) renderNameTexture();
+}
+
+Vec2f UIElement::measureName()
+{
+	const float scale = mParent->getRenderScale();
+	TextBox textBox = TextBox().size( Vec2i( (int)( mSize.x * scale ), TextBox::GROW ) ).font( mParent->getFont( mFontStyle ) ).alignment( mAlignment ).text( mName );
+	return Vec2f( textBox.measure() ) / scale;
+}
+
 void UIElement::renderNameTexture()
 {
-	TextBox textBox = TextBox().size( Vec2i( mSize.x * 2 , TextBox::GROW ) ).font( mFont ).color( mNameColor ).alignment( mAlignment ).text( mName );
+	// a panel that has never been shown rasterizes its names when it is, and the model thread leaves it to drawLabel()
+	mNameTextureWanted = true;
+	mNameTextureReleased = false;
+	if ( !mParent->isMaterialized() ) return;
+	if ( mParent->onModelThread() ) {
+		mNameTextureDirty = true;
+		return;
+	}
+
+	// rasterize at the render scale, so the texture maps 1:1 to pixels
+	mNameTextureScale = mParent->getRenderScale();
+	TextBox textBox = TextBox().size( Vec2i( (int)( mSize.x * mNameTextureScale ), TextBox::GROW ) ).font( mParent->getFont( mFontStyle ) ).color( mNameColor ).alignment( mAlignment ).text( mName );
 	mNameTexture = textBox.render();
+	mNameTextureDirty = false;
 }
 
-void UIElement::drawBackground()
+void UIElement::releaseNameTexture()
 {
-	gl::pushMatrices();
-	gl::color( Color::white() );
-	
-	// draw the background texture if it's defined
-	if ( mBackgroundTexture ) gl::draw( mBackgroundTexture, getBounds() );
-	
-	gl::popMatrices();
+	if ( mParent->onModelThread() ) {
+		mNameTextureReleased = true;
+		mParent->deferNameTextureRelease();
+	} else {
+		mNameTexture.reset();
+	}
 }
 
 void UIElement::drawLabel()
 {
+	// not rendered yet, released while hidden, renamed on the model thread, or the window moved to a display with a
+	// different scale since
+	if ( !mNameTexture || mNameTextureDirty || mNameTextureScale != mParent->getRenderScale() ) renderNameTexture();
+
 	gl::pushMatrices();
 	gl::color( Color::white() );
 	
-	// lower right of the name texture
-	Vec2i texLR = toPixels( mNameTexture.getBounds().getLR() / 2 );
+	// lower right of the name texture, which is already in pixels
+	Vec2i texLR = mNameTexture.getBounds().getLR();
 	
 	// offset by the upper left of the bounds of the UIElement
 	Vec2i offset = getBounds().getUL();
 	
 	// vertically center the label
-	offset += Vec2i( 0, ( getBounds().getHeight() - toPixels( mNameTexture.getHeight() / 2 ) ) / 2 );
+	offset += Vec2i( 0, ( getBounds().getHeight() - mNameTexture.getHeight() ) / 2 );
 	
 	// draw the label
 	gl::draw( mNameTexture, Area( offset, offset + texLR ) );
@@ -0,0 +1,281 @@
+#include "UIManager.h"
+
+#include <algorithm>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+using namespace MinimalUI;
+
+UIManager::UIManager( WindowRef aWindow )
+	: mWindow( aWindow ), mCapture( nullptr )
+{
+	mFontScale = mWindow->getContentScale();
+	mTextureAtlas = TextureAtlas::create();
+
+	mCbMouseDown = mWindow->getSignalMouseDown().connect( std::bind( &UIManager::mouseDown, this, std::placeholders::_1 ) );
+	mCbMouseUp = mWindow->getSignalMouseUp().connect( std::bind( &UIManager::mouseUp, this, std::placeholders::_1 ) );
+	mCbMouseDrag = mWindow->getSignalMouseDrag().connect( std::bind( &UIManager::mouseDrag, this, std::placeholders::_1 ) );
+	mCbTouchesBegan = mWindow->getSignalTouchesBegan().connect( std::bind( &UIManager::touchesBegan, this, std::placeholders::_1 ) );
+	mCbTouchesMoved = mWindow->getSignalTouchesMoved().connect( std::bind( &UIManager::touchesMoved, this, std::placeholders::_1 ) );
+	mCbTouchesEnded = mWindow->getSignalTouchesEnded().connect( std::bind( &UIManager::touchesEnded, this, std::placeholders::_1 ) );
+	mCbDisplayChange = mWindow->getSignalDisplayChange().connect( std::bind( &UIManager::displayChanged, this ) );
+	for ( int i = 0; i < UIController::MAX_TOUCHES; i++ ) mTouches[i].mController = nullptr;
+
+	// set default fonts in points, shared by every panel
+	setFont( "label", Font( "Arial", 16 ) );
+	setFont( "smallLabel", Font( "Arial", 12 ) );
+	setFont( "icon", Font( "Arial", 22 ) );
+	setFont( "header", Font( "Arial", 48 ) );
+	setFont( "body", Font( "Arial", 19 ) );
+	setFont( "footer", Font( "Arial Italic", 14 ) );
+}
+
+UIManagerRef UIManager::create( WindowRef aWindow )
+{
+	return shared_ptr<UIManager>( new UIManager( aWindow ) );
+}
+
+UIControllerRef UIManager::addController( const string &aParamString )
+{
+	UIControllerRef controller( new UIController( mWindow, aParamString, this ) );
+	mControllers.push_back( controller );
+	sortControllers();
+	return controller;
+}
+
+void UIManager::removeController( const UIControllerRef &aController )
+{
+	if ( mCapture == aController.get() ) mCapture = nullptr;
+	for ( int i = 0; i < UIController::MAX_TOUCHES; i++ ) {
+		if ( mTouches[i].mController == aController.get() ) mTouches[i].mController = nullptr;
+	}
+	mControllers.erase( std::remove( mControllers.begin(), mControllers.end(), aController ), mControllers.end() );
+}
+
+void UIManager::sortControllers()
+{
+	std::stable_sort( mControllers.begin(), mControllers.end(), []( const UIControllerRef &a, const UIControllerRef &b ) {
+		return a->getBaseDepth() < b->getBaseDepth();
+	} );
+}
+
+void UIManager::mouseDown( MouseEvent &event )
+{
+	// the topmost visible panel under the mouse gets the event; panels below never see it
+	mCapture = nullptr;
+	for ( int i = (int)mControllers.size() - 1; i >= 0; i-- ) {
+		UIController *controller = mControllers[i].get();
+		if ( controller->isVisible() && controller->contains( event.getPos() ) ) {
+			mCapture = controller;
+			controller->mouseDown( event );
+			break;
+		}
+	}
+}
+
+void UIManager::mouseUp( MouseEvent &event )
+{
+	if ( mCapture ) {
+		mCapture->mouseUp( event );
+		mCapture = nullptr;
+	}
+}
+
+void UIManager::mouseDrag( MouseEvent &event )
+{
+	if ( mCapture ) {
+		mCapture->mouseDrag( event );
+	}
+}
+
+void UIManager::touchesBegan( TouchEvent &event )
+{
+	// like the mouse, each touch goes to the topmost visible panel under it, which keeps it until it ends
+	const vector<TouchEvent::Touch> &touches = event.getTouches();
+	TouchPoint batch[UIController::MAX_TOUCHES];
+	UIController *owners[UIController::MAX_TOUCHES];
+	for ( size_t first = 0; first < touches.size(); first += UIController::MAX_TOUCHES ) {
+		const size_t count = math<size_t>::min( touches.size() - first, (size_t)UIController::MAX_TOUCHES );
+		for ( size_t i = 0; i < count; i++ ) {
+			batch[i].mId = touches[first + i].getId();
+			batch[i].mPos = touches[first + i].getPos();
+			owners[i] = nullptr;
+			for ( int j = (int)mControllers.size() - 1; j >= 0; j-- ) {
+				UIController *controller = mControllers[j].get();
+				if ( controller->isVisible() && controller->contains( Vec2i( batch[i].mPos ) ) ) {
+					owners[i] = controller;
+					break;
+				}
+			}
+			if ( !owners[i] ) continue;
+			TouchCapture *capture = nullptr;
+			for ( int j = 0; j < UIController::MAX_TOUCHES && !capture; j++ ) {
+				if ( !mTouches[j].mController ) capture = &mTouches[j];
+			}
+			if ( capture ) {
+				capture->mId = batch[i].mId;
+				capture->mController = owners[i];
+			} else {
+				owners[i] = nullptr;
+			}
+		}
+		dispatchTouches( batch, owners, count, &UIController::touchesBegan );
+	}
+}
+
+void UIManager::touchesMoved( TouchEvent &event )
+{
+	routeTouches( event.getTouches(), false );
+}
+
+void UIManager::touchesEnded( TouchEvent &event )
+{
+	routeTouches( event.getTouches(), true );
+}
+
+void UIManager::routeTouches( const vector<TouchEvent::Touch> &aTouches, const bool &aEnded )
+{
+	// to the panels the touches began on
+	TouchPoint batch[UIController::MAX_TOUCHES];
+	UIController *owners[UIController::MAX_TOUCHES];
+	for ( size_t first = 0; first < aTouches.size(); first += UIController::MAX_TOUCHES ) {
+		const size_t count = math<size_t>::min( aTouches.size() - first, (size_t)UIController::MAX_TOUCHES );
+		for ( size_t i = 0; i < count; i++ ) {
+			batch[i].mId = aTouches[first + i].getId();
+			batch[i].mPos = aTouches[first + i].getPos();
+			owners[i] = nullptr;
+			for ( int j = 0; j < UIController::MAX_TOUCHES; j++ ) {
+				if ( mTouches[j].mController && mTouches[j].mId == batch[i].mId ) {
+					owners[i] = mTouches[j].mController;
+					if ( aEnded ) mTouches[j].mController = nullptr;
+					break;
+				}
+			}
+		}
+		const UIController::TouchHandler ended = &UIController::touchesEnded, moved = &UIController::touchesMoved;
+		dispatchTouches( batch, owners, count, aEnded ? ended : moved );
+	}
+}
+
+void UIManager::dispatchTouches( const TouchPoint *aTouches, UIController **aOwners, const size_t &aCount, UIController::TouchHandler aHandler )
+{
+	// gather each panel's touches, in order, and clear them from aOwners as they're sent
+	TouchPoint group[UIController::MAX_TOUCHES];
+	for ( size_t i = 0; i < aCount; i++ ) {
+		UIController *controller = aOwners[i];
+		if ( !controller ) continue;
+		size_t count = 0;
+		for ( size_t j = i; j < aCount; j++ ) {
+			if ( aOwners[j] == controller ) {
+				group[count++] = aTouches[j];
+				aOwners[j] = nullptr;
+			}
+		}
+		( controller->*aHandler )( group, count );
+	}
+}
+
+void UIManager::update()
+{
+	for ( unsigned int i = 0; i < mControllers.size(); i++ ) {
+		mControllers[i]->update();
+	}
+}
+
+void UIManager::draw()
+{
+	// save state once for every panel
+	gl::pushMatrices();
+	glPushAttrib( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_LINE_BIT | GL_CURRENT_BIT );
+	gl::disableDepthRead();
+
+	for ( unsigned int i = 0; i < mControllers.size(); i++ ) {
+		if ( mControllers[i]->isVisible() ) mControllers[i]->render();
+	}
+
+	// composite bottom to top, into whichever window is being drawn, so panels with mirrors can be drawn in each
+	gl::setViewport( toPixels( app::getWindow()->getBounds() ) );
+	gl::setMatricesWindow( toPixels( app::getWindow()->getSize() ) );
+	for ( unsigned int i = 0; i < mControllers.size(); i++ ) {
+		if ( mControllers[i]->isVisible() ) mControllers[i]->composite();
+	}
+
+	// restore state
+	glPopAttrib();
+	gl::popMatrices();
+}
+
+Font UIManager::getFont( const string &aStyle )
+{
+	// fonts are set in points, and rasterized at the window's content scale
+	map<string, Font>::const_iterator it = mScaledFonts.find( aStyle );
+	if ( it != mScaledFonts.end() ) {
+		return it->second;
+	}
+	it = mFonts.find( aStyle );
+	if ( it == mFonts.end() ) {
+		throw FontStyleExc( aStyle );
+	}
+	Font scaled( it->second.getName(), it->second.getSize() * mFontScale );
+	mScaledFonts[aStyle] = scaled;
+	return scaled;
+}
+
+void UIManager::displayChanged()
+{
+	float scale = mWindow->getContentScale();
+	if ( scale == mFontScale ) return;
+	mFontScale = scale;
+	mScaledFonts.clear();
+	for ( map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.begin(); it != mGlyphAtlases.end(); ++it ) {
+		it->second->setFont( getFont( it->first ) );
+	}
+}
+
+void UIManager::setFont( const string &aStyle, const Font &aFont )
+{
+	if ( aStyle != "label" && aStyle != "smallLabel" && aStyle != "icon" && aStyle != "header" && aStyle != "body" && aStyle != "footer" ) {
+		throw FontStyleExc( aStyle );
+	}
+	mFonts[aStyle] = aFont;
+	mScaledFonts.erase( aStyle );
+
+	// readouts and overlays draw through the style's glyph atlas
+	map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.find( aStyle );
+	if ( it != mGlyphAtlases.end() ) it->second->setFont( getFont( aStyle ) );
+
+	// every panel rasterizes its names again and redraws its cached layer
+	for ( unsigned int i = 0; i < mControllers.size(); i++ ) {
+		mControllers[i]->fontChanged();
+	}
+}
+
+gl::Texture UIManager::loadTexture( const string &aAssetPath )
+{
+	map<string, gl::Texture>::const_iterator it = mTextures.find( aAssetPath );
+	if ( it != mTextures.end() ) {
+		return it->second;
+	}
+	gl::Texture texture( loadImage( loadAsset( aAssetPath ) ) );
+	mTextures[aAssetPath] = texture;
+	return texture;
+}
+
+GlyphAtlasRef UIManager::getGlyphAtlas( const string &aStyle )
+{
+	map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.find( aStyle );
+	if ( it != mGlyphAtlases.end() ) {
+		return it->second;
+	}
+	GlyphAtlasRef atlas = GlyphAtlas::create( getFont( aStyle ) );
+	mGlyphAtlases[aStyle] = atlas;
+	return atlas;
+}
+
+void UIManager::flushGlyphAtlases()
+{
+	for ( map<string, GlyphAtlasRef>::const_iterator it = mGlyphAtlases.begin(); it != mGlyphAtlases.end(); ++it ) {
+		it->second->flush();
+	}
+}
@@ -0,0 +1,144 @@
+#include "UndoJournal.h"
+#include "VarInt.h"
+
+using namespace std;
+using namespace MinimalUI;
+
+size_t UndoJournal::DEFAULT_MEMORY_BUDGET = 4 << 20;
+size_t UndoJournal::DEFAULT_RING_SIZE = 4096;
+size_t UndoJournal::BLOCK_SIZE = 1024;
+
+UndoJournal::UndoJournal( const size_t &aMemoryBudget, const size_t &aRingSize )
+	: mBegin( 0 ), mCursor( 0 ), mEnd( 0 ), mCompressedBytes( 0 ), mMemoryBudget( aMemoryBudget )
+{
+	// the ring must be able to hold a decompressed block next to a full block of redo entries
+	size_t size = 2;
+	while ( size < aRingSize || size < BLOCK_SIZE * 2 ) size <<= 1;
+	mRing.resize( size );
+	mMask = size - 1;
+	mScratch.reserve( size );
+}
+
+UndoJournalRef UndoJournal::create( const size_t &aMemoryBudget, const size_t &aRingSize )
+{
+	return shared_ptr<UndoJournal>( new UndoJournal( aMemoryBudget, aRingSize ) );
+}
+
+void UndoJournal::clear()
+{
+	mBegin = mCursor = mEnd = 0;
+	mBlocks.clear();
+	mCompressedBytes = 0;
+}
+
+void UndoJournal::push( const Entry &aEntry )
+{
+	mEnd = mCursor;
+	if ( mEnd - mBegin == mRing.size() ) {
+		compressOldest();
+	}
+	at( mEnd++ ) = aEntry;
+	mCursor = mEnd;
+}
+
+bool UndoJournal::undo( const function<void( const Entry& )> &aApply )
+{
+	if ( mCursor == mBegin ) {
+		if ( mBlocks.empty() ) return false;
+		decompressNewest();
+	}
+
+	do {
+		mCursor--;
+		aApply( at( mCursor ) );
+	} while ( mCursor != mBegin && !at( mCursor ).mStepStart );
+	return true;
+}
+
+bool UndoJournal::redo( const function<void( const Entry& )> &aApply )
+{
+	if ( mCursor == mEnd )
+		return false;
+
+	do {
+		aApply( at( mCursor ) );
+		mCursor++;
+	} while ( mCursor != mEnd && !at( mCursor ).mStepStart );
+	return true;
+}
+
+// block format, per entry:
+//   varint  element id
+//   byte    channel, with the step start flag in the high bit
+//   varint  zigzag delta of the bits of mBefore against the previous entry's mAfter
+//   varint  zigzag delta of the bits of mAfter against mBefore
+void UndoJournal::compressOldest()
+{
+	// only whole steps are compressed, so that undo never has to split one across the ring and a block
+	uint64_t count = min<uint64_t>( BLOCK_SIZE, mEnd - mBegin );
+	while ( mBegin + count < mEnd && !at( mBegin + count ).mStepStart ) count++;
+
+	vector<uint8_t> block;
+	block.reserve( count * 4 );
+	uint32_t previous = 0;
+	for ( uint64_t i = mBegin; i < mBegin + count; i++ ) {
+		const Entry &entry = at( i );
+		uint32_t before = floatBits( entry.mBefore );
+		uint32_t after = floatBits( entry.mAfter );
+		writeVarint( block, entry.mElementId );
+		block.push_back( entry.mChannel | ( entry.mStepStart ? 0x80 : 0 ) );
+		writeVarint( block, zigzagEncode( (int32_t)( before - previous ) ) );
+		writeVarint( block, zigzagEncode( (int32_t)( after - before ) ) );
+		previous = after;
+	}
+	mBegin += count;
+
+	mCompressedBytes += block.size();
+	mBlocks.push_back( vector<uint8_t>() );
+	mBlocks.back().swap( block );
+
+	// forget the oldest history once we're over budget
+	while ( mCompressedBytes > mMemoryBudget && !mBlocks.empty() ) {
+		mCompressedBytes -= mBlocks.front().size();
+		mBlocks.pop_front();
+	}
+}
+
+void UndoJournal::decompressNewest()
+{
+	const vector<uint8_t> &block = mBlocks.back();
+	mScratch.clear();
+	size_t position = 0;
+	uint32_t previous = 0;
+	uint64_t elementId, before, after;
+	while ( position < block.size() ) {
+		Entry entry;
+		if ( !readVarint( block.data(), block.size(), position, elementId ) || position >= block.size() ) break;
+		uint8_t channel = block[position++];
+		if ( !readVarint( block.data(), block.size(), position, before ) || !readVarint( block.data(), block.size(), position, after ) ) break;
+		entry.mElementId = (uint32_t)elementId;
+		entry.mChannel = channel & 0x7F;
+		entry.mStepStart = ( channel & 0x80 ) != 0;
+		uint32_t beforeBits = previous + (uint32_t)zigzagDecode( (uint32_t)before );
+		uint32_t afterBits = beforeBits + (uint32_t)zigzagDecode( (uint32_t)after );
+		entry.mBefore = bitsFloat( beforeBits );
+		entry.mAfter = bitsFloat( afterBits );
+		previous = afterBits;
+		mScratch.push_back( entry );
+	}
+	mCompressedBytes -= block.size();
+	mBlocks.pop_back();
+
+	// make room in front of the ring, giving up the furthest redo steps if we have to
+	uint64_t free = mRing.size() - ( mEnd - mBegin );
+	if ( free < mScratch.size() ) {
+		uint64_t end = mEnd - ( mScratch.size() - free );
+		while ( end > mCursor && !at( end ).mStepStart ) end--;
+		mEnd = end;
+	}
+
+	mBegin -= mScratch.size();
+	for ( size_t i = 0; i < mScratch.size(); i++ ) {
+		at( mBegin + i ) = mScratch[i];
+	}
+}
@@ -0,0 +1,115 @@
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <algorithm>
+
+using namespace std;
+using namespace MinimalUI;
+
+WorkerPool::WorkerPool( const size_t &aNumThreads )
+	: mStopping( false )
+{
+	size_t numThreads = aNumThreads;
+	if ( numThreads == 0 ) {
+		unsigned int cores = thread::hardware_concurrency();
+		numThreads = cores > 1 ? cores - 1 : 1;
+	}
+	for ( size_t i = 0; i < numThreads; i++ ) {
+		mThreads.push_back( thread( &WorkerPool::run, this ) );
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mStopping = true;
+	}
+	mCondition.notify_all();
+	for ( unsigned int i = 0; i < mThreads.size(); i++ ) {
+		mThreads[i].join();
+	}
+}
+
+WorkerPoolRef WorkerPool::create( const size_t &aNumThreads )
+{
+	return shared_ptr<WorkerPool>( new WorkerPool( aNumThreads ) );
+}
+
+WorkerPool & WorkerPool::getShared()
+{
+	static WorkerPool pool( 0 );
+	return pool;
+}
+
+void WorkerPool::enqueue( const function<void()> &aTask )
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mTasks.push_back( aTask );
+	}
+	mCondition.notify_one();
+}
+
+void WorkerPool::run()
+{
+	while ( true ) {
+		function<void()> task;
+		{
+			unique_lock<mutex> lock( mMutex );
+			mCondition.wait( lock, [this] { return mStopping || !mTasks.empty(); } );
+			if ( mTasks.empty() ) return;
+			task = move( mTasks.front() );
+			mTasks.pop_front();
+		}
+		task();
+	}
+}
+
+void WorkerPool::parallelFor( const size_t &aCount, const function<void( size_t, size_t )> &aTask, const size_t &aMinChunk )
+{
+	if ( aCount == 0 ) return;
+
+	// a few chunks per thread, so an uneven chunk doesn't leave the others idle
+	size_t numChunks = min( ( mThreads.size() + 1 ) * 4, ( aCount + aMinChunk - 1 ) / max<size_t>( aMinChunk, 1 ) );
+	if ( numChunks <= 1 ) {
+		aTask( 0, aCount );
+		return;
+	}
+	const size_t chunkSize = ( aCount + numChunks - 1 ) / numChunks;
+	numChunks = ( aCount + chunkSize - 1 ) / chunkSize;
+
+	// chunks are claimed from a shared counter, by the workers and by this thread
+	struct Job {
+		atomic<size_t> mNext;
+		atomic<size_t> mDone;
+		mutex mMutex;
+		condition_variable mCondition;
+	};
+	shared_ptr<Job> job( new Job );
+	job->mNext = 0;
+	job->mDone = 0;
+
+	auto work = [job, aCount, chunkSize, numChunks, &aTask] {
+		size_t chunk;
+		while ( ( chunk = job->mNext.fetch_add( 1 ) ) < numChunks ) {
+			size_t begin = chunk * chunkSize;
+			aTask( begin, min( begin + chunkSize, aCount ) );
+			if ( job->mDone.fetch_add( 1 ) + 1 == numChunks ) {
+				lock_guard<mutex> lock( job->mMutex );
+				job->mCondition.notify_all();
+			}
+		}
+	};
+
+	const size_t numHelpers = min( mThreads.size(), numChunks - 1 );
+	for ( size_t i = 0; i < numHelpers; i++ ) {
+		enqueue( work );
+	}
+	work();
+
+	// this thread claims chunks too, so the job finishes even if every worker is busy with something else; helpers
+	// that start late find nothing left to claim
+	unique_lock<mutex> lock( job->mMutex );
+	job->mCondition.wait( lock, [&job, numChunks] { return job->mDone.load() >= numChunks; } );
+}
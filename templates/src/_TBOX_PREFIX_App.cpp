@@ -75,25 +75,25 @@ void _TBOX_PREFIX_App::setup()
     mParams->addSlider( "Zoom", &mZoom );
     
     // 2D Sliders
-    mParams->addSlider2D( "XY", &mXYSize, "{ \"minX\":-2.0, \"maxX\":2.0, \"minY\":-2.0, \"maxY\":2.0 }" );
+    mParams->addSlider2D( "XY", &mXYSize, MinimalUI::Slider2DParams().minX( -2.0 ).maxX( 2.0 ).minY( -2.0 ).maxY( 2.0 ) );
     
     // Simple Button
-    mParams->addButton( "Stateless!", std::bind( &_TBOX_PREFIX_App::buttonCallback, this, std::placeholders::_1 ), "{ \"width\":96, \"clear\":false }" );
-    mParams->addButton( "Stateful!", std::bind( &_TBOX_PREFIX_App::buttonCallback, this, std::placeholders::_1 ), "{ \"width\":96, \"stateless\":false }" );
+    mParams->addButton( "Stateless!", std::bind( &_TBOX_PREFIX_App::buttonCallback, this, std::placeholders::_1 ), MinimalUI::ButtonParams().width( 96 ).clear( false ) );
+    mParams->addButton( "Stateful!", std::bind( &_TBOX_PREFIX_App::buttonCallback, this, std::placeholders::_1 ), MinimalUI::ButtonParams().width( 96 ).stateless( false ) );
     
     // Separator
     mParams->addSeparator();
     
     // Label
-    mParams->addLabel( "Count", "{ \"clear\":false }" );
+    mParams->addLabel( "Count", MinimalUI::LabelParams().clear( false ) );
     
     // Button Group
-    mParams->addButton( "1", std::bind( &_TBOX_PREFIX_App::setCount, this, 1, std::placeholders::_1 ), "{ \"clear\":false, \"stateless\":false, \"group\":\"count\", \"exclusive\":true, \"pressed\":true }" );
-    mParams->addButton( "2", std::bind( &_TBOX_PREFIX_App::setCount, this, 2, std::placeholders::_1 ), "{ \"clear\":false, \"stateless\":false, \"group\":\"count\", \"exclusive\":true }" );
-    mParams->addButton( "3", std::bind( &_TBOX_PREFIX_App::setCount, this, 3, std::placeholders::_1 ), "{ \"stateless\":false, \"group\":\"count\", \"exclusive\":true }" );
+    mParams->addButton( "1", std::bind( &_TBOX_PREFIX_App::setCount, this, 1, std::placeholders::_1 ), MinimalUI::ButtonParams().clear( false ).stateless( false ).group( "count" ).exclusive( true ).pressed( true ) );
+    mParams->addButton( "2", std::bind( &_TBOX_PREFIX_App::setCount, this, 2, std::placeholders::_1 ), MinimalUI::ButtonParams().clear( false ).stateless( false ).group( "count" ).exclusive( true ) );
+    mParams->addButton( "3", std::bind( &_TBOX_PREFIX_App::setCount, this, 3, std::placeholders::_1 ), MinimalUI::ButtonParams().stateless( false ).group( "count" ).exclusive( true ) );
     
     // Toggle Slider
-    mParams->addToggleSlider( "Z Position", &mZPosition, "A", std::bind(&_TBOX_PREFIX_App::lockZ, this, std::placeholders::_1 ), "{ \"width\":156, \"clear\":false, \"min\": -1, \"max\": 1 }", "{ \"stateless\":false }" );
+    mParams->addToggleSlider( "Z Position", &mZPosition, "A", std::bind(&_TBOX_PREFIX_App::lockZ, this, std::placeholders::_1 ), MinimalUI::SliderParams().width( 156 ).clear( false ).min( -1 ).max( 1 ), MinimalUI::ButtonParams().stateless( false ) );
 }
 
 void _TBOX_PREFIX_App::update()